@@ -0,0 +1,110 @@
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+namespace {
+    struct EventConfig {
+        std::uint32_t Type;
+        std::uint64_t Config;
+    };
+
+    constexpr std::uint64_t CacheEvent(const std::uint64_t cache, const std::uint64_t op, const std::uint64_t result) {
+        return cache | op << 8 | result << 16;
+    }
+
+    constexpr std::array<EventConfig, PerfCounters::Count> Configs{{
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HW_CACHE, CacheEvent(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                                        PERF_COUNT_HW_CACHE_RESULT_MISS)},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    }};
+
+    int Open(const EventConfig &event, const int group) {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = event.Type;
+        attr.config = event.Config;
+        attr.disabled = group < 0; // members follow the leader
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+    }
+}
+
+PerfCounters::PerfCounters() {
+    m_fds.fill(-1);
+    int firstError = 0;
+    for (std::size_t event = 0; event < Count; ++event) {
+        m_fds[event] = Open(Configs[event], m_leader);
+        if (m_fds[event] < 0) {
+            firstError = firstError ? firstError : errno;
+            continue;
+        }
+        if (m_leader < 0)
+            m_leader = m_fds[event];
+        m_slot[event] = m_opened++;
+        m_status += m_status.empty() ? Names[event] : std::string(", ") + Names[event];
+    }
+    if (m_leader < 0)
+        m_status = std::string("unavailable (") + std::strerror(firstError) + ")";
+}
+
+PerfCounters::~PerfCounters() {
+    for (const int fd : m_fds)
+        if (fd >= 0)
+            close(fd);
+}
+
+void PerfCounters::Start() noexcept {
+    if (m_leader < 0)
+        return;
+    ioctl(m_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+PerfCounters::Values PerfCounters::Stop() noexcept {
+    Values values{};
+    if (m_leader < 0)
+        return values;
+    ioctl(m_leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // PERF_FORMAT_GROUP: count, time enabled, time running, then one value per member.
+    std::array<std::uint64_t, 3 + Count> buffer{};
+    if (read(m_leader, buffer.data(), sizeof(buffer)) < static_cast<ssize_t>((3 + m_opened) * sizeof(std::uint64_t)))
+        return values;
+    const std::uint64_t enabled = buffer[1], running = buffer[2];
+    for (std::size_t event = 0; event < Count; ++event) {
+        if (m_fds[event] < 0)
+            continue;
+        const std::uint64_t count = buffer[3 + m_slot[event]];
+        values[event] = running && running < enabled
+                            ? static_cast<std::uint64_t>(static_cast<double>(count) * enabled / running)
+                            : count;
+    }
+    return values;
+}
+#else
+PerfCounters::PerfCounters() : m_status("unavailable (perf_event_open is Linux-only)") {
+    m_fds.fill(-1);
+}
+
+PerfCounters::~PerfCounters() = default;
+
+void PerfCounters::Start() noexcept {
+}
+
+PerfCounters::Values PerfCounters::Stop() noexcept {
+    return {};
+}
+#endif
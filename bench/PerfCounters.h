@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// Hardware counters around a region of code, read through Linux perf_event_open: user-space
+/// cycles, instructions, L1D read misses, last-level cache misses and branch misses, opened as
+/// one group so they count exactly the same instructions.
+///
+/// Degrades instead of failing: an event the CPU or the kernel does not offer (a VM, a
+/// container without perf access, perf_event_paranoid > 2, another OS) is left out, and with
+/// none at all Available() is false and Start/Stop do nothing.
+class PerfCounters {
+public:
+    enum Event : std::size_t { Cycles, Instructions, L1DMisses, LLCMisses, BranchMisses, Count };
+
+    /// Counter names as reported by the benchmarks (suffixed with _per_node).
+    static constexpr std::array<const char *, Count> Names{
+        "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses",
+    };
+
+    using Values = std::array<std::uint64_t, Count>;
+
+    PerfCounters();
+
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    [[nodiscard]] bool Available() const noexcept { return m_leader >= 0; }
+
+    [[nodiscard]] bool Has(const Event event) const noexcept { return m_fds[event] >= 0; }
+
+    /// The events that opened, or why none did.
+    [[nodiscard]] const std::string &Status() const noexcept { return m_status; }
+
+    /// Zero and start the counters.
+    void Start() noexcept;
+
+    /// Stop the counters and return what they counted since Start (scaled up if the kernel
+    /// multiplexed the group); zero for the events that are not available.
+    [[nodiscard]] Values Stop() noexcept;
+
+private:
+    std::array<int, Count> m_fds{};
+    std::array<std::size_t, Count> m_slot{}; ///< position of each event in the group read
+    std::size_t m_opened = 0;
+    int m_leader = -1;
+    std::string m_status;
+};
@@ -0,0 +1,309 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <masharifcore/Masharif.h>
+
+#include "PerfCounters.h"
+
+using namespace masharif;
+
+// Layout benchmarks by tree shape. Every family times Node::Calculate alone (manual time:
+// building or editing the tree for a frame is not measured) and reports per family
+//   ns_per_node             Calculate time over the nodes in the tree
+//   strategy_runs_per_node  layout strategy runs over the nodes in the tree
+//   allocations_per_frame   operator new calls made by Calculate (zero for the incremental
+//                           families once warm; tests/AllocationTests.cpp enforces it)
+// and, where perf_event_open offers them, hardware counters over the same Calculate calls:
+//   cycles_per_node, instructions_per_node, l1d_misses_per_node, llc_misses_per_node,
+//   branch_misses_per_node
+// The perf_events context line says which counters were available.
+// Run with --benchmark_format=json (or --benchmark_out=<file>) for machine-readable output.
+
+namespace {
+    std::atomic<std::uint64_t> g_allocations{0};
+}
+
+void *operator new(const std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *memory = std::malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+namespace {
+    std::uint64_t totalStrategyRuns(Node &node) {
+        std::uint64_t sum = node.GetLayout().StrategyRuns;
+        for (const auto &child : node.Children())
+            sum += totalStrategyRuns(*child);
+        return sum;
+    }
+
+    struct Tree {
+        SharedNode Root;
+        SharedNode Leaf; ///< a deep leaf, for the edit families
+        std::size_t Nodes = 0;
+    };
+
+    /// One frame to time: Calculate(Width, Height) on the tree's root.
+    struct Frame {
+        Tree *Target;
+        float Width = 1000.0f;
+        float Height = 1000.0f;
+    };
+
+    /// Time one Calculate per iteration on the frame `next()` prepares.
+    template<typename Next>
+    void runFrames(benchmark::State &state, Next next) {
+        std::uint64_t nodes = 0, runs = 0, allocations = 0;
+        double nanoseconds = 0;
+        PerfCounters perf;
+        PerfCounters::Values events{};
+        for (auto _ : state) {
+            const Frame frame = next();
+            Node &root = *frame.Target->Root;
+            const std::uint64_t runsBefore = totalStrategyRuns(root);
+            const std::uint64_t allocationsBefore = g_allocations.load(std::memory_order_relaxed);
+            perf.Start();
+            const auto start = std::chrono::steady_clock::now();
+            root.Calculate(frame.Width, frame.Height);
+            const auto end = std::chrono::steady_clock::now();
+            const PerfCounters::Values counted = perf.Stop();
+            allocations += g_allocations.load(std::memory_order_relaxed) - allocationsBefore;
+            for (std::size_t event = 0; event < PerfCounters::Count; ++event)
+                events[event] += counted[event];
+
+            const double seconds = std::chrono::duration<double>(end - start).count();
+            state.SetIterationTime(seconds);
+            nanoseconds += seconds * 1e9;
+            runs += totalStrategyRuns(root) - runsBefore;
+            nodes += frame.Target->Nodes;
+        }
+        if (nodes == 0)
+            return;
+        state.counters["ns_per_node"] = nanoseconds / static_cast<double>(nodes);
+        state.counters["strategy_runs_per_node"] = static_cast<double>(runs) / static_cast<double>(nodes);
+        state.counters["allocations_per_frame"] =
+                static_cast<double>(allocations) / static_cast<double>(state.iterations());
+        for (std::size_t event = 0; event < PerfCounters::Count; ++event) {
+            if (perf.Has(static_cast<PerfCounters::Event>(event)))
+                state.counters[std::string(PerfCounters::Names[event]) + "_per_node"] =
+                        static_cast<double>(events[event]) / static_cast<double>(nodes);
+        }
+    }
+
+    SharedNode flexBox(const FlexDirection direction) {
+        auto node = std::make_shared<Node>(OuterDisplay::Flex);
+        node->GetStyle().Modify<CSSFlex>().Direction = direction;
+        return node;
+    }
+
+    SharedNode fixedLeaf(const float width, const float height) {
+        auto leaf = std::make_shared<Node>(OuterDisplay::Flex);
+        leaf->GetStyle().Modify<Dimensions>().Width = width;
+        leaf->GetStyle().Modify<Dimensions>().Height = height;
+        return leaf;
+    }
+
+    void addLevels(Tree &tree, Node &parent, const int width, const int depth, const int level) {
+        for (int i = 0; i < width; ++i) {
+            SharedNode child = level + 1 == depth
+                                   ? fixedLeaf(8.0f, 8.0f)
+                                   : flexBox(level % 2 ? FlexDirection::Column : FlexDirection::Row);
+            parent.AddChild(child);
+            ++tree.Nodes;
+            if (level + 1 < depth)
+                addLevels(tree, *child, width, depth, level + 1);
+            else
+                tree.Leaf = child;
+        }
+    }
+
+    /// `depth` levels of flex boxes alternating direction, `width` children each.
+    Tree wideDeep(const int width, const int depth) {
+        Tree tree{flexBox(FlexDirection::Column), nullptr, 1};
+        tree.Root->GetStyle().Modify<Dimensions>().Width = 1000.0f;
+        addLevels(tree, *tree.Root, width, depth, 0);
+        return tree;
+    }
+
+    /// A column of `rows` flex rows holding `items` fixed items each, wrapping or not.
+    Tree flexRows(const int rows, const int items, const bool wrap) {
+        Tree tree{flexBox(FlexDirection::Column), nullptr, 1};
+        tree.Root->GetStyle().Modify<Dimensions>().Width = 1000.0f;
+        for (int i = 0; i < rows; ++i) {
+            auto row = flexBox(FlexDirection::Row);
+            row->GetStyle().Modify<CSSFlex>().Wrap = wrap ? FlexWrap::Wrap : FlexWrap::NoWrap;
+            for (int j = 0; j < items; ++j) {
+                tree.Leaf = fixedLeaf(10.0f, 10.0f);
+                row->AddChild(tree.Leaf);
+            }
+            tree.Root->AddChild(row);
+            tree.Nodes += 1 + items;
+        }
+        return tree;
+    }
+
+    /// Nested AUTO-sized flex-grow boxes: every level re-distributes its definite size.
+    Tree growChain(const int depth) {
+        Tree tree{flexBox(FlexDirection::Column), nullptr, 1};
+        tree.Root->GetStyle().Modify<Dimensions>().Width = 1000.0f;
+        tree.Root->GetStyle().Modify<Dimensions>().Height = 1000.0f;
+        Node *cursor = tree.Root.get();
+        for (int i = 0; i < depth; ++i) {
+            tree.Leaf = fixedLeaf(50.0f, 10.0f);
+            cursor->AddChild(tree.Leaf);
+            auto next = flexBox(i % 2 ? FlexDirection::Row : FlexDirection::Column);
+            next->GetStyle().Modify<CSSFlex>().FlexGrow = 1.0f;
+            cursor->AddChild(next);
+            cursor = next.get();
+            tree.Nodes += 2;
+        }
+        return tree;
+    }
+
+    /// A positioned root with `count` absolutely positioned children spread by their insets.
+    Tree absoluteHeavy(const int count) {
+        Tree tree{std::make_shared<Node>(), nullptr, 1};
+        tree.Root->GetStyle().Modify<Dimensions>().Width = 1000.0f;
+        tree.Root->GetStyle().Modify<Dimensions>().Height = 1000.0f;
+        tree.Root->GetStyle().Modify<Dimensions>().Position = PositionType::Relative;
+        for (int i = 0; i < count; ++i) {
+            auto badge = std::make_shared<Node>();
+            badge->GetStyle().Modify<Dimensions>().Position = PositionType::Absolute;
+            badge->GetStyle().Modify<Dimensions>().Width = 16.0f;
+            badge->GetStyle().Modify<Dimensions>().Height = 16.0f;
+            badge->GetStyle().ModifyInsets().Left = static_cast<float>(i % 60 * 16);
+            badge->GetStyle().ModifyInsets().Top = static_cast<float>(i / 60 % 60 * 16);
+            tree.Root->AddChild(badge);
+            tree.Leaf = badge;
+        }
+        tree.Nodes += count;
+        return tree;
+    }
+
+    /// Normal flow: `sections` blocks of ten padded paragraph blocks each.
+    Tree document(const int sections) {
+        Tree tree{std::make_shared<Node>(), nullptr, 1};
+        tree.Root->GetStyle().Modify<Dimensions>().Width = 1000.0f;
+        for (int i = 0; i < sections; ++i) {
+            auto section = std::make_shared<Node>();
+            section->GetStyle().Modify<PaddingEdge>().Top = 8.0f;
+            section->GetStyle().Modify<MarginEdge>().Bottom = 16.0f;
+            for (int j = 0; j < 10; ++j) {
+                tree.Leaf = std::make_shared<Node>();
+                tree.Leaf->GetStyle().Modify<Dimensions>().Height = 18.0f;
+                tree.Leaf->GetStyle().Modify<MarginEdge>().Bottom = 4.0f;
+                section->AddChild(tree.Leaf);
+            }
+            tree.Root->AddChild(section);
+            tree.Nodes += 11;
+        }
+        return tree;
+    }
+
+    // Initial solves of fresh trees.
+
+    void BM_WideDeep(benchmark::State &state) {
+        Tree tree;
+        runFrames(state, [&] {
+            tree = wideDeep(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+            return Frame{&tree};
+        });
+    }
+
+    void BM_FlexWrap(benchmark::State &state) {
+        Tree tree;
+        runFrames(state, [&] {
+            tree = flexRows(static_cast<int>(state.range(1)) / 100, 100, state.range(0) != 0);
+            return Frame{&tree};
+        });
+    }
+
+    void BM_GrowChain(benchmark::State &state) {
+        Tree tree;
+        runFrames(state, [&] {
+            tree = growChain(static_cast<int>(state.range(0)));
+            return Frame{&tree};
+        });
+    }
+
+    void BM_AbsoluteHeavy(benchmark::State &state) {
+        Tree tree;
+        runFrames(state, [&] {
+            tree = absoluteHeavy(static_cast<int>(state.range(0)));
+            return Frame{&tree};
+        });
+    }
+
+    void BM_NormalFlowDocument(benchmark::State &state) {
+        Tree tree;
+        runFrames(state, [&] {
+            tree = document(static_cast<int>(state.range(0)));
+            return Frame{&tree};
+        });
+    }
+
+    // Incremental frames on one solved tree.
+
+    void BM_IdleFrame(benchmark::State &state) {
+        Tree tree = flexRows(static_cast<int>(state.range(0)), 100, true);
+        tree.Root->Calculate(1000.0f, 1000.0f);
+        runFrames(state, [&] { return Frame{&tree}; });
+    }
+
+    void BM_SingleLeafEdit(benchmark::State &state) {
+        Tree tree = growChain(static_cast<int>(state.range(0)));
+        tree.Root->Calculate(1000.0f, 1000.0f);
+        bool wide = false;
+        runFrames(state, [&] {
+            wide = !wide;
+            tree.Leaf->GetStyle().Modify<Dimensions>().Width = wide ? 60.0f : 50.0f;
+            return Frame{&tree};
+        });
+    }
+
+    void BM_ResizeSweep(benchmark::State &state) {
+        Tree tree = flexRows(static_cast<int>(state.range(0)), 100, true);
+        tree.Root->GetStyle().Modify<Dimensions>().Width = CSSValue(NAN, CSSUnit::Auto);
+        tree.Root->Calculate(1000.0f, 1000.0f);
+        int step = 0;
+        runFrames(state, [&] {
+            step = (step + 1) % 40;
+            return Frame{&tree, 600.0f + 10.0f * static_cast<float>(step)};
+        });
+    }
+}
+
+BENCHMARK(BM_WideDeep)->ArgNames({"width", "depth"})
+        ->Args({2, 10})->Args({8, 4})->Args({32, 2})->Args({100, 2})->UseManualTime();
+BENCHMARK(BM_FlexWrap)->ArgNames({"wrap", "items"})
+        ->Args({0, 1000})->Args({1, 1000})->Args({0, 10000})->Args({1, 10000})->UseManualTime();
+BENCHMARK(BM_GrowChain)->ArgName("depth")->Arg(10)->Arg(20)->Arg(40)->UseManualTime();
+BENCHMARK(BM_AbsoluteHeavy)->ArgName("count")->Arg(1000)->Arg(10000)->UseManualTime();
+BENCHMARK(BM_NormalFlowDocument)->ArgName("sections")->Arg(100)->Arg(1000)->UseManualTime();
+BENCHMARK(BM_IdleFrame)->ArgName("rows")->Arg(10)->Arg(100)->UseManualTime();
+BENCHMARK(BM_SingleLeafEdit)->ArgName("depth")->Arg(20)->Arg(40)->UseManualTime();
+BENCHMARK(BM_ResizeSweep)->ArgName("rows")->Arg(10)->Arg(100)->UseManualTime();
+
+int main(int argc, char **argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::AddCustomContext("perf_events", PerfCounters().Status());
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -3,6 +3,14 @@
 #include "macros.h"
 #include "layout/Node.h"
 #include "layout/Layout.h"
+#include "layout/LayoutExport.h"
+#include "layout/LayoutProfile.h"
+#include "layout/LayoutStats.h"
+#include "layout/LayoutTrace.h"
+#include "layout/MutationTrace.h"
+#include "layout/Snapshot.h"
+#include "layout/TreeBuilder.h"
 #include "structure/CSSValue.h"
 #include "structure/Style.h"
 #include "structure/BoxInfo.h"
+#include "structure/Grid.h"
@@ -10,6 +10,7 @@
 #include <cstddef>
 #include <limits>
 #include <ranges>
+#include <utility>
 
 using namespace masharif;
 
@@ -19,12 +20,26 @@ namespace {
             return margin.Left.ResolveValue(mainAxisSize) + margin.Right.ResolveValue(mainAxisSize);
         return margin.Top.ResolveValue(mainAxisSize) + margin.Bottom.ResolveValue(mainAxisSize);
     }
+
+    bool HasAutoMainMargin(const bool isRow, const MarginEdge &margin) {
+        return isRow
+                   ? margin.Left.Unit == CSSUnit::Auto || margin.Right.Unit == CSSUnit::Auto
+                   : margin.Top.Unit == CSSUnit::Auto || margin.Bottom.Unit == CSSUnit::Auto;
+    }
+
+    /// NaN (AUTO) compares equal to NaN, matching Node's space memo.
+    bool SameSpace(const float a, const float b) {
+        return (std::isnan(a) && std::isnan(b)) || a == b;
+    }
 }
 
 /// One flex solve for one container. Phases run in CSS order; the recursive phases
 /// (MeasureItemBases, RelayoutItemsAtDefiniteSize) re-enter child solves that share the
 /// same context arenas, so they follow the ArenaSlice re-indexing rule strictly.
 class FlexLayoutStrategy::Solver {
+    using FlexItemMemo = Node::FlexItemMemo;
+    using FlexLineMemo = Node::FlexLineMemo;
+
 public:
     Solver(Node &container, LayoutContext &ctx,
            const float availableWidth, const float availableHeight)
@@ -37,13 +52,23 @@ public:
           m_AvailableWidth(availableWidth),
           m_AvailableHeight(availableHeight),
           m_Items(ctx.InFlowItems),
-          m_Lines(ctx.Lines) {
+          m_Lines(ctx.Lines),
+          m_Memo(container.m_flexMemo),
+          m_InputWidth(availableWidth),
+          m_InputHeight(availableHeight),
+          m_EntryWidth(m_Layout.ComputedWidth),
+          m_EntryHeight(m_Layout.ComputedHeight) {
     }
 
     void Run() {
+        // The phases rewrite the memo item by item; until RecordLineMemo it describes no run
+        // (a time-sliced solve may stop in any child call in between, and the run returns).
+        m_Memo.Run = 0;
         CollectAndOrderItems();
         ShrinkAvailableToContentBox();
         MeasureItemBases();
+        if (m_Ctx.Yielded)
+            return;
         ResolveContainerSize();
 
         const float availableMainAxisSize = m_IsRow ? m_AvailableWidth : m_AvailableHeight;
@@ -73,6 +98,116 @@ public:
 
         AlignLinesOnCrossAxis();
         RelayoutItemsAtDefiniteSize();
+        if (m_Ctx.Yielded)
+            return;
+        RecordLineMemo(availableSpace);
+    }
+
+    /// Translate-only fast path. When the memo describes the previous run of this container at
+    /// the same inputs, that run produced a single inflexible flex-start line, and exactly one
+    /// child changed, re-measure just that item: if the line stays inflexible and its natural
+    /// cross size holds, every other item keeps its size and only its successors move along
+    /// the main axis by the change in the item's outer size. Returns false (having laid out
+    /// nothing the full solve would not redo identically) when any of that does not hold, or
+    /// when a time-sliced solve stopped in the item.
+    [[nodiscard]] bool TryTranslateOnly() {
+        MASHARIF_LAYOUT_PHASE(m_Ctx, LayoutPhase::FlexTranslateOnly);
+        if (!m_Memo.Eligible || m_Memo.Run != m_Layout.StrategyRuns || m_Style.Dirty) return false;
+        if (!SameSpace(m_Memo.AvailW, m_AvailableWidth) || !SameSpace(m_Memo.AvailH, m_AvailableHeight) ||
+            !SameSpace(m_Memo.EntryW, m_EntryWidth) || !SameSpace(m_Memo.EntryH, m_EntryHeight) ||
+            m_Memo.MainDefinite != m_Container.MainSizeIsDefinite() ||
+            m_Memo.CrossDefinite != m_Container.CrossSizeIsDefinite())
+            return false;
+
+        const auto &children = m_Container.m_Children;
+        const std::size_t k = m_Container.m_changedBegin;
+        if (m_Memo.Items.size() != children.size() || m_Container.m_changedEnd != k + 1) return false;
+
+        FlexItemMemo &memo = m_Memo.Items[k];
+        Node *child = children[k].get();
+        const auto &childStyle = child->GetStyle();
+        const auto &dim = childStyle.GetDimensions();
+        if (!memo.InFlow || dim.Display == OuterDisplay::None ||
+            IsOutOfFlow(dim.Position) ||
+            childStyle.GetFlex().Order != 0 || HasAutoMainMargin(m_IsRow, childStyle.GetMargin()))
+            return false;
+
+        // Re-measure against the space the bases were measured in, then check the line against
+        // the space it was resolved in — exactly what the full solve's phases would see.
+        const float previousCross = memo.Cross;
+        m_Memo.Run = 0; // rewritten below; see Run()
+        m_AvailableWidth = m_Memo.MeasureAvailW;
+        m_AvailableHeight = m_Memo.MeasureAvailH;
+        MeasureItemBasis(child);
+        if (m_Ctx.Yielded)
+            return false;
+        m_AvailableWidth = m_Memo.ResolvedAvailW;
+        m_AvailableHeight = m_Memo.ResolvedAvailH;
+
+        auto &childLayout = child->GetLayout();
+        const float basis = childLayout.ComputedFlexBasis;
+        const float cross = m_IsRow ? childLayout.ComputedHeight : childLayout.ComputedWidth;
+        if (std::isnan(cross) || cross > m_Memo.MaxCross ||
+            (previousCross == m_Memo.MaxCross && cross != previousCross))
+            return false; // the line's natural cross size may change: every item re-aligns
+
+        const CSSFlex &childFlex = childStyle.GetFlex();
+        const auto &margin = childStyle.GetMargin();
+        const float lineMainSize = m_IsRow ? m_AvailableWidth : m_AvailableHeight;
+        const float taken = basis + NeededMainAxisMargin(m_IsRow, margin, lineMainSize);
+        const float takenSize = m_Memo.TakenSize - memo.Taken + taken;
+        const float totalGrow = m_Memo.TotalGrow - memo.Grow + childFlex.FlexGrow;
+        const float totalShrink = m_Memo.TotalShrinkScaled - memo.ShrinkScaled + childFlex.FlexShrink * basis;
+        const float remainingSpace = m_Memo.AvailableSpace - takenSize;
+        if ((remainingSpace > 0 && totalGrow > 0) || (remainingSpace < 0 && totalShrink != 0))
+            return false; // the line now flexes: sizes are redistributed across every item
+
+        const float mainSize = ClampMainSize(child, basis);
+        const float marginStart = m_IsRow
+                                      ? margin.Left.ResolveValue(m_AvailableWidth)
+                                      : margin.Top.ResolveValue(m_AvailableHeight);
+        const float marginEnd = m_IsRow
+                                    ? margin.Right.ResolveValue(m_AvailableWidth)
+                                    : margin.Bottom.ResolveValue(m_AvailableHeight);
+        const float outer = marginStart + mainSize + marginEnd;
+        const float delta = outer - memo.Outer;
+
+        childLayout.ComputedFlexBasis = mainSize;
+        if (m_IsRow) {
+            childLayout.LocalX = memo.MainPos + marginStart;
+            childLayout.ComputedWidth = mainSize;
+        } else {
+            childLayout.LocalY = memo.MainPos + marginStart;
+            childLayout.ComputedHeight = mainSize;
+        }
+        AlignItemOnCrossAxis(child, m_Memo.LineCrossStart, m_Memo.LineCrossSize);
+        child->LayoutContentsWithDefiniteSize(m_Ctx, childLayout.ComputedWidth, childLayout.ComputedHeight);
+        if (m_Ctx.Yielded)
+            return false;
+
+        if (delta != 0) {
+            for (std::size_t i = k + 1; i < children.size(); ++i) {
+                FlexItemMemo &next = m_Memo.Items[i];
+                if (!next.InFlow) continue;
+                next.MainPos += delta;
+                auto &nextLayout = children[i]->GetLayout();
+                (m_IsRow ? nextLayout.LocalX : nextLayout.LocalY) += delta;
+            }
+        }
+
+        memo.Outer = outer;
+        memo.Taken = taken;
+        memo.Grow = childFlex.FlexGrow;
+        memo.ShrinkScaled = childFlex.FlexShrink * basis;
+        m_Memo.TakenSize = takenSize;
+        m_Memo.TotalGrow = totalGrow;
+        m_Memo.TotalShrinkScaled = totalShrink;
+        m_Memo.Run = m_Layout.StrategyRuns + 1; // the caller bumps StrategyRuns on return
+
+        // The full solve derives the container's size from inputs that did not change.
+        m_Layout.ComputedWidth = m_Memo.ExitW;
+        m_Layout.ComputedHeight = m_Memo.ExitH;
+        return true;
     }
 
 private:
@@ -83,10 +218,12 @@ private:
     /// Split children into the in-flow item slice and the container's out-of-flow list,
     /// then order the items by CSS `order` when any item overrides the default.
     void CollectAndOrderItems() {
+        MASHARIF_LAYOUT_PHASE(m_Ctx, LayoutPhase::FlexCollectAndOrderItems);
         // Detect any non-default `order` while collecting, instead of a second O(n) any_of
         // scan over m_Items. Accumulate ONLY in the in-flow branch so the flag's domain
         // matches the items the sort sees (out-of-flow children are never ordered).
         bool anyOrder = false;
+        m_Memo.Items.assign(m_Container.m_Children.size(), {});
         for (auto &child: m_Container.m_Children) {
             // display:none generates no box at all — skip it for BOTH in-flow and out-of-flow
             // layout. It must not enter m_OutOfFlowChildren (it would be measured and positioned
@@ -94,17 +231,22 @@ private:
             if (child->GetStyle().GetDimensions().Display == OuterDisplay::None)
                 continue;
             const auto pos = child->GetStyle().GetDimensions().Position;
-            if (pos != PositionType::Static && pos != PositionType::Relative) {
+            if (IsOutOfFlow(pos)) {
                 m_Container.m_OutOfFlowChildren.push_back(child.get());
             } else {
                 m_Items.Append(child.get());
+                Memo(child.get()).InFlow = true;
                 anyOrder = anyOrder || child->GetStyle().GetFlex().Order != 0;
             }
         }
 
+        m_AnyOrder = anyOrder;
         if (anyOrder) {
-            std::ranges::stable_sort(m_Items.begin(), m_Items.end(), {},
-                                     [](Node *n) { return n->GetStyle().GetFlex().Order; });
+            // Stable by `order`: ties keep document order. Sorting on (order, index) instead of
+            // std::stable_sort avoids its temporary buffer, an allocation per ordered run.
+            std::ranges::sort(m_Items.begin(), m_Items.end(), {}, [](const Node *n) {
+                return std::pair(n->GetStyle().GetFlex().Order, n->m_indexInParent);
+            });
         }
     }
 
@@ -114,60 +256,31 @@ private:
         const auto &pad = m_Style.GetPadding();
         const auto &bor = m_Style.GetBorder();
         const auto &dim = m_Style.GetDimensions();
-        const bool widthExplicit = dim.Width.Unit == CSSUnit::Px || dim.Width.Unit == CSSUnit::Percent;
-        const bool heightExplicit = dim.Height.Unit == CSSUnit::Px || dim.Height.Unit == CSSUnit::Percent;
+        const bool widthExplicit = dim.Width.IsLength() || dim.Width.HasPercentage();
+        const bool heightExplicit = dim.Height.IsLength() || dim.Height.HasPercentage();
         if (widthExplicit && !std::isnan(m_Layout.ComputedWidth)) {
             m_AvailableWidth = m_Layout.ComputedWidth
-                               - pad.Left.Value - pad.Right.Value
-                               - bor.WidthLeft.Value - bor.WidthRight.Value;
+                               - pad.Left.Length() - pad.Right.Length()
+                               - bor.WidthLeft.Length() - bor.WidthRight.Length();
         }
         if (heightExplicit && !std::isnan(m_Layout.ComputedHeight)) {
             m_AvailableHeight = m_Layout.ComputedHeight
-                                - pad.Top.Value - pad.Bottom.Value
-                                - bor.WidthTop.Value - bor.WidthBottom.Value;
+                                - pad.Top.Length() - pad.Bottom.Length()
+                                - bor.WidthTop.Length() - bor.WidthBottom.Length();
         }
     }
 
     /// Compute each item's flex basis. Min/max constraints are suppressed here
     /// (ignoreMinMax) because the flex algorithm applies them in ResolveFlexibleLengths.
     void MeasureItemBases() {
+        MASHARIF_LAYOUT_PHASE(m_Ctx, LayoutPhase::FlexMeasureItemBases);
+        m_Memo.MeasureAvailW = m_AvailableWidth;
+        m_Memo.MeasureAvailH = m_AvailableHeight;
         const std::size_t count = m_Items.Count();
         for (std::size_t i = 0; i < count; ++i) {
-            Node *child = m_Items[i]; // copy out: the recursive solve below may grow the arena
-
-            float childAvailW = m_AvailableWidth;
-            float childAvailH = m_AvailableHeight;
-            const auto &dim = child->GetStyle().GetDimensions();
-            if (m_IsRow && dim.Width.Unit == CSSUnit::Auto)
-                childAvailW = std::numeric_limits<float>::quiet_NaN();
-            if (!m_IsRow && dim.Height.Unit == CSSUnit::Auto)
-                childAvailH = std::numeric_limits<float>::quiet_NaN();
-
-            child->LayoutImpl(m_Ctx, childAvailW, childAvailH, /*ignoreMinMax=*/true);
-
-            auto &childLayout = child->GetLayout();
-            const auto &childStyle = child->GetStyle();
-
-            const float basisRef = m_IsRow ? m_AvailableWidth : m_AvailableHeight;
-            if (childStyle.GetFlex().FlexBasis.Unit == CSSUnit::Auto) {
-                const float resolved = m_IsRow ? childLayout.ComputedWidth : childLayout.ComputedHeight;
-                childLayout.ComputedFlexBasis = std::isnan(resolved) ? 0.0f : resolved;
-            } else {
-                const auto &pad = childStyle.GetPadding();
-                const auto &[wTop, wBottom, wLeft, wRight] = childStyle.GetBorder();
-                const float pb = m_IsRow
-                                     ? pad.Left.Value + pad.Right.Value + wLeft.Value + wRight.Value
-                                     : pad.Top.Value + pad.Bottom.Value + wTop.Value + wBottom.Value;
-                childLayout.ComputedFlexBasis = childStyle.GetFlex().FlexBasis.ResolveValue(basisRef) + pb;
-            }
-
-            // Main-axis margins occupy main-axis space alongside the basis (BuildLine counts them
-            // when packing a line), so they belong in the content total: a shrink-to-fit (AUTO) main
-            // axis must enclose its children's MARGIN boxes, not just their border boxes.
-            m_TotalMainSize += childLayout.ComputedFlexBasis
-                               + NeededMainAxisMargin(m_IsRow, childStyle.GetMargin(), basisRef);
-            m_MaxCrossSize = std::max(m_MaxCrossSize,
-                                      m_IsRow ? childLayout.ComputedHeight : childLayout.ComputedWidth);
+            MeasureItemBasis(m_Items[i]); // copy out: the recursive solve below may grow the arena
+            if (m_Ctx.Yielded)
+                return;
         }
 
         // Inter-item gaps occupy main-axis space too (BuildLine adds gapSize between items); fold the
@@ -183,20 +296,63 @@ private:
         }
     }
 
+    /// One item of MeasureItemBases: solve it in the available space and derive its basis.
+    void MeasureItemBasis(Node *child) {
+        float childAvailW = m_AvailableWidth;
+        float childAvailH = m_AvailableHeight;
+        const auto &dim = child->GetStyle().GetDimensions();
+        // An AUTO width is measured at its max-content width before min/max, as a flex base size
+        // is, rather than in NaN space, where a block would collapse to its padding.
+        if (m_IsRow && dim.Width.Unit == CSSUnit::Auto)
+            childAvailW = child->OuterIntrinsicSize(IntrinsicSizing::MaxContent, LayoutAxis::Horizontal, true);
+        if (!m_IsRow && dim.Height.Unit == CSSUnit::Auto)
+            childAvailH = std::numeric_limits<float>::quiet_NaN();
+
+        child->LayoutImpl(m_Ctx, childAvailW, childAvailH, /*ignoreMinMax=*/true);
+
+        auto &childLayout = child->GetLayout();
+        const auto &childStyle = child->GetStyle();
+
+        const float basisRef = m_IsRow ? m_AvailableWidth : m_AvailableHeight;
+        if (childStyle.GetFlex().FlexBasis.Unit == CSSUnit::Auto) {
+            const float resolved = m_IsRow ? childLayout.ComputedWidth : childLayout.ComputedHeight;
+            childLayout.ComputedFlexBasis = std::isnan(resolved) ? 0.0f : resolved;
+        } else {
+            const auto &pad = childStyle.GetPadding();
+            const auto &[wTop, wBottom, wLeft, wRight] = childStyle.GetBorder();
+            const float pb = m_IsRow
+                                 ? pad.Left.Length() + pad.Right.Length() + wLeft.Length() + wRight.Length()
+                                 : pad.Top.Length() + pad.Bottom.Length() + wTop.Length() + wBottom.Length();
+            childLayout.ComputedFlexBasis = childStyle.GetFlex().FlexBasis.ResolveValue(basisRef) + pb;
+        }
+
+        // Main-axis margins occupy main-axis space alongside the basis (BuildLine counts them
+        // when packing a line), so they belong in the content total: a shrink-to-fit (AUTO) main
+        // axis must enclose its children's MARGIN boxes, not just their border boxes.
+        m_TotalMainSize += childLayout.ComputedFlexBasis
+                           + NeededMainAxisMargin(m_IsRow, childStyle.GetMargin(), basisRef);
+        const float cross = m_IsRow ? childLayout.ComputedHeight : childLayout.ComputedWidth;
+        m_MaxCrossSize = std::max(m_MaxCrossSize, cross);
+        Memo(child).Cross = cross;
+    }
+
     /// Resolve NaN available space and shrink-wrap an AUTO main axis to content
     /// (unless the parent has already fixed this node's size — MainSizeIsDefinite).
     void ResolveContainerSize() {
         const auto &p = m_Style.GetPadding();
         const auto &b = m_Style.GetBorder();
-        const float pbRow = p.Left.Value + p.Right.Value + b.WidthLeft.Value + b.WidthRight.Value;
-        const float pbCol = p.Top.Value + p.Bottom.Value + b.WidthTop.Value + b.WidthBottom.Value;
+        const float pbRow = p.Left.Length() + p.Right.Length() + b.WidthLeft.Length() + b.WidthRight.Length();
+        const float pbCol = p.Top.Length() + p.Bottom.Length() + b.WidthTop.Length() + b.WidthBottom.Length();
 
         if (std::isnan(m_AvailableWidth)) {
-            if (m_Style.GetDimensions().Width.Unit == CSSUnit::Auto)
+            if (m_Style.GetDimensions().Width.Unit == CSSUnit::Auto) {
                 m_Layout.ComputedWidth = (m_IsRow ? m_TotalMainSize : m_MaxCrossSize) + pbRow;
+                m_MainFromContent = m_MainFromContent || m_IsRow;
+            }
             m_AvailableWidth = m_Layout.ComputedWidth - pbRow;
         } else if (m_IsRow && m_Style.GetDimensions().Width.Unit == CSSUnit::Auto
                    && !m_Container.MainSizeIsDefinite()) {
+            m_MainFromContent = true;
             m_Layout.ComputedWidth = m_TotalMainSize + pbRow;
             m_AvailableWidth = m_Layout.ComputedWidth - pbRow;
         } else if (std::isnan(m_Layout.ComputedWidth)) {
@@ -204,11 +360,14 @@ private:
         }
 
         if (std::isnan(m_AvailableHeight)) {
-            if (m_Style.GetDimensions().Height.Unit == CSSUnit::Auto)
+            if (m_Style.GetDimensions().Height.Unit == CSSUnit::Auto) {
                 m_Layout.ComputedHeight = (!m_IsRow ? m_TotalMainSize : m_MaxCrossSize) + pbCol;
+                m_MainFromContent = m_MainFromContent || !m_IsRow;
+            }
             m_AvailableHeight = m_Layout.ComputedHeight - pbCol;
         } else if (!m_IsRow && m_Style.GetDimensions().Height.Unit == CSSUnit::Auto
                    && !m_Container.MainSizeIsDefinite()) {
+            m_MainFromContent = true;
             m_Layout.ComputedHeight = m_TotalMainSize + pbCol;
             m_AvailableHeight = m_Layout.ComputedHeight - pbCol;
         } else if (std::isnan(m_Layout.ComputedHeight)) {
@@ -219,6 +378,7 @@ private:
     /// Greedily pack items into one flex line starting at m_NextItem. Advances the
     /// cursor past every item consumed; on wrap it is left at the next line's first item.
     [[nodiscard]] FlexLine BuildLine(const float lineMainSize) {
+        MASHARIF_LAYOUT_PHASE(m_Ctx, LayoutPhase::FlexBuildLine);
         const CSSFlex &flex = m_Style.GetFlex();
         const bool isWrap = flex.Wrap == FlexWrap::Wrap ||
                             flex.Wrap == FlexWrap::WrapReverse;
@@ -264,6 +424,11 @@ private:
             totalFlexGrow += childFlex.FlexGrow;
             totalFlexShrinkScaled += childFlex.FlexShrink * childLayout.ComputedFlexBasis;
             takenSize = newTaken;
+
+            FlexItemMemo &memo = Memo(child);
+            memo.Taken = neededMargin + childLayout.ComputedFlexBasis;
+            memo.Grow = childFlex.FlexGrow;
+            memo.ShrinkScaled = childFlex.FlexShrink * childLayout.ComputedFlexBasis;
         }
 
         return {
@@ -277,9 +442,28 @@ private:
         };
     }
 
+    /// Clamp a main size to the item's min/max (max first, then min, so min wins when
+    /// min > max), resolved against the container's available space.
+    [[nodiscard]] float ClampMainSize(Node *child, float size) const {
+        const auto &dims = child->GetStyle().GetDimensions();
+        if (m_IsRow) {
+            if (dims.MaxWidth.Unit != CSSUnit::Auto)
+                size = std::min(size, dims.MaxWidth.ResolveValue(m_AvailableWidth));
+            if (dims.MinWidth.Unit != CSSUnit::Auto)
+                size = std::max(size, dims.MinWidth.ResolveValue(m_AvailableWidth));
+        } else {
+            if (dims.MaxHeight.Unit != CSSUnit::Auto)
+                size = std::min(size, dims.MaxHeight.ResolveValue(m_AvailableHeight));
+            if (dims.MinHeight.Unit != CSSUnit::Auto)
+                size = std::max(size, dims.MinHeight.ResolveValue(m_AvailableHeight));
+        }
+        return size;
+    }
+
     /// CSS flexible-length resolution: distribute free space by grow/shrink factors,
     /// clamp to min/max, freeze violators, repeat until stable.
     void ResolveFlexibleLengths(const FlexLine &line, const float availableSpace) {
+        MASHARIF_LAYOUT_PHASE(m_Ctx, LayoutPhase::FlexResolveFlexibleLengths);
         const std::size_t n = LineItemCount(line);
         if (n == 0) return;
 
@@ -291,26 +475,12 @@ private:
 
         // Inflexible line (neither growing nor shrinking): the distribution term is provably
         // zero, so the full freeze loop reduces to a single min/max clamp per item that
-        // converges immediately. Skip the baseSizes/frozen arenas and the loop entirely. The
-        // clamp block below is byte-identical to the one in the freeze loop (max-clamp first,
-        // then min-clamp, so min wins when min > max) and uses the same resolve references.
+        // converges immediately. Skip the baseSizes/frozen arenas and the loop entirely; the
+        // clamp is the same ClampMainSize the freeze loop applies.
         if (!isGrowing && !isShrinking) {
             for (std::size_t i = 0; i < n; i++) {
                 Node *child = m_Items[line.ItemBegin + i];
-                const auto &dims = child->GetStyle().GetDimensions();
-                float clamped = child->GetLayout().ComputedFlexBasis;
-                if (m_IsRow) {
-                    if (dims.MaxWidth.Unit != CSSUnit::Auto)
-                        clamped = std::min(clamped, dims.MaxWidth.ResolveValue(m_AvailableWidth));
-                    if (dims.MinWidth.Unit != CSSUnit::Auto)
-                        clamped = std::max(clamped, dims.MinWidth.ResolveValue(m_AvailableWidth));
-                } else {
-                    if (dims.MaxHeight.Unit != CSSUnit::Auto)
-                        clamped = std::min(clamped, dims.MaxHeight.ResolveValue(m_AvailableHeight));
-                    if (dims.MinHeight.Unit != CSSUnit::Auto)
-                        clamped = std::max(clamped, dims.MinHeight.ResolveValue(m_AvailableHeight));
-                }
-                child->GetLayout().ComputedFlexBasis = clamped;
+                child->GetLayout().ComputedFlexBasis = ClampMainSize(child, child->GetLayout().ComputedFlexBasis);
             }
             return;
         }
@@ -375,19 +545,7 @@ private:
                     newSize += (sf / unfrozenScaledShrink) * freeSpace;
                 }
 
-                const auto &dims = child->GetStyle().GetDimensions();
-                float clamped = newSize;
-                if (m_IsRow) {
-                    if (dims.MaxWidth.Unit != CSSUnit::Auto)
-                        clamped = std::min(clamped, dims.MaxWidth.ResolveValue(m_AvailableWidth));
-                    if (dims.MinWidth.Unit != CSSUnit::Auto)
-                        clamped = std::max(clamped, dims.MinWidth.ResolveValue(m_AvailableWidth));
-                } else {
-                    if (dims.MaxHeight.Unit != CSSUnit::Auto)
-                        clamped = std::min(clamped, dims.MaxHeight.ResolveValue(m_AvailableHeight));
-                    if (dims.MinHeight.Unit != CSSUnit::Auto)
-                        clamped = std::max(clamped, dims.MinHeight.ResolveValue(m_AvailableHeight));
-                }
+                const float clamped = ClampMainSize(child, newSize);
 
                 if (clamped != newSize) {
                     frozen[i] = 1;
@@ -406,6 +564,7 @@ private:
     void PositionLineOnMainAxis(const FlexLine &line, const float availableSpace,
                                 const float containerMainSize, const float padStart,
                                 const float padEnd, const float crossPos) {
+        MASHARIF_LAYOUT_PHASE(m_Ctx, LayoutPhase::FlexPositionLineOnMainAxis);
         const std::size_t itemCount = LineItemCount(line);
 
         float takenAfterResolve = 0;
@@ -478,6 +637,10 @@ private:
                                 : childStyle.GetMargin().Bottom.ResolveValue(m_AvailableHeight);
             }
 
+            FlexItemMemo &memo = Memo(child);
+            memo.MainPos = currentPosition;
+            memo.Outer = marginStart + childLayout.ComputedFlexBasis + marginEnd;
+
             if (m_IsRow) {
                 childLayout.LocalY = crossPos;
                 childLayout.LocalX = m_IsReverse
@@ -500,6 +663,7 @@ private:
     /// align-content across lines + per-item cross sizing (stretch), auto cross margins
     /// and align-items/align-self placement.
     void AlignLinesOnCrossAxis() {
+        MASHARIF_LAYOUT_PHASE(m_Ctx, LayoutPhase::FlexAlignLinesOnCrossAxis);
         const std::size_t lineCount = m_Lines.Count();
         if (lineCount == 0) return;
 
@@ -575,83 +739,92 @@ private:
                                              ? (containerCrossSize - crossOffset - line.CrossSize)
                                              : crossOffset;
 
-            for (std::size_t i = line.ItemBegin; i < line.ItemEnd; ++i) {
-                Node *child = m_Items[i];
-                const auto &childStyle = child->GetStyle();
-                const auto &dimension = childStyle.GetDimensions();
-                const auto &margin = childStyle.GetMargin();
-                auto &childLayout = child->GetLayout();
-                float childCrossSize = m_IsRow ? childLayout.ComputedHeight : childLayout.ComputedWidth;
-
-                AlignItems alignment = childStyle.GetFlex().AlignSelf != AlignItems::AutoAlign
-                                           ? childStyle.GetFlex().AlignSelf
-                                           : m_Style.GetFlex().Align;
-
-                // Cross-axis margins resolved ONCE against line.CrossSize (read-only in this
-                // loop), reused by both the stretch sizing and the placement below — row uses
-                // Top/Bottom, column uses Left/Right. Auto resolves to 0; the auto-margin branch
-                // overrides these locals. marginStart/marginEnd stay mutable for that override.
-                const CSSValue &crossStartEdge = m_IsRow ? margin.Top : margin.Left;
-                const CSSValue &crossEndEdge = m_IsRow ? margin.Bottom : margin.Right;
-                float marginStart = crossStartEdge.ResolveValue(line.CrossSize);
-                float marginEnd = crossEndEdge.ResolveValue(line.CrossSize);
-
-                if (alignment == AlignItems::Stretch &&
-                    (m_IsRow
-                         ? dimension.Height.Unit == CSSUnit::Auto
-                         : dimension.Width.Unit == CSSUnit::Auto)) {
-                    const float stretchedSize = line.CrossSize - (marginStart + marginEnd);
-                    if (stretchedSize > 0) {
-                        if (m_IsRow) childLayout.ComputedHeight = stretchedSize;
-                        else childLayout.ComputedWidth = stretchedSize;
-                        childCrossSize = stretchedSize;
-                    }
-                }
-
-                const bool hasAutoStart = crossStartEdge.Unit == CSSUnit::Auto;
-                const bool hasAutoEnd = crossEndEdge.Unit == CSSUnit::Auto;
-                const int autoMarginCount = (hasAutoStart ? 1 : 0) + (hasAutoEnd ? 1 : 0);
-
-                const float availableForAuto = line.CrossSize - childCrossSize - (marginStart + marginEnd);
-                if (autoMarginCount > 0 && availableForAuto > 0) {
-                    const float autoSize = availableForAuto / autoMarginCount;
-                    if (hasAutoStart) marginStart = autoSize;
-                    if (hasAutoEnd) marginEnd = autoSize;
-                    alignment = AlignItems::FlexStart;
-                } else {
-                    if (hasAutoStart) marginStart = 0;
-                    if (hasAutoEnd) marginEnd = 0;
-                }
+            if (li == 0) {
+                m_Memo.LineCrossStart = lineCrossStart;
+                m_Memo.LineCrossSize = line.CrossSize;
+            }
+            for (std::size_t i = line.ItemBegin; i < line.ItemEnd; ++i)
+                AlignItemOnCrossAxis(m_Items[i], lineCrossStart, line.CrossSize);
 
-                float itemCrossPos = 0;
-                switch (alignment) {
-                    case AlignItems::FlexStart:
-                        itemCrossPos = lineCrossStart + marginStart;
-                        break;
-                    case AlignItems::FlexEnd:
-                        itemCrossPos = lineCrossStart + line.CrossSize - childCrossSize - marginEnd;
-                        break;
-                    case AlignItems::FlexCenter:
-                        itemCrossPos = lineCrossStart + (line.CrossSize - childCrossSize) / 2.0f
-                                       + (marginStart - marginEnd) / 2.0f;
-                        break;
-                    default: // Stretch + fallback
-                        itemCrossPos = lineCrossStart + marginStart;
-                        break;
-                }
+            crossOffset += line.CrossSize + lineSpacing;
+        }
+    }
 
-                if (m_IsRow) childLayout.LocalY = itemCrossPos;
-                else childLayout.LocalX = itemCrossPos;
+    /// Cross sizing (stretch), auto cross margins and align-items/align-self placement of
+    /// one item within its line.
+    void AlignItemOnCrossAxis(Node *child, const float lineCrossStart, const float lineCrossSize) {
+        const auto &childStyle = child->GetStyle();
+        const auto &dimension = childStyle.GetDimensions();
+        const auto &margin = childStyle.GetMargin();
+        auto &childLayout = child->GetLayout();
+        float childCrossSize = m_IsRow ? childLayout.ComputedHeight : childLayout.ComputedWidth;
+
+        AlignItems alignment = childStyle.GetFlex().AlignSelf != AlignItems::AutoAlign
+                                   ? childStyle.GetFlex().AlignSelf
+                                   : m_Style.GetFlex().Align;
+
+        // Cross-axis margins resolved ONCE against lineCrossSize (fixed for the line),
+        // reused by both the stretch sizing and the placement below — row uses
+        // Top/Bottom, column uses Left/Right. Auto resolves to 0; the auto-margin branch
+        // overrides these locals. marginStart/marginEnd stay mutable for that override.
+        const CSSValue &crossStartEdge = m_IsRow ? margin.Top : margin.Left;
+        const CSSValue &crossEndEdge = m_IsRow ? margin.Bottom : margin.Right;
+        float marginStart = crossStartEdge.ResolveValue(lineCrossSize);
+        float marginEnd = crossEndEdge.ResolveValue(lineCrossSize);
+
+        if (alignment == AlignItems::Stretch &&
+            (m_IsRow
+                 ? dimension.Height.Unit == CSSUnit::Auto
+                 : dimension.Width.Unit == CSSUnit::Auto)) {
+            const float stretchedSize = lineCrossSize - (marginStart + marginEnd);
+            if (stretchedSize > 0) {
+                if (m_IsRow) childLayout.ComputedHeight = stretchedSize;
+                else childLayout.ComputedWidth = stretchedSize;
+                childCrossSize = stretchedSize;
             }
+        }
 
-            crossOffset += line.CrossSize + lineSpacing;
+        const bool hasAutoStart = crossStartEdge.Unit == CSSUnit::Auto;
+        const bool hasAutoEnd = crossEndEdge.Unit == CSSUnit::Auto;
+        const int autoMarginCount = (hasAutoStart ? 1 : 0) + (hasAutoEnd ? 1 : 0);
+
+        const float availableForAuto = lineCrossSize - childCrossSize - (marginStart + marginEnd);
+        if (autoMarginCount > 0 && availableForAuto > 0) {
+            const float autoSize = availableForAuto / autoMarginCount;
+            if (hasAutoStart) marginStart = autoSize;
+            if (hasAutoEnd) marginEnd = autoSize;
+            alignment = AlignItems::FlexStart;
+        } else {
+            if (hasAutoStart) marginStart = 0;
+            if (hasAutoEnd) marginEnd = 0;
         }
+
+        float itemCrossPos = 0;
+        switch (alignment) {
+            case AlignItems::FlexStart:
+                itemCrossPos = lineCrossStart + marginStart;
+                break;
+            case AlignItems::FlexEnd:
+                itemCrossPos = lineCrossStart + lineCrossSize - childCrossSize - marginEnd;
+                break;
+            case AlignItems::FlexCenter:
+                itemCrossPos = lineCrossStart + (lineCrossSize - childCrossSize) / 2.0f
+                               + (marginStart - marginEnd) / 2.0f;
+                break;
+            default: // Stretch + fallback
+                itemCrossPos = lineCrossStart + marginStart;
+                break;
+        }
+
+        if (m_IsRow) childLayout.LocalY = itemCrossPos;
+        else childLayout.LocalX = itemCrossPos;
     }
 
     /// Re-lay-out each item at its now-definite border box. During the basis phase,
     /// AUTO-size items collapsed their subtrees to 0 (measured against NaN); this pass
     /// expands them at the resolved size.
     void RelayoutItemsAtDefiniteSize() {
+        MASHARIF_LAYOUT_PHASE(m_Ctx, LayoutPhase::FlexRelayoutItemsAtDefiniteSize);
         const std::size_t lineCount = m_Lines.Count();
         for (std::size_t li = 0; li < lineCount; ++li) {
             const FlexLine line = m_Lines[li]; // copy out: the recursive solve grows the arena
@@ -660,10 +833,51 @@ private:
                 const auto &childLayout = child->GetLayout();
                 child->LayoutContentsWithDefiniteSize(m_Ctx, childLayout.ComputedWidth,
                                                       childLayout.ComputedHeight);
+                if (m_Ctx.Yielded)
+                    return;
             }
         }
     }
 
+    /// Publish this run's line summary for TryTranslateOnly, or mark the memo ineligible when
+    /// the line could not be replayed by translation alone.
+    void RecordLineMemo(const float availableSpace) {
+        m_Memo.Run = m_Layout.StrategyRuns + 1; // the caller bumps StrategyRuns on return
+        m_Memo.Eligible = false;
+        if (m_Lines.Count() != 1 || m_AnyOrder || m_MainFromContent || m_IsReverse ||
+            m_Style.GetFlex().Wrap != FlexWrap::NoWrap ||
+            m_Style.GetFlex().Justify != JustifyContent::FlexStart)
+            return;
+        const FlexLine &line = m_Lines[0];
+        const float remainingSpace = availableSpace - line.TakenSize;
+        if (line.NumberOfAutoMargin > 0 ||
+            (remainingSpace > 0 && line.TotalFlexGrow > 0) ||
+            (remainingSpace < 0 && line.TotalFlexShrinkScaledFactors != 0) ||
+            std::isnan(m_MaxCrossSize) || std::isnan(line.CrossSize))
+            return;
+
+        m_Memo.Eligible = true;
+        m_Memo.MainDefinite = m_Container.MainSizeIsDefinite();
+        m_Memo.CrossDefinite = m_Container.CrossSizeIsDefinite();
+        m_Memo.AvailW = m_InputWidth;
+        m_Memo.AvailH = m_InputHeight;
+        m_Memo.EntryW = m_EntryWidth;
+        m_Memo.EntryH = m_EntryHeight;
+        m_Memo.ExitW = m_Layout.ComputedWidth;
+        m_Memo.ExitH = m_Layout.ComputedHeight;
+        m_Memo.ResolvedAvailW = m_AvailableWidth;
+        m_Memo.ResolvedAvailH = m_AvailableHeight;
+        m_Memo.AvailableSpace = availableSpace;
+        m_Memo.TakenSize = line.TakenSize;
+        m_Memo.TotalGrow = line.TotalFlexGrow;
+        m_Memo.TotalShrinkScaled = line.TotalFlexShrinkScaledFactors;
+        m_Memo.MaxCross = m_MaxCrossSize;
+    }
+
+    [[nodiscard]] FlexItemMemo &Memo(const Node *child) const {
+        return m_Memo.Items[child->m_indexInParent];
+    }
+
     Node &m_Container;
     LayoutContext &m_Ctx;
     Style &m_Style;
@@ -677,13 +891,65 @@ private:
     ArenaSlice<Node *> m_Items;
     ArenaSlice<FlexLine> m_Lines;
     std::size_t m_NextItem = 0;
+    FlexLineMemo &m_Memo;
+    const float m_InputWidth;
+    const float m_InputHeight;
+    const float m_EntryWidth;
+    const float m_EntryHeight;
+    bool m_AnyOrder = false;
+    bool m_MainFromContent = false;
 };
 
 void FlexLayoutStrategy::Layout(Node &container, LayoutContext &ctx,
                                 const float availableWidth, const float availableHeight) const {
+    MASHARIF_LAYOUT_PHASE(ctx, LayoutPhase::FlexStrategy);
+    const TraceSlice trace(ctx, TraceSliceKind::Strategy, static_cast<std::uint8_t>(LayoutPhase::FlexStrategy),
+                           &container, availableWidth, availableHeight);
     // The out-of-flow list must reflect exactly this run: the strategy can run more than
     // once per frame (basis + definite passes), and stale entries would be positioned twice.
+    // The translate-only path keeps the list: its one changed child stayed in flow.
+    if (Solver(container, ctx, availableWidth, availableHeight).TryTranslateOnly() || ctx.Yielded)
+        return;
     container.m_OutOfFlowChildren.clear();
 
     Solver(container, ctx, availableWidth, availableHeight).Run();
 }
+
+float FlexLayoutStrategy::IntrinsicContentSize(Node &container, const IntrinsicSizing sizing,
+                                               const LayoutAxis axis) const {
+    // Items sit side by side on the main axis and share a line's cross size, unless a wrapping
+    // container at min-content puts each on its own line. On the main axis an item contributes
+    // its definite flex basis when it has one, as the solver's content total does.
+    const CSSFlex &flex = container.GetStyle().GetFlex();
+    const bool horizontal = axis == LayoutAxis::Horizontal;
+    const bool mainAxis = flex.IsRow() == horizontal;
+    const bool onePerLine = flex.Wrap != FlexWrap::NoWrap && sizing == IntrinsicSizing::MinContent;
+    const bool stacked = mainAxis != onePerLine;
+    const float gap = horizontal ? flex.Gaps.Column.ResolveValue(0.0f) : flex.Gaps.Row.ResolveValue(0.0f);
+
+    float total = 0.0f;
+    std::size_t items = 0;
+    for (const auto &child: container.m_Children) {
+        const auto &childStyle = child->GetStyle();
+        const auto &dim = childStyle.GetDimensions();
+        if (dim.Display == OuterDisplay::None || IsOutOfFlow(dim.Position))
+            continue;
+        float outer = child->OuterIntrinsicSize(sizing, axis);
+        if (mainAxis && childStyle.GetFlex().FlexBasis.IsLength()) {
+            const auto &pad = childStyle.GetPadding();
+            const auto &border = childStyle.GetBorder();
+            const auto &margin = childStyle.GetMargin();
+            outer = childStyle.GetFlex().FlexBasis.Length() +
+                    (horizontal
+                         ? pad.Left.Length() + pad.Right.Length() + border.WidthLeft.Length() + border.WidthRight.Length() +
+                           margin.Left.ResolveValue(0.0f) + margin.Right.ResolveValue(0.0f)
+                         : pad.Top.Length() + pad.Bottom.Length() + border.WidthTop.Length() + border.WidthBottom.Length() +
+                           margin.Top.ResolveValue(0.0f) + margin.Bottom.ResolveValue(0.0f));
+        }
+        total = stacked ? total + outer : std::max(total, outer);
+        ++items;
+    }
+    if (stacked && items > 1)
+        total += gap * static_cast<float>(items - 1);
+    return total;
+}
@@ -8,6 +8,9 @@ namespace masharif {
         void Layout(Node &container, LayoutContext &ctx,
                     float availableWidth, float availableHeight) const override;
 
+        [[nodiscard]] float IntrinsicContentSize(Node &container, IntrinsicSizing sizing,
+                                                 LayoutAxis axis) const override;
+
     private:
         /// One flex solve for one container; defined in the .cpp. Nested so it shares this
         /// strategy's friend access to Node ([class.access.nest]).
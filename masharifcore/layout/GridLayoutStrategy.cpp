@@ -0,0 +1,562 @@
+#include "GridLayoutStrategy.h"
+
+#include "LayoutContext.h"
+#include "Node.h"
+#include "masharifcore/structure/CSSValue.h"
+#include "masharifcore/structure/Grid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+using namespace masharif;
+
+namespace {
+    /// NaN (AUTO) compares equal to NaN, matching Node's space memo.
+    bool SameSpace(const float a, const float b) {
+        return (std::isnan(a) && std::isnan(b)) || a == b;
+    }
+
+    /// Percentages of an indefinite size resolve against 0.
+    float Reference(const float size) {
+        return std::isnan(size) ? 0.0f : size;
+    }
+
+    /// Track `i` of an axis: the template's, or the implicit track past it.
+    GridTrack TrackAt(const GridTemplate &tracks, const GridTrack &implicit, const std::size_t i) {
+        return i < tracks.Size() ? tracks[i] : implicit;
+    }
+
+    /// Auto tracks, and percent and fr tracks of an indefinite axis, are sized by their items.
+    bool SizedByItems(const GridTrack &track, const bool definite) {
+        return track.Unit == GridTrackUnit::Auto || (!definite && track.Unit != GridTrackUnit::Px);
+    }
+
+    /// starts[i] = offset of track i: the sizes before it plus one gap between each pair.
+    void TrackStarts(const std::vector<float> &sizes, const float gap, std::vector<float> &starts) {
+        starts.resize(sizes.size());
+        float cursor = 0.0f;
+        for (std::size_t i = 0; i < sizes.size(); ++i) {
+            starts[i] = cursor;
+            cursor += sizes[i] + gap;
+        }
+    }
+
+    /// Extent of the tracks [start, start + span), the gaps between them included.
+    float AreaSize(const std::vector<float> &sizes, const std::vector<float> &starts,
+                   const std::uint32_t start, const std::uint32_t span) {
+        const std::uint32_t last = start + span - 1;
+        return starts[last] + sizes[last] - starts[start];
+    }
+}
+
+/// One grid solve for one container: collect the items, place them (or reuse the memoized
+/// placement), size the columns, then the rows, then lay out every item in its area.
+class GridLayoutStrategy::Solver {
+    using GridArea = Node::GridArea;
+    using GridMemo = Node::GridMemo;
+
+public:
+    Solver(Node &container, LayoutContext &ctx, const float availableWidth, const float availableHeight)
+        : m_Container(container),
+          m_Ctx(ctx),
+          m_Style(container.GetStyle()),
+          m_Layout(container.GetLayout()),
+          m_Grid(m_Style.GetGrid()),
+          m_Memo(container.m_gridMemo),
+          m_Items(ctx.InFlowItems),
+          m_Contributions(ctx.BaseSizes),
+          m_AvailableWidth(availableWidth),
+          m_AvailableHeight(availableHeight) {
+    }
+
+    void Run() {
+        ResolveContentBox();
+
+        // Whatever this run keeps from the last one, it decides before the memo is cleared: from
+        // here on the memo describes no run until this one completes or a time-sliced solve
+        // stops it in an item's solve. A run stopped in this frame at this content box keeps
+        // the placement and the tracks it had finished.
+        const std::size_t count = m_Container.m_Children.size();
+        const bool stamped = m_Memo.Run == m_Layout.StrategyRuns && m_Memo.ChildCount == count;
+        const bool resumed = stamped && m_Memo.Suspended != 0 && m_Memo.Suspended == m_Container.m_generation &&
+                             SameSpace(m_Memo.ContentW, m_ContentWidth) && SameSpace(m_Memo.ContentH, m_ContentHeight);
+        const bool sameRun = stamped && m_Memo.Suspended == 0;
+        const bool placementValid = resumed || (sameRun && !m_Style.Dirty && !AnyChangedChildRestyled());
+        const bool childrenClean = m_Container.m_changedBegin >= m_Container.m_changedEnd;
+        m_Memo.Run = 0;
+        m_Memo.Suspended = 0;
+
+        CollectItems(placementValid);
+        if (!placementValid)
+            PlaceItems();
+
+        const bool columnsValid = resumed
+                                      ? m_Memo.ColumnsSized
+                                      : placementValid && SameSpace(m_Memo.ContentW, m_ContentWidth) &&
+                                        (!m_Memo.ColumnsIntrinsic || childrenClean);
+        if (!columnsValid)
+            SizeColumns();
+        if (m_Ctx.Yielded)
+            return Suspend(false, false);
+        const bool rowsValid = resumed
+                                   ? m_Memo.RowsSized
+                                   : columnsValid && SameSpace(m_Memo.ContentH, m_ContentHeight) &&
+                                     (!m_Memo.RowsIntrinsic || childrenClean);
+        if (!rowsValid)
+            SizeRows();
+        if (m_Ctx.Yielded)
+            return Suspend(true, false);
+
+        ResolveContainerSize();
+        LayoutItems();
+        if (m_Ctx.Yielded)
+            return Suspend(true, true);
+
+        m_Memo.Run = m_Layout.StrategyRuns + 1; // the caller bumps StrategyRuns on return
+        m_Memo.ChildCount = static_cast<std::uint32_t>(count);
+        m_Memo.ContentW = m_ContentWidth;
+        m_Memo.ContentH = m_ContentHeight;
+    }
+
+    /// The tracks of `axis` sized in indefinite space from the items' intrinsic sizes. The memo's
+    /// placement stays valid, its track sizes do not.
+    [[nodiscard]] float IntrinsicSize(const IntrinsicSizing sizing, const LayoutAxis axis) {
+        const bool columns = axis == LayoutAxis::Horizontal;
+        m_Memo.Run = 0;
+        m_Memo.Suspended = 0;
+        CollectItems(false, false);
+        PlaceItems();
+
+        const std::size_t itemCount = m_Items.Count();
+        m_Contributions.Resize(itemCount);
+        for (std::size_t i = 0; i < itemCount; ++i) {
+            Node *item = m_Items[i];
+            const GridArea area = Area(item);
+            const bool contributes = columns
+                                         ? SpansTracksSizedByItems(m_Grid.TemplateColumns, m_Grid.AutoColumns,
+                                                                   area.Column, area.ColumnSpan, false)
+                                         : SpansTracksSizedByItems(m_Grid.TemplateRows, m_Grid.AutoRows, area.Row,
+                                                                   area.RowSpan, false);
+            m_Contributions[i] = contributes ? item->OuterIntrinsicSize(sizing, axis) : NAN;
+        }
+
+        const auto &gaps = m_Style.GetFlex().Gaps;
+        const float gap = columns ? gaps.Column.ResolveValue(0.0f) : gaps.Row.ResolveValue(0.0f);
+        std::vector<float> &sizes = columns ? m_Memo.Columns : m_Memo.Rows;
+        SizeTracks(columns, NAN, gap, sizes);
+        float total = sizes.empty() ? 0.0f : gap * static_cast<float>(sizes.size() - 1);
+        for (const float size: sizes)
+            total += size;
+        return total;
+    }
+
+private:
+    /// Stamp the memo with what the run a time-sliced solve stopped had finished, for this
+    /// frame's next run of the container (see Run).
+    void Suspend(const bool columnsSized, const bool rowsSized) {
+        m_Memo.Run = m_Layout.StrategyRuns;
+        m_Memo.Suspended = m_Container.m_generation;
+        m_Memo.ChildCount = static_cast<std::uint32_t>(m_Container.m_Children.size());
+        m_Memo.ContentW = m_ContentWidth;
+        m_Memo.ContentH = m_ContentHeight;
+        m_Memo.ColumnsSized = columnsSized;
+        m_Memo.RowsSized = rowsSized;
+    }
+
+    /// The content box the tracks are sized in; NaN on an axis sized by its tracks (an AUTO or
+    /// unresolvable percentage size, unless the parent fixed this node's box).
+    void ResolveContentBox() {
+        const auto &p = m_Style.GetPadding();
+        const auto &b = m_Style.GetBorder();
+        m_PbRow = p.Left.Length() + p.Right.Length() + b.WidthLeft.Length() + b.WidthRight.Length();
+        m_PbCol = p.Top.Length() + p.Bottom.Length() + b.WidthTop.Length() + b.WidthBottom.Length();
+        m_OriginX = p.Left.Length() + b.WidthLeft.Length();
+        m_OriginY = p.Top.Length() + b.WidthTop.Length();
+
+        const auto &dim = m_Style.GetDimensions();
+        const bool definite = m_Container.MainSizeIsDefinite();
+        const bool widthFromTracks = !definite && (dim.Width.Unit == CSSUnit::Auto || dim.Width.HasPercentage()) &&
+                                     std::isnan(m_AvailableWidth);
+        const bool heightFromTracks = !definite && (dim.Height.Unit == CSSUnit::Auto ||
+                                                    (dim.Height.HasPercentage() && std::isnan(m_AvailableHeight)));
+        m_ContentWidth = widthFromTracks || std::isnan(m_Layout.ComputedWidth)
+                             ? NAN
+                             : std::max(0.0f, m_Layout.ComputedWidth - m_PbRow);
+        m_ContentHeight = heightFromTracks || std::isnan(m_Layout.ComputedHeight)
+                              ? NAN
+                              : std::max(0.0f, m_Layout.ComputedHeight - m_PbCol);
+
+        const auto &gaps = m_Style.GetFlex().Gaps;
+        m_ColumnGap = gaps.Column.ResolveValue(Reference(m_ContentWidth));
+        m_RowGap = gaps.Row.ResolveValue(Reference(m_ContentHeight));
+    }
+
+    /// Placement depends only on the items' styles: a restyled child is inside the changed range.
+    [[nodiscard]] bool AnyChangedChildRestyled() const {
+        const auto &children = m_Container.m_Children;
+        const std::size_t end = std::min<std::size_t>(m_Container.m_changedEnd, children.size());
+        for (std::size_t i = m_Container.m_changedBegin; i < end; ++i)
+            if (children[i]->GetStyle().Dirty)
+                return true;
+        return false;
+    }
+
+    /// Split children into the in-flow item slice and, for a layout run, the container's
+    /// out-of-flow list, which must reflect exactly this run (see FlexLayoutStrategy::Layout).
+    void CollectItems(const bool placementValid, const bool layoutRun = true) {
+        if (layoutRun)
+            m_Container.m_OutOfFlowChildren.clear();
+        if (!placementValid)
+            m_Memo.Areas.assign(m_Container.m_Children.size(), {});
+        for (auto &child: m_Container.m_Children) {
+            const auto &dim = child->GetStyle().GetDimensions();
+            if (dim.Display == OuterDisplay::None)
+                continue;
+            if (IsOutOfFlow(dim.Position)) {
+                if (layoutRun)
+                    m_Container.m_OutOfFlowChildren.push_back(child.get());
+                continue;
+            }
+            m_Items.Append(child.get());
+            Area(child.get()).InFlow = true;
+        }
+    }
+
+    [[nodiscard]] bool Fits(const std::size_t row, const std::size_t column, const std::size_t rowSpan,
+                            const std::size_t columnSpan) const {
+        if (column + columnSpan > m_ColumnCount)
+            return false;
+        const std::size_t rowEnd = std::min(row + rowSpan, m_RowCount);
+        for (std::size_t r = row; r < rowEnd; ++r)
+            for (std::size_t c = column; c < column + columnSpan; ++c)
+                if (m_Memo.Occupied[r * m_ColumnCount + c])
+                    return false;
+        return true;
+    }
+
+    void Occupy(Node *item, const std::size_t row, const std::size_t column, const std::size_t rowSpan,
+                const std::size_t columnSpan) {
+        if (row + rowSpan > m_RowCount) {
+            m_RowCount = row + rowSpan;
+            m_Memo.Occupied.resize(m_RowCount * m_ColumnCount, 0);
+        }
+        for (std::size_t r = row; r < row + rowSpan; ++r)
+            for (std::size_t c = column; c < column + columnSpan; ++c)
+                m_Memo.Occupied[r * m_ColumnCount + c] = 1;
+        GridArea &area = Area(item);
+        area.Row = static_cast<std::uint32_t>(row);
+        area.Column = static_cast<std::uint32_t>(column);
+        area.RowSpan = static_cast<std::uint32_t>(rowSpan);
+        area.ColumnSpan = static_cast<std::uint32_t>(columnSpan);
+    }
+
+    /// CSS grid item placement, dense packing excluded: the column count is fixed first (the
+    /// template, widened to every explicit column end and span), items locked to a row go
+    /// first, then the rest follow one cursor in row-major order, adding implicit rows.
+    void PlaceItems() {
+        const std::size_t itemCount = m_Items.Count();
+        m_ColumnCount = std::max<std::size_t>(m_Grid.TemplateColumns.Size(), 1);
+        for (std::size_t i = 0; i < itemCount; ++i) {
+            const CSSGrid &g = m_Items[i]->GetStyle().GetGrid();
+            const std::size_t span = std::max<std::int16_t>(g.ColumnSpan, 1);
+            const std::size_t start = g.ColumnStart > 0 ? static_cast<std::size_t>(g.ColumnStart - 1) : 0;
+            m_ColumnCount = std::max(m_ColumnCount, start + span);
+        }
+        m_RowCount = 0;
+        m_Memo.Occupied.clear();
+
+        for (std::size_t i = 0; i < itemCount; ++i) {
+            Node *item = m_Items[i];
+            const CSSGrid &g = item->GetStyle().GetGrid();
+            if (g.RowStart <= 0)
+                continue;
+            const std::size_t row = static_cast<std::size_t>(g.RowStart - 1);
+            const std::size_t rowSpan = std::max<std::int16_t>(g.RowSpan, 1);
+            const std::size_t columnSpan = std::max<std::int16_t>(g.ColumnSpan, 1);
+            std::size_t column = 0;
+            if (g.ColumnStart > 0) {
+                column = static_cast<std::size_t>(g.ColumnStart - 1);
+            } else {
+                while (column + columnSpan <= m_ColumnCount && !Fits(row, column, rowSpan, columnSpan))
+                    ++column;
+                if (column + columnSpan > m_ColumnCount)
+                    column = 0; // the row is full: overlap its start rather than add columns
+            }
+            Occupy(item, row, column, rowSpan, columnSpan);
+        }
+
+        std::size_t cursorRow = 0, cursorColumn = 0;
+        for (std::size_t i = 0; i < itemCount; ++i) {
+            Node *item = m_Items[i];
+            const CSSGrid &g = item->GetStyle().GetGrid();
+            if (g.RowStart > 0)
+                continue;
+            const std::size_t rowSpan = std::max<std::int16_t>(g.RowSpan, 1);
+            const std::size_t columnSpan = std::max<std::int16_t>(g.ColumnSpan, 1);
+            if (g.ColumnStart > 0) {
+                const std::size_t column = static_cast<std::size_t>(g.ColumnStart - 1);
+                if (column < cursorColumn)
+                    ++cursorRow;
+                while (!Fits(cursorRow, column, rowSpan, columnSpan))
+                    ++cursorRow;
+                cursorColumn = column;
+            } else {
+                while (!Fits(cursorRow, cursorColumn, rowSpan, columnSpan)) {
+                    if (++cursorColumn + columnSpan > m_ColumnCount) {
+                        ++cursorRow;
+                        cursorColumn = 0;
+                    }
+                }
+            }
+            Occupy(item, cursorRow, cursorColumn, rowSpan, columnSpan);
+            cursorColumn += columnSpan;
+        }
+
+        m_Memo.Columns.resize(m_ColumnCount);
+        m_Memo.Rows.resize(std::max<std::size_t>(m_Grid.TemplateRows.Size(), m_RowCount));
+    }
+
+    void SizeColumns() {
+        const bool definite = !std::isnan(m_ContentWidth);
+        m_Memo.ColumnsIntrinsic = false;
+        for (std::size_t c = 0; c < m_Memo.Columns.size(); ++c)
+            m_Memo.ColumnsIntrinsic = m_Memo.ColumnsIntrinsic ||
+                                      SizedByItems(TrackAt(m_Grid.TemplateColumns, m_Grid.AutoColumns, c), definite);
+
+        // Max-content contributions, measured only for items in a track sized by its items.
+        const std::size_t itemCount = m_Items.Count();
+        m_Contributions.Resize(itemCount);
+        for (std::size_t i = 0; i < itemCount; ++i) {
+            Node *item = m_Items[i];
+            const GridArea area = Area(item);
+            m_Contributions[i] = NAN;
+            if (!SpansTracksSizedByItems(m_Grid.TemplateColumns, m_Grid.AutoColumns, area.Column,
+                                         area.ColumnSpan, definite))
+                continue;
+            item->LayoutImpl(m_Ctx, NAN, NAN);
+            if (m_Ctx.Yielded)
+                return;
+            const auto &margin = item->GetStyle().GetMargin();
+            m_Contributions[i] = item->GetLayout().ComputedWidth +
+                                 margin.Left.ResolveValue(Reference(m_ContentWidth)) +
+                                 margin.Right.ResolveValue(Reference(m_ContentWidth));
+        }
+
+        SizeTracks(true, m_ContentWidth, m_ColumnGap, m_Memo.Columns);
+        TrackStarts(m_Memo.Columns, m_ColumnGap, m_Memo.ColumnStarts);
+    }
+
+    void SizeRows() {
+        const bool definite = !std::isnan(m_ContentHeight);
+        m_Memo.RowsIntrinsic = false;
+        for (std::size_t r = 0; r < m_Memo.Rows.size(); ++r)
+            m_Memo.RowsIntrinsic = m_Memo.RowsIntrinsic ||
+                                   SizedByItems(TrackAt(m_Grid.TemplateRows, m_Grid.AutoRows, r), definite);
+
+        // Rows size to the items' heights at their column areas' widths.
+        const std::size_t itemCount = m_Items.Count();
+        m_Contributions.Resize(itemCount);
+        for (std::size_t i = 0; i < itemCount; ++i) {
+            Node *item = m_Items[i];
+            const GridArea area = Area(item);
+            m_Contributions[i] = NAN;
+            if (!SpansTracksSizedByItems(m_Grid.TemplateRows, m_Grid.AutoRows, area.Row, area.RowSpan, definite))
+                continue;
+            item->LayoutImpl(m_Ctx, ColumnAreaSize(area), NAN);
+            if (m_Ctx.Yielded)
+                return;
+            const auto &margin = item->GetStyle().GetMargin();
+            m_Contributions[i] = item->GetLayout().ComputedHeight +
+                                 margin.Top.ResolveValue(Reference(m_ContentWidth)) +
+                                 margin.Bottom.ResolveValue(Reference(m_ContentWidth));
+        }
+
+        SizeTracks(false, m_ContentHeight, m_RowGap, m_Memo.Rows);
+        TrackStarts(m_Memo.Rows, m_RowGap, m_Memo.RowStarts);
+    }
+
+    [[nodiscard]] static bool SpansTracksSizedByItems(const GridTemplate &tracks, const GridTrack &implicit,
+                                                      const std::uint32_t start, const std::uint32_t span,
+                                                      const bool definite) {
+        for (std::uint32_t t = start; t < start + span; ++t)
+            if (SizedByItems(TrackAt(tracks, implicit, t), definite))
+                return true;
+        return false;
+    }
+
+    /// Track sizing for one axis, from m_Contributions (NaN for an item that does not
+    /// contribute). Fixed tracks take their size; auto tracks grow to the items that span only
+    /// them and non-flexible tracks (single-span items first, then spanning items share their
+    /// excess equally); fr tracks split the space left over, or on an indefinite axis take the
+    /// largest size per fr any item needs. Auto tracks stretch into leftover space when there
+    /// are no fr tracks. No min-content floors: an fr track may shrink below its items.
+    void SizeTracks(const bool columns, const float contentSize, const float gap, std::vector<float> &sizes) {
+        const GridTemplate &tracks = columns ? m_Grid.TemplateColumns : m_Grid.TemplateRows;
+        const GridTrack &implicit = columns ? m_Grid.AutoColumns : m_Grid.AutoRows;
+        const bool definite = !std::isnan(contentSize);
+        const std::size_t count = sizes.size();
+
+        float totalFr = 0.0f;
+        std::size_t autoCount = 0;
+        for (std::size_t t = 0; t < count; ++t) {
+            const GridTrack track = TrackAt(tracks, implicit, t);
+            sizes[t] = 0.0f;
+            if (track.Unit == GridTrackUnit::Px)
+                sizes[t] = track.Value;
+            else if (track.Unit == GridTrackUnit::Percent && definite)
+                sizes[t] = contentSize * (track.Value / 100.0f);
+            else if (track.Unit == GridTrackUnit::Fr)
+                totalFr += track.Value;
+            else
+                ++autoCount;
+        }
+
+        const std::size_t itemCount = m_Items.Count();
+        float frSize = 0.0f;
+        for (const bool spanning: {false, true}) {
+            for (std::size_t i = 0; i < itemCount; ++i) {
+                const float contribution = m_Contributions[i];
+                if (std::isnan(contribution))
+                    continue;
+                const GridArea area = Area(m_Items[i]);
+                const std::uint32_t start = columns ? area.Column : area.Row;
+                const std::uint32_t span = columns ? area.ColumnSpan : area.RowSpan;
+                if ((span > 1) != spanning)
+                    continue;
+
+                float covered = gap * static_cast<float>(span - 1);
+                float fr = 0.0f;
+                std::size_t growable = 0;
+                for (std::uint32_t t = start; t < start + span; ++t) {
+                    const GridTrack track = TrackAt(tracks, implicit, t);
+                    if (track.Unit == GridTrackUnit::Fr) {
+                        fr += track.Value;
+                    } else {
+                        covered += sizes[t];
+                        growable += SizedByItems(track, definite) ? 1 : 0;
+                    }
+                }
+                const float excess = contribution - covered;
+                if (excess <= 0.0f)
+                    continue;
+                if (fr > 0.0f) {
+                    if (!definite)
+                        frSize = std::max(frSize, excess / fr);
+                    continue;
+                }
+                for (std::uint32_t t = start; growable > 0 && t < start + span; ++t)
+                    if (SizedByItems(TrackAt(tracks, implicit, t), definite))
+                        sizes[t] += excess / static_cast<float>(growable);
+            }
+        }
+
+        float used = gap * static_cast<float>(count > 0 ? count - 1 : 0);
+        for (std::size_t t = 0; t < count; ++t)
+            used += sizes[t];
+        const float freeSpace = definite ? contentSize - used : 0.0f;
+
+        if (totalFr > 0.0f) {
+            if (definite)
+                frSize = std::max(0.0f, freeSpace) / std::max(totalFr, 1.0f);
+            for (std::size_t t = 0; t < count; ++t) {
+                const GridTrack track = TrackAt(tracks, implicit, t);
+                if (track.Unit == GridTrackUnit::Fr)
+                    sizes[t] = frSize * track.Value;
+            }
+        } else if (freeSpace > 0.0f && autoCount > 0) {
+            for (std::size_t t = 0; t < count; ++t)
+                if (TrackAt(tracks, implicit, t).Unit == GridTrackUnit::Auto)
+                    sizes[t] += freeSpace / static_cast<float>(autoCount);
+        }
+    }
+
+    /// An axis sized by its tracks takes their total, plus padding and border.
+    void ResolveContainerSize() {
+        const auto total = [](const std::vector<float> &sizes, const std::vector<float> &starts) {
+            return sizes.empty() ? 0.0f : starts.back() + sizes.back();
+        };
+        if (std::isnan(m_ContentWidth))
+            m_Layout.ComputedWidth = total(m_Memo.Columns, m_Memo.ColumnStarts) + m_PbRow;
+        if (std::isnan(m_ContentHeight))
+            m_Layout.ComputedHeight = total(m_Memo.Rows, m_Memo.RowStarts) + m_PbCol;
+    }
+
+    /// Lay out every item in its area: an AUTO size stretches to the area less the margins,
+    /// an explicit one sits at the area's start. A percentage height in content-sized rows had
+    /// no definite height to resolve against and behaves as AUTO.
+    void LayoutItems() {
+        const std::size_t itemCount = m_Items.Count();
+        const float marginReference = Reference(m_ContentWidth);
+        for (std::size_t i = 0; i < itemCount; ++i) {
+            Node *item = m_Items[i]; // re-indexed: the solves below grow the arena
+            const GridArea area = Area(item);
+            const float areaWidth = ColumnAreaSize(area);
+            const float areaHeight = AreaSize(m_Memo.Rows, m_Memo.RowStarts, area.Row, area.RowSpan);
+
+            // The same inputs as the row measurement, so a measured item replays its solve.
+            item->LayoutImpl(m_Ctx, areaWidth, m_Memo.RowsIntrinsic ? NAN : areaHeight);
+            if (m_Ctx.Yielded)
+                return;
+
+            const auto &itemStyle = item->GetStyle();
+            const auto &margin = itemStyle.GetMargin();
+            const float left = margin.Left.ResolveValue(marginReference);
+            const float top = margin.Top.ResolveValue(marginReference);
+            auto &itemLayout = item->GetLayout();
+            if (itemStyle.GetDimensions().Width.Unit == CSSUnit::Auto)
+                itemLayout.ComputedWidth = std::max(
+                    0.0f, areaWidth - left - margin.Right.ResolveValue(marginReference));
+            const auto &height = itemStyle.GetDimensions().Height;
+            if (height.Unit == CSSUnit::Auto || (m_Memo.RowsIntrinsic && height.HasPercentage()))
+                itemLayout.ComputedHeight = std::max(
+                    0.0f, areaHeight - top - margin.Bottom.ResolveValue(marginReference));
+            itemLayout.LocalX = m_OriginX + m_Memo.ColumnStarts[area.Column] + left;
+            itemLayout.LocalY = m_OriginY + m_Memo.RowStarts[area.Row] + top;
+            item->LayoutContentsWithDefiniteSize(m_Ctx, itemLayout.ComputedWidth, itemLayout.ComputedHeight);
+            if (m_Ctx.Yielded)
+                return;
+        }
+    }
+
+    [[nodiscard]] float ColumnAreaSize(const GridArea &area) const {
+        return AreaSize(m_Memo.Columns, m_Memo.ColumnStarts, area.Column, area.ColumnSpan);
+    }
+
+    [[nodiscard]] GridArea &Area(const Node *child) const {
+        return m_Memo.Areas[child->m_indexInParent];
+    }
+
+    Node &m_Container;
+    LayoutContext &m_Ctx;
+    Style &m_Style;
+    ::Layout &m_Layout;
+    const CSSGrid &m_Grid;
+    GridMemo &m_Memo;
+    ArenaSlice<Node *> m_Items;
+    ArenaSlice<float> m_Contributions;
+    const float m_AvailableWidth;
+    const float m_AvailableHeight;
+    float m_ContentWidth = NAN;
+    float m_ContentHeight = NAN;
+    float m_PbRow = 0, m_PbCol = 0;
+    float m_OriginX = 0, m_OriginY = 0;
+    float m_ColumnGap = 0, m_RowGap = 0;
+    std::size_t m_ColumnCount = 0;
+    std::size_t m_RowCount = 0;
+};
+
+void GridLayoutStrategy::Layout(Node &container, LayoutContext &ctx,
+                                const float availableWidth, const float availableHeight) const {
+    MASHARIF_LAYOUT_PHASE(ctx, LayoutPhase::GridStrategy);
+    const TraceSlice trace(ctx, TraceSliceKind::Strategy, static_cast<std::uint8_t>(LayoutPhase::GridStrategy),
+                           &container, availableWidth, availableHeight);
+    Solver(container, ctx, availableWidth, availableHeight).Run();
+}
+
+float GridLayoutStrategy::IntrinsicContentSize(Node &container, const IntrinsicSizing sizing,
+                                               const LayoutAxis axis) const {
+    LayoutContext ctx; // scratch only: the items are not laid out
+    return Solver(container, ctx, NAN, NAN).IntrinsicSize(sizing, axis);
+}
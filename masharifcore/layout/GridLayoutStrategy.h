@@ -0,0 +1,22 @@
+#pragma once
+
+#include "LayoutStrategy.h"
+
+namespace masharif {
+    /// CSS grid: grid-template-rows/columns with px, %, fr and auto tracks, implicit tracks
+    /// past the template, line-based or automatic (sparse, row-major) placement, and gaps.
+    /// Placement and track sizes are memoized on the container (Node::GridMemo).
+    class GridLayoutStrategy final : public LayoutStrategy {
+    public:
+        void Layout(Node &container, LayoutContext &ctx,
+                    float availableWidth, float availableHeight) const override;
+
+        [[nodiscard]] float IntrinsicContentSize(Node &container, IntrinsicSizing sizing,
+                                                 LayoutAxis axis) const override;
+
+    private:
+        /// One grid solve for one container; defined in the .cpp. Nested so it shares this
+        /// strategy's friend access to Node ([class.access.nest]).
+        class Solver;
+    };
+}
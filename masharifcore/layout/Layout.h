@@ -23,4 +23,37 @@ namespace masharif {
         /// behaviour independent of wall-clock noise.
         std::uint32_t StrategyRuns = 0;
     };
+
+    /// Axis of an intrinsic size query (Node::GetIntrinsicSize).
+    enum class LayoutAxis : std::uint8_t { Horizontal, Vertical };
+
+    /// CSS intrinsic sizing constraint: MinContent takes every soft wrap opportunity (each
+    /// inline-level box on its own line, a wrapping flex container one item per line),
+    /// MaxContent none.
+    enum class IntrinsicSizing : std::uint8_t { MinContent, MaxContent };
+
+    /// Absolute border box of a node in the last completed frame (Node::GetPublishedBox).
+    struct LayoutBox {
+        float X = 0;
+        float Y = 0;
+        float Width = 0;
+        float Height = 0;
+    };
+
+    /// Progress of a time-sliced frame (Node::CalculateFor).
+    struct LayoutProgress {
+        bool Done = false;
+        std::uint32_t Slices = 0; ///< CalculateFor calls spent on the frame so far
+        std::uint64_t Solves = 0; ///< layout strategy runs completed for it so far
+    };
+
+    /// Viewport passed to Node::Calculate, in the root's coordinate space. ContentVisibility::Auto
+    /// subtrees within Margin of it are laid out; the others keep their placeholder size.
+    struct ViewportRect {
+        float X = 0;
+        float Y = 0;
+        float Width = 0;
+        float Height = 0;
+        float Margin = 0;
+    };
 }
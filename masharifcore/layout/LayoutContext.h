@@ -1,9 +1,17 @@
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <optional>
 #include <vector>
 
+#include "Layout.h"
+#include "LayoutProfile.h"
+#include "LayoutStats.h"
+#include "LayoutTrace.h"
+
 namespace masharif {
     class Node;
 
@@ -61,25 +69,49 @@ namespace masharif {
         std::size_t m_Base;
     };
 
-    /// Per-solve scratch shared by every strategy run of one layout pass. Created on the
-    /// stack by the public entry points and threaded by reference through the recursion;
-    /// capacities stay warm for the whole solve, so steady-state layout does not allocate.
-    struct LayoutContext {
-        /// Warm the scratch arenas so the first solve of a frame does not pay a geometric
-        /// reallocation series as items/lines are appended. Capacity-only — never changes
-        /// size(), so every ArenaSlice base offset and the re-indexing rule are unaffected
-        /// (it can only reduce reallocations, never introduce one).
-        LayoutContext() {
+    /// The flat scratch arenas of one thread. Every LayoutContext of the thread borrows them,
+    /// so their capacities survive from frame to frame: once a tree shape has been solved, its
+    /// steady-state frames do not allocate. Contexts nested on the stack (a Calculate from
+    /// inside a layout callback) share them safely, because every user is an ArenaSlice that
+    /// truncates back to its base.
+    struct LayoutArenas {
+        /// Warm the arenas so the first solve does not pay a geometric reallocation series as
+        /// items/lines are appended. Capacity-only: it never changes size(), so ArenaSlice base
+        /// offsets and the re-indexing rule are unaffected.
+        LayoutArenas() {
             InFlowItems.reserve(64);
             Lines.reserve(8);
             BaseSizes.reserve(64);
             Frozen.reserve(64);
         }
 
+        [[nodiscard]] static LayoutArenas &ForThread() noexcept {
+            thread_local LayoutArenas arenas;
+            return arenas;
+        }
+
         std::vector<Node *> InFlowItems;
         std::vector<FlexLine> Lines;
         std::vector<float> BaseSizes;
         std::vector<std::uint8_t> Frozen;
+    };
+
+    /// Per-solve scratch shared by every strategy run of one layout pass. Created on the
+    /// stack by the public entry points and threaded by reference through the recursion; the
+    /// arenas are the thread's (LayoutArenas), so steady-state layout does not allocate.
+    struct LayoutContext {
+        explicit LayoutContext(LayoutArenas &arenas = LayoutArenas::ForThread()) noexcept
+            : InFlowItems(arenas.InFlowItems), Lines(arenas.Lines), BaseSizes(arenas.BaseSizes),
+              Frozen(arenas.Frozen) {
+        }
+
+        LayoutContext(const LayoutContext &) = delete;
+        LayoutContext &operator=(const LayoutContext &) = delete;
+
+        std::vector<Node *> &InFlowItems;
+        std::vector<FlexLine> &Lines;
+        std::vector<float> &BaseSizes;
+        std::vector<std::uint8_t> &Frozen;
 
         /// Innermost enclosing scroll port on the current StartUpdatingPositions descent and
         /// its offset, threaded (save/restore) down the walk so a sticky descendant pins
@@ -89,5 +121,193 @@ namespace masharif {
         float ScrollPortOffsetX = 0.0f;
         float ScrollPortOffsetY = 0.0f;
         bool ForcePin = false;
+
+        /// Viewport of a Calculate(…, viewport) frame (ViewportBounded); without one every
+        /// content-visibility:auto subtree counts as near it. ViewportMoved forces the gated walk
+        /// to every auto subtree to re-decide; Revealed is raised when the walk dirtied a skipped
+        /// subtree that came near, so the frame needs another pass.
+        ViewportRect Viewport;
+        bool ViewportBounded = false;
+        bool ViewportMoved = false;
+        bool Revealed = false;
+
+        /// A progressive frame (Node::CalculateVisibleFirst): block boxes in normal flow are
+        /// deferred like content-visibility:auto ones while away from the viewport.
+        bool DeferOffscreen = false;
+
+        /// Frame deadline of a time-sliced solve (Node::CalculateFor), whose root is SlicedRoot.
+        /// Checked before every DeadlineStride-th real solve while YieldBlocked is zero (a virtual
+        /// list's window swap raises it: YieldBlockScope). Past the deadline the solve about to
+        /// start raises Yielded instead; every LayoutImpl call on the way out queues itself on
+        /// the root's frame without recording a result, and every strategy returns as soon as a
+        /// child's solve comes back Yielded.
+        static constexpr std::uint32_t DeadlineStride = 32;
+        bool HasDeadline = false;
+        std::chrono::steady_clock::time_point Deadline;
+        std::uint32_t DeadlineCountdown = DeadlineStride;
+        std::uint32_t YieldBlocked = 0;
+        bool Yielded = false;
+        Node *SlicedRoot = nullptr;
+
+        /// Strategy runs performed by LayoutImpl in this context (progress of a sliced solve).
+        std::uint64_t Solves = 0;
+
+        /// Reuse checks of this solve (Node::CountCache), published on the root at its end.
+        CacheStats Cache;
+
+        /// The thread's LayoutTracer when one records (taken at the start of the solve), and the
+        /// innermost open slice, which a reuse check reports its verdict to.
+        LayoutTracer *Tracer = nullptr;
+        class TraceSlice *OpenSlice = nullptr;
+
+        /// The thread's LayoutProfiler when one profiles, and the innermost open ProfileScope.
+        LayoutProfiler *Profiler = nullptr;
+        class ProfileScope *OpenProfile = nullptr;
+
+#ifdef MASHARIF_LAYOUT_STATS
+        /// Where MASHARIF_LAYOUT_PHASE sections accumulate (the root's stats), the innermost
+        /// open section, and how many sections of each phase are open (for inclusive time).
+        LayoutStats *Stats = nullptr;
+        class PhaseScope *OpenPhase = nullptr;
+        std::array<std::uint32_t, static_cast<std::size_t>(LayoutPhase::Count)> OpenPhases{};
+#endif
+    };
+
+    /// Holds off a time-sliced solve's yield for the enclosing block (LayoutContext::YieldBlocked).
+    class YieldBlockScope {
+    public:
+        explicit YieldBlockScope(LayoutContext &ctx) noexcept : m_ctx(ctx) { ++ctx.YieldBlocked; }
+
+        ~YieldBlockScope() { --m_ctx.YieldBlocked; }
+
+        YieldBlockScope(const YieldBlockScope &) = delete;
+        YieldBlockScope &operator=(const YieldBlockScope &) = delete;
+
+    private:
+        LayoutContext &m_ctx;
     };
+
+    /// One LayoutTracer slice over the enclosing block; nothing when the solve is not traced.
+    class TraceSlice {
+    public:
+        TraceSlice(LayoutContext &ctx, const TraceSliceKind kind, const std::uint8_t detail,
+                   const Node *node = nullptr, const float width = 0, const float height = 0) noexcept
+            : m_ctx(ctx), m_node(node), m_outer(ctx.OpenSlice) {
+            if (!ctx.Tracer)
+                return;
+            m_slice = ctx.Tracer->Begin(kind, detail, node, width, height);
+            ctx.OpenSlice = this;
+        }
+
+        ~TraceSlice() {
+            if (!m_slice)
+                return;
+            m_ctx.OpenSlice = m_outer;
+            m_ctx.Tracer->End(m_slice);
+        }
+
+        TraceSlice(const TraceSlice &) = delete;
+        TraceSlice &operator=(const TraceSlice &) = delete;
+
+        /// Record what `node`'s reuse check decided, if this is that node's slice.
+        void Verdict(const Node *node, const CacheEvent event) const noexcept {
+            if (node == m_node)
+                m_ctx.Tracer->SetDetail(m_slice, static_cast<std::uint8_t>(event));
+        }
+
+    private:
+        LayoutContext &m_ctx;
+        const Node *m_node;
+        TraceSlice *m_outer;
+        std::uint64_t m_slice = 0; ///< 0 when not traced
+    };
+
+    /// One node's LayoutImpl call or definite-size pass, charged to the LayoutProfiler: its
+    /// time minus the calls nested in it, and the strategy runs it added to the node.
+    class ProfileScope {
+    public:
+        ProfileScope(LayoutContext &ctx, const Node *node, const std::uint32_t &strategyRuns) noexcept
+            : m_ctx(ctx), m_strategyRuns(strategyRuns) {
+            if (!ctx.Profiler)
+                return;
+            m_node = node;
+            m_runsBefore = strategyRuns;
+            m_outer = ctx.OpenProfile;
+            ctx.OpenProfile = this;
+            m_start = std::chrono::steady_clock::now();
+        }
+
+        ~ProfileScope() {
+            if (!m_node)
+                return;
+            const auto elapsed = std::chrono::steady_clock::now() - m_start;
+            m_ctx.OpenProfile = m_outer;
+            if (m_outer)
+                m_outer->m_nested += elapsed;
+            m_ctx.Profiler->Record(m_node, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed - m_nested),
+                                   m_strategyRuns - m_runsBefore);
+        }
+
+        ProfileScope(const ProfileScope &) = delete;
+        ProfileScope &operator=(const ProfileScope &) = delete;
+
+    private:
+        LayoutContext &m_ctx;
+        const std::uint32_t &m_strategyRuns;
+        const Node *m_node = nullptr; ///< null when not profiled
+        std::uint32_t m_runsBefore = 0;
+        ProfileScope *m_outer = nullptr;
+        std::chrono::steady_clock::time_point m_start;
+        std::chrono::steady_clock::duration m_nested{0};
+    };
+
+#ifdef MASHARIF_LAYOUT_STATS
+    /// One timed section (MASHARIF_LAYOUT_PHASE). Its time is charged to the phase, minus what
+    /// the sections nested inside it took for the exclusive time. A traced solve also gets a
+    /// slice per flex solver phase (the strategies and the positions walk trace themselves in
+    /// every build).
+    class PhaseScope {
+    public:
+        PhaseScope(LayoutContext &ctx, const LayoutPhase phase) noexcept
+            : m_ctx(ctx), m_phase(phase), m_outer(ctx.OpenPhase), m_start(std::chrono::steady_clock::now()) {
+            if (phase < LayoutPhase::FlexStrategy)
+                m_slice.emplace(ctx, TraceSliceKind::Phase, static_cast<std::uint8_t>(phase));
+            ctx.OpenPhase = this;
+            ++ctx.OpenPhases[static_cast<std::size_t>(phase)];
+        }
+
+        ~PhaseScope() {
+            const auto elapsed = std::chrono::steady_clock::now() - m_start;
+            m_ctx.OpenPhase = m_outer;
+            if (m_outer)
+                m_outer->m_nested += elapsed;
+            const bool outermost = --m_ctx.OpenPhases[static_cast<std::size_t>(m_phase)] == 0;
+            if (!m_ctx.Stats)
+                return;
+            PhaseStats &stats = (*m_ctx.Stats)[m_phase];
+            ++stats.Calls;
+            stats.Exclusive += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed - m_nested);
+            if (outermost)
+                stats.Inclusive += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed);
+        }
+
+        PhaseScope(const PhaseScope &) = delete;
+        PhaseScope &operator=(const PhaseScope &) = delete;
+
+    private:
+        LayoutContext &m_ctx;
+        const LayoutPhase m_phase;
+        PhaseScope *m_outer;
+        const std::chrono::steady_clock::time_point m_start;
+        std::chrono::steady_clock::duration m_nested{0};
+        std::optional<TraceSlice> m_slice;
+    };
+
+#define MASHARIF_LAYOUT_PHASE_CONCAT(a, b) a##b
+#define MASHARIF_LAYOUT_PHASE_NAME(line) MASHARIF_LAYOUT_PHASE_CONCAT(masharifPhase, line)
+/// Time the rest of the enclosing block as `phase` (LayoutStats).
+#define MASHARIF_LAYOUT_PHASE(ctx, phase) const ::masharif::PhaseScope MASHARIF_LAYOUT_PHASE_NAME(__LINE__)(ctx, phase)
+#else
+#define MASHARIF_LAYOUT_PHASE(ctx, phase) static_cast<void>(0)
+#endif
 }
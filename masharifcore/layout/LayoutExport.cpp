@@ -0,0 +1,142 @@
+#include "LayoutExport.h"
+
+#include "Node.h"
+
+#include <atomic>
+#include <new>
+
+using namespace masharif;
+
+namespace {
+    constexpr std::size_t RegionAlignment = 16;
+
+    std::size_t AlignUp(const std::size_t offset) {
+        return (offset + RegionAlignment - 1) / RegionAlignment * RegionAlignment;
+    }
+
+    /// Offsets of the arrays in a region; the last one is the region size.
+    struct RegionLayout {
+        std::size_t Absolute = 0, Local = 0, Parent = 0, Changed = 0, End = 0;
+    };
+
+    RegionLayout LayOut(const std::size_t capacity, const std::uint32_t fields) {
+        RegionLayout layout;
+        std::size_t offset = AlignUp(sizeof(LayoutExporter::RegionHeader));
+        auto take = [&](std::size_t &at, const std::size_t bytes) {
+            at = offset;
+            offset = AlignUp(offset + bytes);
+        };
+        if (fields & LayoutExporter::AbsoluteRects)
+            take(layout.Absolute, capacity * sizeof(LayoutBox));
+        if (fields & LayoutExporter::LocalRects)
+            take(layout.Local, capacity * sizeof(LayoutBox));
+        take(layout.Parent, capacity * sizeof(std::uint32_t));
+        take(layout.Changed, capacity * sizeof(std::uint32_t));
+        layout.End = offset;
+        return layout;
+    }
+
+    /// Seqlock writer side: Sequence is odd from Begin to End, so a reader in another process
+    /// that sees the same even value before and after copying got a consistent export.
+    class WriteScope {
+    public:
+        explicit WriteScope(std::uint64_t &sequence) : m_sequence(sequence) {
+            m_sequence.store(m_sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        ~WriteScope() {
+            m_sequence.store(m_sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        WriteScope(const WriteScope &) = delete;
+        WriteScope &operator=(const WriteScope &) = delete;
+
+    private:
+        std::atomic_ref<std::uint64_t> m_sequence;
+    };
+}
+
+std::size_t LayoutExporter::RegionSize(const std::size_t capacity, const std::uint32_t fields) {
+    return LayOut(capacity, fields).End;
+}
+
+LayoutExporter::LayoutExporter(void *region, const std::size_t capacity, const std::uint32_t fields)
+    : m_header(new(region) RegionHeader{}) {
+    const RegionLayout layout = LayOut(capacity, fields);
+    m_header->Version = Version;
+    m_header->Fields = fields;
+    m_header->Capacity = static_cast<std::uint32_t>(capacity);
+    m_header->AbsoluteOffset = static_cast<std::uint32_t>(layout.Absolute);
+    m_header->LocalOffset = static_cast<std::uint32_t>(layout.Local);
+    m_header->ParentOffset = static_cast<std::uint32_t>(layout.Parent);
+    m_header->ChangedOffset = static_cast<std::uint32_t>(layout.Changed);
+}
+
+void LayoutExporter::WriteEntry(const Node &node, const std::uint32_t index) {
+    const LayoutBox &box = node.m_published;
+    if (LayoutBox *absolute = Array<LayoutBox>(m_header->AbsoluteOffset))
+        absolute[index] = box;
+    if (LayoutBox *local = Array<LayoutBox>(m_header->LocalOffset))
+        local[index] = {node.m_publishedLocalX, node.m_publishedLocalY, box.Width, box.Height};
+}
+
+bool LayoutExporter::Export(Node &root) {
+    WriteScope write(m_header->Sequence);
+    std::uint32_t *changed = Array<std::uint32_t>(m_header->ChangedOffset);
+    m_stack.clear();
+    m_stack.push_back(&root);
+
+    const bool full = &root != m_root || Node::StructureChanges() != m_structureChanges;
+    if (!full) {
+        // Only where the walk left something to export.
+        std::uint32_t count = 0;
+        while (!m_stack.empty()) {
+            Node *node = m_stack.back();
+            m_stack.pop_back();
+            if (node->m_exportPending) {
+                WriteEntry(*node, node->m_exportIndex);
+                changed[count++] = node->m_exportIndex;
+                node->m_exportPending = false;
+            }
+            if (!node->m_exportPendingInSubtree)
+                continue;
+            node->m_exportPendingInSubtree = false;
+            for (const auto &child : node->m_Children)
+                m_stack.push_back(child.get());
+        }
+        m_header->ChangedCount = count;
+        m_header->FullExport = 0;
+        return true;
+    }
+
+    // Re-index: pre-order, children in order (pushed reversed).
+    std::uint32_t *parents = Array<std::uint32_t>(m_header->ParentOffset);
+    const std::uint32_t capacity = m_header->Capacity;
+    std::uint32_t count = 0;
+    m_root = nullptr;
+    while (!m_stack.empty()) {
+        Node *node = m_stack.back();
+        m_stack.pop_back();
+        if (count == capacity) {
+            m_header->NodeCount = m_header->ChangedCount = 0;
+            m_header->FullExport = 1;
+            return false;
+        }
+        const std::uint32_t index = count++;
+        node->m_exportIndex = index;
+        parents[index] = node == &root ? NoParent : node->m_Parent->m_exportIndex;
+        WriteEntry(*node, index);
+        changed[index] = index;
+        node->m_exportPending = node->m_exportPendingInSubtree = false;
+        const auto &children = node->m_Children;
+        for (auto it = children.rbegin(); it != children.rend(); ++it)
+            m_stack.push_back(it->get());
+    }
+    m_header->NodeCount = count;
+    m_header->ChangedCount = count;
+    m_header->FullExport = 1;
+    m_root = &root;
+    m_structureChanges = Node::StructureChanges();
+    return true;
+}
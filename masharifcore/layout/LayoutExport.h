@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Layout.h"
+
+namespace masharif {
+    class Node;
+
+    /// Writes a solved tree's boxes into a flat, caller-provided region: one entry per node in
+    /// depth-first pre-order, so a node's index is stable for as long as no child list in the
+    /// tree changes. The region holds no pointers and describes its own layout, so it can be
+    /// shared memory read by another process.
+    ///
+    /// After the first export only the entries whose published box changed since the last one
+    /// are rewritten (and listed in the changed array); the search for them follows flags the
+    /// positions walk sets, so an idle frame exports in O(1). Any child-list change re-indexes
+    /// and rewrites everything. Entries hold GetPublishedBox(), so a CalculateFor frame still
+    /// in progress is never exported half-done; a display:none subtree keeps its last boxes.
+    ///
+    /// One exporter per tree: the entry indices are kept on the nodes.
+    class LayoutExporter {
+    public:
+        static constexpr std::uint32_t Version = 1;
+        static constexpr std::uint32_t NoParent = UINT32_MAX;
+
+        enum Fields : std::uint32_t {
+            AbsoluteRects = 1u << 0, ///< the published (absolute) border box
+            LocalRects = 1u << 1, ///< origin relative to the parent's content box, and the size
+        };
+
+        /// Start of the region. The arrays follow at the given byte offsets from the header
+        /// (0 for an absent one), each `Capacity` entries long.
+        struct RegionHeader {
+            std::uint32_t Version;
+            std::uint32_t Fields;
+            std::uint32_t Capacity;
+            std::uint32_t NodeCount; ///< valid entries; 0 after a tree that did not fit
+            std::uint32_t ChangedCount; ///< entries rewritten by the last export, listed in Changed
+            std::uint32_t FullExport; ///< 1 when the last export rewrote (and re-indexed) every entry
+            std::uint64_t Sequence; ///< odd while an export is being written (seqlock)
+            std::uint32_t AbsoluteOffset; ///< LayoutBox[Capacity]
+            std::uint32_t LocalOffset; ///< LayoutBox[Capacity]
+            std::uint32_t ParentOffset; ///< std::uint32_t[Capacity], NoParent for the root
+            std::uint32_t ChangedOffset; ///< std::uint32_t[Capacity]
+        };
+
+        /// Bytes a region for `capacity` nodes needs.
+        [[nodiscard]] static std::size_t RegionSize(std::size_t capacity, std::uint32_t fields = AbsoluteRects);
+
+        /// Lays out `region` (RegionSize(capacity, fields) bytes, 8-byte aligned).
+        LayoutExporter(void *region, std::size_t capacity, std::uint32_t fields = AbsoluteRects);
+
+        /// Export `root`'s tree as laid out by its last completed frame. False, with an empty
+        /// region, when the tree has more nodes than the capacity.
+        bool Export(Node &root);
+
+        [[nodiscard]] const RegionHeader &Header() const noexcept { return *m_header; }
+        [[nodiscard]] const LayoutBox *Absolute() const noexcept { return Array<LayoutBox>(m_header->AbsoluteOffset); }
+        [[nodiscard]] const LayoutBox *Local() const noexcept { return Array<LayoutBox>(m_header->LocalOffset); }
+        [[nodiscard]] const std::uint32_t *Parents() const noexcept { return Array<std::uint32_t>(m_header->ParentOffset); }
+        [[nodiscard]] const std::uint32_t *Changed() const noexcept { return Array<std::uint32_t>(m_header->ChangedOffset); }
+
+    private:
+        template<typename T>
+        T *Array(const std::uint32_t offset) const noexcept {
+            return offset ? reinterpret_cast<T *>(reinterpret_cast<std::uint8_t *>(m_header) + offset) : nullptr;
+        }
+
+        void WriteEntry(const Node &node, std::uint32_t index);
+
+        RegionHeader *m_header;
+        const Node *m_root = nullptr;
+        std::uint64_t m_structureChanges = 0; ///< Node::StructureChanges() at the last full export
+        std::vector<Node *> m_stack; ///< DFS scratch, kept warm
+    };
+}
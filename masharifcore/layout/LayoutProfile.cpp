@@ -0,0 +1,114 @@
+#include "LayoutProfile.h"
+
+#include "Node.h"
+
+#include <algorithm>
+#include <cstdio>
+
+using namespace masharif;
+
+namespace {
+    struct NodeCost {
+        std::chrono::nanoseconds Time{0};
+        std::uint64_t StrategyRuns = 0;
+        std::uint64_t Calls = 0;
+
+        NodeCost &operator+=(const NodeCost &other) {
+            Time += other.Time;
+            StrategyRuns += other.StrategyRuns;
+            Calls += other.Calls;
+            return *this;
+        }
+    };
+
+    struct Attribution {
+        const std::unordered_map<const Node *, NodeCost> &Costs;
+        const std::unordered_map<const Node *, std::string> &Tags;
+        std::unordered_map<std::string, LayoutProfiler::SubtreeCost> ByTag;
+        std::vector<const std::string *> Open; ///< tags of the subtrees enclosing the walk
+
+        /// Cost of `node`'s subtree, charged to its tag unless an enclosing subtree has it.
+        NodeCost Walk(const Node &node, const std::string *tag) {
+            const bool counted = tag && std::none_of(Open.begin(), Open.end(),
+                                                     [&](const std::string *open) { return *open == *tag; });
+            if (counted)
+                Open.push_back(tag);
+            NodeCost subtree;
+            if (const auto own = Costs.find(&node); own != Costs.end())
+                subtree += own->second;
+            for (const auto &child : node.Children()) {
+                const auto childTag = Tags.find(child.get());
+                subtree += Walk(*child, childTag != Tags.end() ? &childTag->second : nullptr);
+            }
+            if (counted) {
+                Open.pop_back();
+                auto &cost = ByTag[*tag];
+                cost.Tag = *tag;
+                cost.Time += subtree.Time;
+                cost.StrategyRuns += subtree.StrategyRuns;
+                cost.Calls += subtree.Calls;
+                cost.Instances += subtree.Calls != 0;
+            }
+            return subtree;
+        }
+    };
+}
+
+LayoutProfiler::LayoutProfiler() {
+    m_samples.reserve(4096);
+    s_active = this;
+}
+
+LayoutProfiler::~LayoutProfiler() {
+    if (s_active == this)
+        s_active = nullptr;
+}
+
+void LayoutProfiler::Tag(const Node &node, std::string tag) {
+    m_tags[&node] = std::move(tag);
+}
+
+void LayoutProfiler::Untag(const Node &node) {
+    m_tags.erase(&node);
+}
+
+void LayoutProfiler::Record(const Node *node, const std::chrono::nanoseconds self, const std::uint64_t strategyRuns) {
+    m_samples.push_back({node, self, strategyRuns});
+}
+
+std::vector<LayoutProfiler::SubtreeCost> LayoutProfiler::Top(const Node &root, const std::size_t count) const {
+    std::unordered_map<const Node *, NodeCost> costs;
+    for (const Sample &sample : m_samples)
+        costs[sample.Target] += NodeCost{sample.Self, sample.StrategyRuns, 1};
+
+    static const std::string rootTag = "root";
+    const auto tag = m_tags.find(&root);
+    Attribution attribution{costs, m_tags, {}, {}};
+    attribution.Walk(root, tag != m_tags.end() ? &tag->second : &rootTag);
+
+    std::vector<SubtreeCost> top;
+    top.reserve(attribution.ByTag.size());
+    for (auto &[name, cost] : attribution.ByTag)
+        if (cost.Instances)
+            top.push_back(std::move(cost));
+    std::sort(top.begin(), top.end(), [](const SubtreeCost &a, const SubtreeCost &b) {
+        return a.Time != b.Time ? a.Time > b.Time : a.Tag < b.Tag;
+    });
+    if (top.size() > count)
+        top.resize(count);
+    return top;
+}
+
+std::string LayoutProfiler::Report(const Node &root, const std::size_t count) const {
+    std::string out = "subtree                          time(us)  strategy runs      calls  instances\n";
+    for (const SubtreeCost &cost : Top(root, count)) {
+        char line[160];
+        const int length = std::snprintf(line, sizeof(line), "%-30.30s %10.1f %14llu %10llu %10u\n",
+                                         cost.Tag.c_str(), static_cast<double>(cost.Time.count()) / 1000.0,
+                                         static_cast<unsigned long long>(cost.StrategyRuns),
+                                         static_cast<unsigned long long>(cost.Calls), cost.Instances);
+        if (length > 0)
+            out.append(line, std::min(static_cast<std::size_t>(length), sizeof(line) - 1));
+    }
+    return out;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace masharif {
+    class Node;
+
+    /// Opt-in cost attribution by subtree: while alive, every LayoutImpl call and definite-size
+    /// pass on the calling thread charges its own time (minus the calls nested in it) and its
+    /// strategy runs to its node. Top then sums those up the tree and ranks the subtrees the
+    /// application tagged, so a slow frame points at a component rather than at the engine.
+    ///
+    /// Tags belong to the profiler, keyed by node address: untag (or Clear) a node before it
+    /// is destroyed if the address may be reused. Samples accumulate until Clear; call it at
+    /// the start of the frame to report that frame alone. One profiler per thread.
+    class LayoutProfiler {
+    public:
+        /// What one tag's subtrees cost. A subtree nested in another of the same tag is counted
+        /// once, as part of the outer one.
+        struct SubtreeCost {
+            std::string Tag;
+            std::chrono::nanoseconds Time{0}; ///< layout time spent inside the subtrees
+            std::uint64_t StrategyRuns = 0;
+            std::uint64_t Calls = 0; ///< LayoutImpl calls and definite-size passes, reuse included
+            std::uint32_t Instances = 0; ///< tagged subtrees that were laid out
+        };
+
+        LayoutProfiler();
+
+        ~LayoutProfiler();
+
+        LayoutProfiler(const LayoutProfiler &) = delete;
+        LayoutProfiler &operator=(const LayoutProfiler &) = delete;
+
+        /// The profiler of this thread, null when nothing profiles.
+        [[nodiscard]] static LayoutProfiler *Active() noexcept { return s_active; }
+
+        /// Report `node`'s subtree under `tag` (a component name, say).
+        void Tag(const Node &node, std::string tag);
+
+        void Untag(const Node &node);
+
+        /// Drop the samples taken so far; tags stay.
+        void Clear() noexcept { m_samples.clear(); }
+
+        /// The `count` most expensive tagged subtrees of `root`'s tree by time, most expensive
+        /// first. An untagged root is reported as "root", so everything is attributed somewhere.
+        [[nodiscard]] std::vector<SubtreeCost> Top(const Node &root, std::size_t count) const;
+
+        /// Top as a table, one subtree per line.
+        [[nodiscard]] std::string Report(const Node &root, std::size_t count) const;
+
+        /// Hook for the layout recursion: one call's own time and strategy runs.
+        void Record(const Node *node, std::chrono::nanoseconds self, std::uint64_t strategyRuns);
+
+    private:
+        inline static thread_local LayoutProfiler *s_active = nullptr;
+
+        struct Sample {
+            const Node *Target;
+            std::chrono::nanoseconds Self;
+            std::uint64_t StrategyRuns;
+        };
+
+        std::vector<Sample> m_samples;
+        std::unordered_map<const Node *, std::string> m_tags;
+    };
+}
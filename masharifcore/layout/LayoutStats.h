@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace masharif {
+    /// Instrumented sections of a solve: the flex solver's phases, each strategy as a whole and
+    /// the positions walk.
+    enum class LayoutPhase : std::uint8_t {
+        FlexTranslateOnly, ///< FlexLayoutStrategy's single-changed-item fast path
+        FlexCollectAndOrderItems,
+        FlexMeasureItemBases,
+        FlexBuildLine,
+        FlexResolveFlexibleLengths,
+        FlexPositionLineOnMainAxis,
+        FlexAlignLinesOnCrossAxis,
+        FlexRelayoutItemsAtDefiniteSize,
+        FlexStrategy,
+        NormalFlowStrategy,
+        VirtualListStrategy,
+        GridStrategy,
+        PositionsWalk,
+        Count
+    };
+
+    [[nodiscard]] constexpr std::string_view LayoutPhaseName(const LayoutPhase phase) noexcept {
+        constexpr std::array<std::string_view, static_cast<std::size_t>(LayoutPhase::Count)> names{
+            "FlexTranslateOnly", "FlexCollectAndOrderItems", "FlexMeasureItemBases", "FlexBuildLine",
+            "FlexResolveFlexibleLengths", "FlexPositionLineOnMainAxis", "FlexAlignLinesOnCrossAxis",
+            "FlexRelayoutItemsAtDefiniteSize", "FlexStrategy", "NormalFlowStrategy", "VirtualListStrategy",
+            "GridStrategy", "PositionsWalk",
+        };
+        return phase < LayoutPhase::Count ? names[static_cast<std::size_t>(phase)] : "Unknown";
+    }
+
+    struct PhaseStats {
+        std::uint64_t Calls = 0;
+        /// Time inside the section, counting a section nested in itself (a flex item's own
+        /// MeasureItemBases) once.
+        std::chrono::nanoseconds Inclusive{0};
+        /// Inclusive time minus the time of every section nested inside it.
+        std::chrono::nanoseconds Exclusive{0};
+    };
+
+    /// Where the time of the root's last Calculate went (Node::GetLayoutStats). Only a build
+    /// configured with MASHARIF_LAYOUT_STATS collects anything; otherwise the sections compile
+    /// to nothing and Enabled stays false.
+    struct LayoutStats {
+        bool Enabled = false;
+        std::array<PhaseStats, static_cast<std::size_t>(LayoutPhase::Count)> Phases{};
+
+        [[nodiscard]] const PhaseStats &operator[](const LayoutPhase phase) const noexcept {
+            return Phases[static_cast<std::size_t>(phase)];
+        }
+
+        [[nodiscard]] PhaseStats &operator[](const LayoutPhase phase) noexcept {
+            return Phases[static_cast<std::size_t>(phase)];
+        }
+    };
+
+    /// What happened at one of Node's reuse checks: a hit of the full-reuse early-out in
+    /// LayoutImpl, of the within-frame measure cache or of the definite-size memo, or a miss
+    /// (a strategy run) with the reason the check failed.
+    enum class CacheEvent : std::uint8_t {
+        FullReuseHit, ///< clean subtree at the space of its last solve
+        MeasureHit, ///< replayed a solve of this frame with the same inputs
+        DefiniteHit, ///< definite-size pass at the size of the last one
+        LayoutMissDirty, ///< the node's own style changed
+        LayoutMissDescendantDirty, ///< something below the node changed
+        LayoutMissSpaceChanged, ///< clean subtree at a new available space
+        LayoutMissGenerationStale, ///< clean subtree; the measure cache held these inputs from an older frame
+        LayoutMissRingOverflow, ///< the measure cache was full of this frame's entries
+        DefiniteMissDirty, ///< the subtree changed since the last definite pass
+        DefiniteMissSizeChanged, ///< a different definite border box
+        DefiniteMissStrategyRan, ///< an available-space solve ran since the last definite pass
+        RingEviction, ///< recording a solve overwrote a measure cache entry of the same frame
+        Count
+    };
+
+    [[nodiscard]] constexpr std::string_view CacheEventName(const CacheEvent event) noexcept {
+        constexpr std::array<std::string_view, static_cast<std::size_t>(CacheEvent::Count)> names{
+            "FullReuseHit", "MeasureHit", "DefiniteHit", "LayoutMissDirty", "LayoutMissDescendantDirty",
+            "LayoutMissSpaceChanged", "LayoutMissGenerationStale", "LayoutMissRingOverflow", "DefiniteMissDirty",
+            "DefiniteMissSizeChanged", "DefiniteMissStrategyRan", "RingEviction",
+        };
+        return event < CacheEvent::Count ? names[static_cast<std::size_t>(event)] : "Unknown";
+    }
+
+    /// Reuse-check counts of one frame (Node::GetCacheStats for the tree, GetNodeCacheStats
+    /// for one node). Every miss is a strategy run.
+    struct CacheStats {
+        std::array<std::uint64_t, static_cast<std::size_t>(CacheEvent::Count)> Events{};
+
+        [[nodiscard]] std::uint64_t operator[](const CacheEvent event) const noexcept {
+            return Events[static_cast<std::size_t>(event)];
+        }
+
+        [[nodiscard]] std::uint64_t &operator[](const CacheEvent event) noexcept {
+            return Events[static_cast<std::size_t>(event)];
+        }
+
+        [[nodiscard]] std::uint64_t Hits() const noexcept {
+            return (*this)[CacheEvent::FullReuseHit] + (*this)[CacheEvent::MeasureHit] +
+                   (*this)[CacheEvent::DefiniteHit];
+        }
+
+        [[nodiscard]] std::uint64_t Misses() const noexcept {
+            std::uint64_t misses = 0;
+            for (auto event = static_cast<std::size_t>(CacheEvent::LayoutMissDirty);
+                 event <= static_cast<std::size_t>(CacheEvent::DefiniteMissStrategyRan); ++event)
+                misses += Events[event];
+            return misses;
+        }
+    };
+}
@@ -1,14 +1,27 @@
 #include "LayoutStrategy.h"
 
 #include "FlexLayoutStrategy.h"
+#include "GridLayoutStrategy.h"
+#include "Node.h"
 #include "NormalFlowStrategy.h"
+#include "VirtualListStrategy.h"
 
 using namespace masharif;
 
 const LayoutStrategy &LayoutStrategy::For(const OuterDisplay display) noexcept {
     static const FlexLayoutStrategy flex{};
     static const NormalFlowStrategy normalFlow{};
+    static const GridLayoutStrategy grid{};
+    if (InnerLayoutOf(display) == InnerLayout::Grid)
+        return grid;
     if (display == OuterDisplay::Block || display == OuterDisplay::InlineBlock)
         return normalFlow;
     return flex;
 }
+
+const LayoutStrategy &LayoutStrategy::For(const Node &node) noexcept {
+    static const VirtualListStrategy virtualList{};
+    if (node.IsVirtualList())
+        return virtualList;
+    return For(node.GetStyle().GetDimensions().Display);
+}
@@ -2,6 +2,8 @@
 
 #include <masharifcore/structure/BoxInfo.h>
 
+#include "Layout.h"
+
 namespace masharif {
     class Node;
     struct LayoutContext;
@@ -16,8 +18,18 @@ namespace masharif {
         virtual void Layout(Node &container, LayoutContext &ctx,
                             float availableWidth, float availableHeight) const = 0;
 
-        /// The algorithm for a display type: Block/InlineBlock lay out in normal flow,
-        /// everything else as flex.
+        /// Content-box size of `container` on `axis` under a min-content or max-content
+        /// constraint, combined from its children's Node::GetIntrinsicSize as Layout would place
+        /// them. Lays nothing out.
+        [[nodiscard]] virtual float IntrinsicContentSize(Node &container, IntrinsicSizing sizing,
+                                                         LayoutAxis axis) const = 0;
+
+        /// The algorithm for a display type: Block/InlineBlock lay out in normal flow, Grid as
+        /// a grid, everything else as flex.
         [[nodiscard]] static const LayoutStrategy &For(OuterDisplay display) noexcept;
+
+        /// The algorithm for a node: a virtual list lays out its window whatever its display;
+        /// any other node goes by For(display).
+        [[nodiscard]] static const LayoutStrategy &For(const Node &node) noexcept;
     };
 }
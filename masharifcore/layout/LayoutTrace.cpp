@@ -0,0 +1,128 @@
+#include "LayoutTrace.h"
+
+#include <cmath>
+#include <cstdio>
+
+using namespace masharif;
+
+namespace {
+    std::string_view SliceName(const LayoutTracer::Slice &slice) {
+        switch (slice.Kind) {
+            case TraceSliceKind::Frame:
+                return "Calculate";
+            case TraceSliceKind::Layout:
+                return "LayoutImpl";
+            case TraceSliceKind::DefiniteSize:
+                return "LayoutContentsWithDefiniteSize";
+            case TraceSliceKind::Strategy:
+            case TraceSliceKind::Phase:
+                return LayoutPhaseName(static_cast<LayoutPhase>(slice.Detail));
+        }
+        return "Unknown";
+    }
+
+    void Append(std::string &out, const char *format, auto... values) {
+        char buffer[128];
+        const int length = std::snprintf(buffer, sizeof(buffer), format, values...);
+        if (length > 0)
+            out.append(buffer, static_cast<std::size_t>(length) < sizeof(buffer) ? length : sizeof(buffer) - 1);
+    }
+
+    /// JSON has no NaN or infinity: an undefined (AUTO) space is written as null.
+    void AppendSize(std::string &out, const char *name, const float value) {
+        if (std::isfinite(value))
+            Append(out, ",\"%s\":%g", name, static_cast<double>(value));
+        else
+            Append(out, ",\"%s\":null", name);
+    }
+}
+
+LayoutTracer::LayoutTracer(const std::size_t capacity)
+    : m_slices(capacity ? capacity : 1), m_origin(std::chrono::steady_clock::now()) {
+    s_active = this;
+}
+
+LayoutTracer::~LayoutTracer() {
+    if (s_active == this)
+        s_active = nullptr;
+}
+
+std::uint64_t LayoutTracer::Begin(const TraceSliceKind kind, const std::uint8_t detail, const Node *node,
+                                  const float width, const float height) noexcept {
+    const std::uint64_t sequence = m_next++;
+    Slice &slice = m_slices[sequence % m_slices.size()];
+    slice.Sequence = sequence;
+    slice.Kind = kind;
+    slice.Detail = detail;
+    slice.Target = node;
+    slice.Width = width;
+    slice.Height = height;
+    slice.Duration = std::chrono::nanoseconds{-1};
+    slice.Start = std::chrono::steady_clock::now();
+    return sequence;
+}
+
+void LayoutTracer::End(const std::uint64_t slice) noexcept {
+    const auto now = std::chrono::steady_clock::now();
+    // A slice open longer than the ring is deep has been overwritten by the ones nested in it.
+    Slice &at = m_slices[slice % m_slices.size()];
+    if (at.Sequence == slice)
+        at.Duration = std::chrono::duration_cast<std::chrono::nanoseconds>(now - at.Start);
+}
+
+void LayoutTracer::SetDetail(const std::uint64_t slice, const std::uint8_t detail) noexcept {
+    Slice &at = m_slices[slice % m_slices.size()];
+    if (at.Sequence == slice)
+        at.Detail = detail;
+}
+
+void LayoutTracer::Clear() noexcept {
+    m_first = m_next;
+}
+
+std::string LayoutTracer::ToJson() const {
+    std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    const std::uint64_t capacity = m_slices.size();
+    const std::uint64_t oldest = m_next - m_first > capacity ? m_next - capacity : m_first;
+    bool first = true;
+    for (std::uint64_t sequence = oldest; sequence < m_next; ++sequence) {
+        const Slice &slice = m_slices[sequence % capacity];
+        if (slice.Sequence != sequence || slice.Duration.count() < 0)
+            continue;
+        const auto start = std::chrono::duration_cast<std::chrono::nanoseconds>(slice.Start - m_origin);
+        const std::string_view name = SliceName(slice);
+        out += first ? "{" : ",{";
+        first = false;
+        out += "\"name\":\"";
+        out += name;
+        Append(out, "\",\"cat\":\"layout\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f",
+               static_cast<double>(start.count()) / 1000.0, static_cast<double>(slice.Duration.count()) / 1000.0);
+        out += ",\"args\":{";
+        Append(out, "\"node\":\"%p\"", static_cast<const void *>(slice.Target));
+        if (slice.Kind == TraceSliceKind::DefiniteSize) {
+            AppendSize(out, "borderBoxWidth", slice.Width);
+            AppendSize(out, "borderBoxHeight", slice.Height);
+        } else if (slice.Kind != TraceSliceKind::Phase) {
+            AppendSize(out, "availableWidth", slice.Width);
+            AppendSize(out, "availableHeight", slice.Height);
+        }
+        if ((slice.Kind == TraceSliceKind::Layout || slice.Kind == TraceSliceKind::DefiniteSize) &&
+            slice.Detail != NoDetail) {
+            out += ",\"cache\":\"";
+            out += CacheEventName(static_cast<CacheEvent>(slice.Detail));
+            out += '"';
+        }
+        out += "}}";
+    }
+    out += "]}";
+    return out;
+}
+
+bool LayoutTracer::WriteJson(const char *path) const {
+    const std::string json = ToJson();
+    std::FILE *file = std::fopen(path, "wb");
+    if (!file)
+        return false;
+    const bool written = std::fwrite(json.data(), 1, json.size(), file) == json.size();
+    return std::fclose(file) == 0 && written;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "LayoutStats.h"
+
+namespace masharif {
+    class Node;
+
+    /// Kind of a LayoutTracer slice.
+    enum class TraceSliceKind : std::uint8_t {
+        Frame, ///< one Calculate / CalculateFor call on the root
+        Layout, ///< Node::LayoutImpl (Detail: the CacheEvent that decided it)
+        DefiniteSize, ///< Node::LayoutContentsWithDefiniteSize (Detail: its CacheEvent)
+        Strategy, ///< a layout strategy run (Detail: FlexStrategy, NormalFlowStrategy, …)
+        Phase, ///< a flex solver phase or the positions walk (Detail: the LayoutPhase)
+    };
+
+    /// Records the layout passes of the calling thread as trace slices, for a Chrome / Perfetto
+    /// trace viewer (WriteJson): one per Calculate, LayoutImpl call, definite-size pass and
+    /// strategy run, nested as the recursion nests, with the node, the available space and
+    /// which cache served the call. A build with MASHARIF_LAYOUT_STATS adds the flex solver's
+    /// phases.
+    ///
+    /// Slices go into a ring preallocated by the constructor, so tracing allocates nothing and
+    /// a long session keeps its most recent slices. Records while alive; one per thread.
+    class LayoutTracer {
+    public:
+        /// Detail of a slice that has none (a frame, or a call that returned without a cache check:
+        /// display:none, a skipped content-visibility:auto subtree).
+        static constexpr std::uint8_t NoDetail = 0xFF;
+
+        struct Slice {
+            std::uint64_t Sequence = 0; ///< which Begin wrote the slot
+            std::chrono::steady_clock::time_point Start;
+            std::chrono::nanoseconds Duration{-1}; ///< negative while still open
+            const Node *Target = nullptr;
+            float Width = 0, Height = 0;
+            TraceSliceKind Kind = TraceSliceKind::Frame;
+            std::uint8_t Detail = NoDetail;
+        };
+
+        /// Start recording on this thread, keeping up to `capacity` slices.
+        explicit LayoutTracer(std::size_t capacity = 1 << 16);
+
+        ~LayoutTracer();
+
+        LayoutTracer(const LayoutTracer &) = delete;
+        LayoutTracer &operator=(const LayoutTracer &) = delete;
+
+        /// The tracer of this thread, null when nothing records.
+        [[nodiscard]] static LayoutTracer *Active() noexcept { return s_active; }
+
+        /// Open a slice; returns the handle End and SetDetail take.
+        std::uint64_t Begin(TraceSliceKind kind, std::uint8_t detail, const Node *node, float width,
+                            float height) noexcept;
+
+        void End(std::uint64_t slice) noexcept;
+
+        /// Set an open slice's detail (the cache verdict is known only inside the call).
+        void SetDetail(std::uint64_t slice, std::uint8_t detail) noexcept;
+
+        /// Slices begun since construction or Clear, including ones the ring has since dropped.
+        [[nodiscard]] std::uint64_t Count() const noexcept { return m_next - m_first; }
+
+        /// Drop every slice recorded so far.
+        void Clear() noexcept;
+
+        /// The closed slices still in the ring, oldest first, as trace-event JSON.
+        [[nodiscard]] std::string ToJson() const;
+
+        /// ToJson into a file; false if it cannot be written.
+        bool WriteJson(const char *path) const;
+
+    private:
+        inline static thread_local LayoutTracer *s_active = nullptr;
+
+        std::vector<Slice> m_slices;
+        std::uint64_t m_next = 1; ///< sequence of the next Begin (0 marks a slot never written)
+        std::uint64_t m_first = 1; ///< sequence of the first slice since Clear
+        std::chrono::steady_clock::time_point m_origin;
+    };
+}
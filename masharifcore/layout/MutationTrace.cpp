@@ -0,0 +1,439 @@
+#include "MutationTrace.h"
+
+#include "Node.h"
+#include "Snapshot.h"
+#include "TreeBuilder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+using namespace masharif;
+
+namespace {
+    constexpr std::uint32_t TraceMagic = 0x4352544D; // "MTRC"
+
+    struct TraceHeader {
+        std::uint32_t Magic;
+        std::uint32_t Version;
+        std::uint32_t StyleSize; ///< sizeof(TreeBuilder::StyleBlock) of the recording build
+    };
+
+    /// Each operation is its tag followed by fixed-size fields; node ids are u32, 1-based.
+    enum class TraceOp : std::uint8_t {
+        Tree = 1, ///< first id, image size, Snapshot image
+        Style, ///< id, StyleWrites, StyleBlock
+        AddChild, ///< parent, child
+        RemoveChild, ///< parent, child
+        SetChildren, ///< parent, count, ids
+        ClearChildren, ///< parent
+        Display, ///< id, OuterDisplay (the layout-retaining SetDisplay path)
+        Scroll, ///< id, x, y
+        Calculate, ///< id, FrameKind, width, height, ViewportRect, budget in microseconds
+        RootFontSize, ///< id, size
+        Calc, ///< CalcTerms of the next trace-local calc() number
+    };
+
+    /// Node::m_traceStyle bits.
+    enum StyleWrites : std::uint8_t {
+        SizeWrite = 1 << 0, ///< Modify<…>
+        PositionWrite = 1 << 1, ///< ModifyOffsets / ModifyInsets
+    };
+
+    static_assert(std::is_trivially_copyable_v<TreeBuilder::StyleBlock>, "styles are copied as raw bytes");
+}
+
+template<typename T>
+void MutationTrace::Put(const T &value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const auto *bytes = reinterpret_cast<const std::uint8_t *>(&value);
+    m_data.insert(m_data.end(), bytes, bytes + sizeof(T));
+}
+
+MutationTrace::MutationTrace(Node &root) : m_firstId(s_nextId) {
+    Put(TraceHeader{TraceMagic, Version, sizeof(TreeBuilder::StyleBlock)});
+    Adopt(root);
+    s_active = this;
+}
+
+MutationTrace::~MutationTrace() {
+    for (Node *node : m_styled)
+        node->m_traceStyle = 0;
+    s_active = nullptr;
+}
+
+const std::vector<std::uint8_t> &MutationTrace::Data() {
+    FlushStyles();
+    return m_data;
+}
+
+bool MutationTrace::IsKnown(const Node &node) const noexcept {
+    return node.m_traceId >= m_firstId;
+}
+
+void MutationTrace::Adopt(Node &root) {
+    const std::vector<std::uint8_t> image = Snapshot::Save(root);
+    Put(TraceOp::Tree);
+    Put(s_nextId - m_firstId + 1);
+    Put(static_cast<std::uint32_t>(image.size()));
+    m_data.insert(m_data.end(), image.begin(), image.end());
+
+    std::vector<Node *> stack{&root};
+    while (!stack.empty()) {
+        Node *node = stack.back();
+        stack.pop_back();
+        node->m_traceId = s_nextId++;
+        for (auto it = node->m_Children.rbegin(); it != node->m_Children.rend(); ++it)
+            stack.push_back(it->get());
+    }
+}
+
+std::uint32_t MutationTrace::Known(Node &node) {
+    if (!IsKnown(node))
+        Adopt(node);
+    return node.m_traceId - m_firstId + 1;
+}
+
+void MutationTrace::FlushStyles() {
+    for (Node *node : m_styled) {
+        const Style &style = node->m_Style;
+        TreeBuilder::StyleBlock block{style.GetDimensions(), style.GetFlex(), style.GetMargin(), style.GetPadding(),
+                                      style.GetBorder(), style.GetOffsets(), style.GetGrid()};
+        // calc() ids are this process's: record each expression once, ahead of its first use,
+        // and refer to it by its trace-local number.
+        ForEachLength(block.Dimensions, block.Flex, block.Margin, block.Padding, block.Border, block.Offsets,
+                      [&](CSSValue &value) {
+                          if (value.Unit != CSSUnit::Calc)
+                              return;
+                          const auto [it, added] = m_calcIndex.try_emplace(
+                              static_cast<std::uint32_t>(value.Value), static_cast<std::uint32_t>(m_calcIndex.size()));
+                          if (added) {
+                              Put(TraceOp::Calc);
+                              Put(value.Terms());
+                          }
+                          value.Value = static_cast<float>(it->second);
+                      });
+        Put(TraceOp::Style);
+        Put(Known(*node));
+        Put(node->m_traceStyle);
+        Put(block);
+        node->m_traceStyle = 0;
+    }
+    m_styled.clear();
+}
+
+void MutationTrace::OnStyle(Node &node, const bool positionOnly) {
+    if (!IsKnown(node))
+        return;
+    if (!node.m_traceStyle)
+        m_styled.push_back(&node);
+    node.m_traceStyle |= positionOnly ? PositionWrite : SizeWrite;
+}
+
+void MutationTrace::OnAddChild(Node &parent, Node &child) {
+    if (!IsKnown(parent))
+        return;
+    FlushStyles();
+    const std::uint32_t childId = Known(child);
+    Put(TraceOp::AddChild);
+    Put(Known(parent));
+    Put(childId);
+}
+
+void MutationTrace::OnRemoveChild(Node &parent, Node &child) {
+    if (!IsKnown(parent) || !IsKnown(child))
+        return;
+    FlushStyles();
+    Put(TraceOp::RemoveChild);
+    Put(Known(parent));
+    Put(Known(child));
+}
+
+void MutationTrace::OnSetChildren(Node &parent) {
+    if (!IsKnown(parent))
+        return;
+    FlushStyles();
+    // New children are embedded first, so the operation itself is only ids.
+    std::vector<std::uint32_t> ids;
+    ids.reserve(parent.m_Children.size());
+    for (const auto &child : parent.m_Children)
+        ids.push_back(Known(*child));
+    Put(TraceOp::SetChildren);
+    Put(Known(parent));
+    Put(static_cast<std::uint32_t>(ids.size()));
+    for (const std::uint32_t id : ids)
+        Put(id);
+}
+
+void MutationTrace::OnClearChildren(Node &parent) {
+    if (!IsKnown(parent))
+        return;
+    FlushStyles();
+    Put(TraceOp::ClearChildren);
+    Put(Known(parent));
+}
+
+void MutationTrace::OnSetDisplay(Node &node, const OuterDisplay display) {
+    if (!IsKnown(node))
+        return;
+    FlushStyles();
+    Put(TraceOp::Display);
+    Put(Known(node));
+    Put(display);
+}
+
+void MutationTrace::OnScroll(Node &node, const float x, const float y) {
+    if (!IsKnown(node))
+        return;
+    FlushStyles();
+    Put(TraceOp::Scroll);
+    Put(Known(node));
+    Put(x);
+    Put(y);
+}
+
+void MutationTrace::OnRootFontSize(Node &node, const float size) {
+    if (!IsKnown(node))
+        return;
+    FlushStyles();
+    Put(TraceOp::RootFontSize);
+    Put(Known(node));
+    Put(size);
+}
+
+void MutationTrace::OnCalculate(Node &node, const float availableWidth, const float availableHeight) {
+    OnFrame(node, TraceFrameKind::Plain, availableWidth, availableHeight, {}, 0);
+}
+
+void MutationTrace::OnCalculate(Node &node, const float availableWidth, const float availableHeight,
+                                const ViewportRect &viewport, const bool visibleFirst) {
+    OnFrame(node, visibleFirst ? TraceFrameKind::VisibleFirst : TraceFrameKind::Viewport,
+            availableWidth, availableHeight, viewport, 0);
+}
+
+void MutationTrace::OnCalculateFor(Node &node, const float availableWidth, const float availableHeight,
+                                   const std::chrono::steady_clock::time_point deadline) {
+    const auto budget = std::chrono::duration_cast<std::chrono::microseconds>(
+        deadline - std::chrono::steady_clock::now());
+    OnFrame(node, TraceFrameKind::Sliced, availableWidth, availableHeight, {},
+            std::max<std::int64_t>(0, budget.count()));
+}
+
+void MutationTrace::OnFrame(Node &node, const TraceFrameKind kind, const float availableWidth,
+                            const float availableHeight, const ViewportRect &viewport,
+                            const std::int64_t budgetMicroseconds) {
+    if (!IsKnown(node))
+        return;
+    FlushStyles();
+    Put(TraceOp::Calculate);
+    Put(Known(node));
+    Put(kind);
+    Put(availableWidth);
+    Put(availableHeight);
+    Put(viewport);
+    Put(budgetMicroseconds);
+}
+
+void MutationTrace::OnDestroy(Node &node) {
+    std::erase(m_styled, &node);
+}
+
+template<typename T>
+bool TraceReplayer::Get(T &value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (static_cast<std::size_t>(m_end - m_at) < sizeof(T))
+        return false;
+    std::memcpy(static_cast<void *>(&value), m_at, sizeof(T));
+    m_at += sizeof(T);
+    return true;
+}
+
+TraceReplayer::TraceReplayer(const void *data, const std::size_t size)
+    : m_at(static_cast<const std::uint8_t *>(data)), m_end(m_at + (data ? size : 0)), m_nodes(1) {
+    TraceHeader header;
+    TraceOp op;
+    if (!Get(header) || header.Magic != TraceMagic || header.Version != MutationTrace::Version ||
+        header.StyleSize != sizeof(TreeBuilder::StyleBlock) || !Get(op) || op != TraceOp::Tree || !Load()) {
+        m_at = m_end;
+        return;
+    }
+    m_root = m_nodes[1];
+}
+
+SharedNode TraceReplayer::NodeAt(const std::uint32_t id) const {
+    return id != 0 && id < m_nodes.size() ? m_nodes[id] : nullptr;
+}
+
+bool TraceReplayer::Load() {
+    std::uint32_t firstId, size;
+    if (!Get(firstId) || !Get(size) || firstId != m_nodes.size() ||
+        static_cast<std::size_t>(m_end - m_at) < size)
+        return false;
+    SharedNode tree = Snapshot::Load(m_at, size);
+    m_at += size;
+    if (!tree)
+        return false;
+    std::vector<SharedNode> stack{std::move(tree)};
+    while (!stack.empty()) {
+        SharedNode node = std::move(stack.back());
+        stack.pop_back();
+        const auto &children = node->Children();
+        for (auto it = children.rbegin(); it != children.rend(); ++it)
+            stack.push_back(*it);
+        m_nodes.push_back(std::move(node));
+    }
+    return true;
+}
+
+bool TraceReplayer::NextFrame(Frame &frame) {
+    if (!ApplyUntilFrame(frame)) {
+        m_at = m_end;
+        return false;
+    }
+    return true;
+}
+
+bool TraceReplayer::ApplyUntilFrame(Frame &frame) {
+    TraceOp op;
+    while (Get(op)) {
+        std::uint32_t id = 0, other = 0;
+        switch (op) {
+            case TraceOp::Tree:
+                if (!Load())
+                    return false;
+                break;
+            case TraceOp::Style: {
+                std::uint8_t writes;
+                TreeBuilder::StyleBlock block;
+                if (!Get(id) || !Get(writes) || !Get(block) || !NodeAt(id))
+                    return false;
+                bool calcValid = true;
+                ForEachLength(block.Dimensions, block.Flex, block.Margin, block.Padding, block.Border, block.Offsets,
+                              [&](CSSValue &value) {
+                                  if (value.Unit != CSSUnit::Calc)
+                                      return;
+                                  const float local = value.Value;
+                                  calcValid = calcValid && local >= 0.0f &&
+                                              local < static_cast<float>(m_calcIds.size());
+                                  value.Value = calcValid
+                                                    ? static_cast<float>(m_calcIds[static_cast<std::size_t>(local)])
+                                                    : 0.0f;
+                              });
+                if (!calcValid)
+                    return false;
+                // The same Modify calls as recorded, so the node is invalidated the same way.
+                Style &style = NodeAt(id)->GetStyle();
+                if (writes & SizeWrite) {
+                    style.Modify<Dimensions>() = block.Dimensions;
+                    style.Modify<CSSFlex>() = block.Flex;
+                    style.Modify<MarginEdge>() = block.Margin;
+                    style.Modify<PaddingEdge>() = block.Padding;
+                    style.Modify<BorderProperties>() = block.Border;
+                    style.Modify<CSSGrid>() = block.Grid;
+                }
+                if (writes & PositionWrite) {
+                    style.ModifyOffsets() = block.Offsets;
+                    if (!(writes & SizeWrite)) {
+                        const InsetRefs insets = style.ModifyInsets();
+                        insets.Top = block.Dimensions.Top;
+                        insets.Right = block.Dimensions.Right;
+                        insets.Bottom = block.Dimensions.Bottom;
+                        insets.Left = block.Dimensions.Left;
+                    }
+                }
+                break;
+            }
+            case TraceOp::AddChild:
+                if (!Get(id) || !Get(other) || !NodeAt(id) || !NodeAt(other))
+                    return false;
+                NodeAt(id)->AddChild(NodeAt(other));
+                break;
+            case TraceOp::RemoveChild: {
+                if (!Get(id) || !Get(other) || !NodeAt(id))
+                    return false;
+                SharedNode child = NodeAt(other);
+                NodeAt(id)->RemoveChild(child);
+                break;
+            }
+            case TraceOp::SetChildren: {
+                std::uint32_t count;
+                if (!Get(id) || !Get(count) || !NodeAt(id) ||
+                    static_cast<std::size_t>(m_end - m_at) / sizeof(std::uint32_t) < count)
+                    return false;
+                std::vector<SharedNode> children;
+                children.reserve(count);
+                for (std::uint32_t i = 0; i < count; ++i) {
+                    Get(other);
+                    if (!NodeAt(other))
+                        return false;
+                    children.push_back(NodeAt(other));
+                }
+                NodeAt(id)->SetChildren(std::move(children));
+                break;
+            }
+            case TraceOp::ClearChildren:
+                if (!Get(id) || !NodeAt(id))
+                    return false;
+                NodeAt(id)->ClearChildren();
+                break;
+            case TraceOp::Display: {
+                OuterDisplay display;
+                if (!Get(id) || !Get(display) || !NodeAt(id))
+                    return false;
+                NodeAt(id)->SetDisplay(display);
+                break;
+            }
+            case TraceOp::Scroll: {
+                float x, y;
+                if (!Get(id) || !Get(x) || !Get(y) || !NodeAt(id))
+                    return false;
+                NodeAt(id)->SetScrollOffset(x, y);
+                break;
+            }
+            case TraceOp::Calc: {
+                CalcTerms terms;
+                if (!Get(terms))
+                    return false;
+                m_calcIds.push_back(CalcTable::Intern(terms));
+                break;
+            }
+            case TraceOp::RootFontSize: {
+                float size;
+                if (!Get(id) || !Get(size) || !NodeAt(id))
+                    return false;
+                NodeAt(id)->SetRootFontSize(size);
+                break;
+            }
+            case TraceOp::Calculate: {
+                std::int64_t budget;
+                if (!Get(id) || !Get(frame.Kind) || !Get(frame.Width) || !Get(frame.Height) ||
+                    !Get(frame.Viewport) || !Get(budget) || !NodeAt(id) || frame.Kind > FrameKind::Sliced)
+                    return false;
+                frame.Target = NodeAt(id).get();
+                frame.Budget = std::chrono::microseconds(budget);
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+    return false;
+}
+
+void TraceReplayer::Run(const Frame &frame) {
+    Node &node = *frame.Target;
+    switch (frame.Kind) {
+        case FrameKind::Plain:
+            node.Calculate(frame.Width, frame.Height);
+            break;
+        case FrameKind::Viewport:
+            node.Calculate(frame.Width, frame.Height, frame.Viewport);
+            break;
+        case FrameKind::VisibleFirst:
+            node.CalculateVisibleFirst(frame.Width, frame.Height, frame.Viewport);
+            break;
+        case FrameKind::Sliced:
+            node.CalculateFor(frame.Width, frame.Height, std::chrono::steady_clock::now() + frame.Budget);
+            break;
+    }
+}
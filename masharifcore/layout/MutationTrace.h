@@ -0,0 +1,155 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <masharifcore/structure/Style.h>
+
+#include "Layout.h"
+
+namespace masharif {
+    class Node;
+    using SharedNode = std::shared_ptr<Node>;
+
+    /// Which Calculate a recorded frame ran.
+    enum class TraceFrameKind : std::uint8_t {
+        Plain, ///< Calculate(w, h)
+        Viewport, ///< Calculate(w, h, viewport)
+        VisibleFirst, ///< CalculateVisibleFirst(w, h, viewport)
+        Sliced, ///< CalculateFor(w, h, now + budget)
+    };
+
+    /// Records what a session does to one tree — child-list edits, style writes, display
+    /// toggles, scroll offsets and every Calculate — as a compact binary trace, so a real
+    /// workload can be replayed (TraceReplayer, the masharif_replay tool) against another
+    /// build of the engine.
+    ///
+    /// The trace opens with a Snapshot of the tree as it is when recording starts, layout
+    /// included, so replay starts from the same solved state. Nodes are numbered in that
+    /// image's pre-order; a subtree attached later is embedded as its own image when it is
+    /// first added. A style write is recorded as the node's whole style, taken just before
+    /// the next recorded operation (Modify hands out a reference, so the values are only known
+    /// once the caller is done), and replayed through the same Modify calls: the same nodes
+    /// are invalidated the same way.
+    ///
+    /// Records the calling thread while alive; one recorder per thread. Nodes that never
+    /// join the recorded tree are ignored, and a virtual list's window is not recorded (its
+    /// source is application code); replay shows it as the plain node it was at attach time.
+    class MutationTrace {
+    public:
+        static constexpr std::uint32_t Version = 4;
+
+        /// Start recording edits of `root`'s tree on this thread.
+        explicit MutationTrace(Node &root);
+
+        ~MutationTrace();
+
+        MutationTrace(const MutationTrace &) = delete;
+        MutationTrace &operator=(const MutationTrace &) = delete;
+
+        /// The trace so far, style writes included.
+        [[nodiscard]] const std::vector<std::uint8_t> &Data();
+
+        /// The recorder of this thread, null when nothing records.
+        [[nodiscard]] static MutationTrace *Active() noexcept { return s_active; }
+
+        /// Hooks for Node and Style; each ignores nodes outside the recorded tree.
+        void OnStyle(Node &node, bool positionOnly);
+        void OnAddChild(Node &parent, Node &child);
+        void OnRemoveChild(Node &parent, Node &child);
+        void OnSetChildren(Node &parent);
+        void OnClearChildren(Node &parent);
+        void OnSetDisplay(Node &node, OuterDisplay display);
+        void OnScroll(Node &node, float x, float y);
+        void OnRootFontSize(Node &node, float size);
+        void OnCalculate(Node &node, float availableWidth, float availableHeight);
+        void OnCalculate(Node &node, float availableWidth, float availableHeight, const ViewportRect &viewport,
+                         bool visibleFirst);
+        void OnCalculateFor(Node &node, float availableWidth, float availableHeight,
+                            std::chrono::steady_clock::time_point deadline);
+        void OnDestroy(Node &node);
+
+    private:
+        inline static thread_local MutationTrace *s_active = nullptr;
+
+        /// Node ids continue across the recorders of a thread, so the ids a finished recording
+        /// left on the nodes never look known to the next one.
+        inline static thread_local std::uint32_t s_nextId = 1;
+
+        /// Number the nodes of `root`'s subtree from the next id, in Snapshot order.
+        void Adopt(Node &root);
+
+        /// Id of a node in the recorded tree, embedding it (and its subtree) if it is new.
+        std::uint32_t Known(Node &node);
+
+        [[nodiscard]] bool IsKnown(const Node &node) const noexcept;
+
+        /// Write the style of every node edited since the last operation.
+        void FlushStyles();
+
+        void OnFrame(Node &node, TraceFrameKind kind, float availableWidth, float availableHeight,
+                     const ViewportRect &viewport, std::int64_t budgetMicroseconds);
+
+        template<typename T>
+        void Put(const T &value);
+
+        std::vector<std::uint8_t> m_data;
+        std::vector<Node *> m_styled; ///< nodes with a style write not yet recorded
+        /// Trace-local numbers of the calc() expressions recorded so far, by CalcTable id.
+        std::unordered_map<std::uint32_t, std::uint32_t> m_calcIndex;
+        std::uint32_t m_firstId; ///< s_nextId when recording started: trace id 1
+    };
+
+    /// Plays a MutationTrace back: rebuilds the tree from the trace's opening image, then
+    /// applies the recorded edits one frame at a time.
+    class TraceReplayer {
+    public:
+        using FrameKind = TraceFrameKind;
+
+        /// A recorded Calculate, ready to run.
+        struct Frame {
+            Node *Target = nullptr;
+            FrameKind Kind = FrameKind::Plain;
+            float Width = 0;
+            float Height = 0;
+            ViewportRect Viewport;
+            std::chrono::microseconds Budget{0};
+        };
+
+        /// Check the trace and rebuild its opening tree; Valid() is false for a damaged trace.
+        TraceReplayer(const void *data, std::size_t size);
+
+        [[nodiscard]] bool Valid() const noexcept { return m_root != nullptr; }
+
+        /// The replayed tree (the one recording started on).
+        [[nodiscard]] const SharedNode &Root() const noexcept { return m_root; }
+
+        /// Apply the edits up to the next recorded Calculate and describe it, without running
+        /// it. False at the end of the trace, or at a damaged operation.
+        bool NextFrame(Frame &frame);
+
+        /// Run a frame NextFrame returned, as recorded.
+        static void Run(const Frame &frame);
+
+    private:
+        template<typename T>
+        bool Get(T &value);
+
+        [[nodiscard]] SharedNode NodeAt(std::uint32_t id) const;
+
+        /// Rebuild an embedded image, numbering its nodes from the next id.
+        bool Load();
+
+        bool ApplyUntilFrame(Frame &frame);
+
+        const std::uint8_t *m_at;
+        const std::uint8_t *m_end;
+        SharedNode m_root;
+        std::vector<SharedNode> m_nodes; ///< by id; index 0 unused
+        std::vector<std::uint32_t> m_calcIds; ///< CalcTable ids, by trace-local number
+    };
+}
@@ -10,6 +10,13 @@ using namespace masharif;
 
 namespace
 {
+    /// Counts tree edits (dirty marks) on this thread, so CalculateFor can tell that the tree
+    /// changed between two slices of a frame.
+    thread_local std::uint64_t t_treeEdits = 0;
+
+    /// Counts child-list changes on this thread (Node::NoteStructureChange).
+    thread_local std::uint64_t t_structureChanges = 0;
+
     /// NaN compares equal to NaN here so an unchanged AUTO placeholder (NaN) is a cache hit.
     bool SameSize(float a, float b)
     {
@@ -31,6 +38,84 @@ namespace
         return current;
     }
 
+    /// Relative-position shift of an in-flow child, resolved against its containing block's
+    /// content box. Applied by the positions walk on top of the strategy's LocalX/Y, so it never
+    /// affects flow and an offset change needs no re-solve.
+    std::pair<float, float> RelativeShift(const Style& style, float refWidth, float refHeight)
+    {
+        if (style.GetDimensions().Position != PositionType::Relative) return {0.0f, 0.0f};
+        const auto& offset = style.GetOffsets();
+        return {
+            offset.Left.ResolveValue(refWidth) - offset.Right.ResolveValue(refWidth),
+            offset.Top.ResolveValue(refHeight) - offset.Bottom.ResolveValue(refHeight)
+        };
+    }
+
+    /// Sticky shift along one axis of a box whose in-flow start is `pos`: with a non-auto start
+    /// inset, push it forward until it sits that far inside the port's visible range, but never
+    /// past the end of its parent's content box (CSS sticky constraint rectangle).
+    float StickyAxisShift(const CSSValue& inset, float pos, float size,
+                          float viewStart, float viewSize, float boundEnd)
+    {
+        if (inset.Unit == CSSUnit::Auto) return 0.0f;
+        const float pinned = viewStart + inset.ResolveValue(viewSize);
+        if (!(pos < pinned)) return 0.0f;
+        return std::max(0.0f, std::min(pinned - pos, boundEnd - size - pos));
+    }
+
+    /// Saves the walk's scroll-port state and, for a port, makes it the innermost one for the
+    /// scope of its own walk.
+    class ScrollPortScope
+    {
+    public:
+        ScrollPortScope(LayoutContext& ctx, Node* port, float offsetX, float offsetY, bool offsetChanged)
+            : m_ctx(ctx), m_port(ctx.ScrollPort), m_offsetX(ctx.ScrollPortOffsetX),
+              m_offsetY(ctx.ScrollPortOffsetY), m_forcePin(ctx.ForcePin)
+        {
+            if (!port) return;
+            ctx.ScrollPort = port;
+            ctx.ScrollPortOffsetX = offsetX;
+            ctx.ScrollPortOffsetY = offsetY;
+            ctx.ForcePin = ctx.ForcePin || offsetChanged;
+        }
+
+        ~ScrollPortScope()
+        {
+            m_ctx.ScrollPort = m_port;
+            m_ctx.ScrollPortOffsetX = m_offsetX;
+            m_ctx.ScrollPortOffsetY = m_offsetY;
+            m_ctx.ForcePin = m_forcePin;
+        }
+
+        ScrollPortScope(const ScrollPortScope&) = delete;
+        ScrollPortScope& operator=(const ScrollPortScope&) = delete;
+
+    private:
+        LayoutContext& m_ctx;
+        Node* m_port;
+        float m_offsetX, m_offsetY;
+        bool m_forcePin;
+    };
+
+    /// Clears a node's definite-size flags when the definite pass ends.
+    class DefiniteSizeScope
+    {
+    public:
+        DefiniteSizeScope(bool& main, bool& cross) : m_main(main), m_cross(cross)
+        {
+            m_main = m_cross = true;
+        }
+
+        ~DefiniteSizeScope() { m_main = m_cross = false; }
+
+        DefiniteSizeScope(const DefiniteSizeScope&) = delete;
+        DefiniteSizeScope& operator=(const DefiniteSizeScope&) = delete;
+
+    private:
+        bool& m_main;
+        bool& m_cross;
+    };
+
     /// Static-position offset along the main axis for an auto-inset out-of-flow child,
     /// mirroring how justify-content places an in-flow item (single-item semantics: the
     /// distributive values collapse to start/center). See PositionLineOnMainAxis.
@@ -60,8 +145,8 @@ namespace
     /// Available space to measure an out-of-flow child on one axis. An explicit size keeps the
     /// containing-block extent (its percentage basis). An AUTO size pinned by BOTH insets fills
     /// the gap between them. An AUTO size otherwise shrink-to-fits its content (CSS abs/shrink-to-
-    /// fit), signalled to the solver with NaN — handing it a definite extent instead would stretch
-    /// the box to the whole containing block (the overlay-fills-the-screen bug).
+    /// fit), signalled with NaN — handing the solver the containing block's extent instead would
+    /// stretch the box over all of it (the overlay-fills-the-screen bug).
     float OutOfFlowAvailable(const CSSValue& size, const CSSValue& start, const CSSValue& end, float ref)
     {
         if (size.Unit != CSSUnit::Auto) return ref;
@@ -76,18 +161,193 @@ void Node::RemoveChild(SharedNode& child)
     auto it = std::find(m_Children.begin(), m_Children.end(), child);
     if (it != m_Children.end())
     {
+        const auto index = static_cast<std::size_t>(it - m_Children.begin());
         m_Children.erase(it);
+        for (std::size_t i = index; i < m_Children.size(); ++i)
+            m_Children[i]->m_indexInParent = static_cast<std::uint32_t>(i);
+        // Keep the resumable strategy state aligned with the shifted indices: the cursor before
+        // the removed child is now the cursor before its successor, so the entry after it goes;
+        // the (possibly soon dangling) out-of-flow pointer goes too.
+        if (index + 1 < m_flowTable.Offsets.size())
+            m_flowTable.Offsets.erase(m_flowTable.Offsets.begin() + static_cast<std::ptrdiff_t>(index + 1));
+        std::erase(m_OutOfFlowChildren, child.get());
+        NoteStructureChange();
+        NoteChangedChildren(index, index + 1);
         MarkDirtyToRoot();
+        if (MutationTrace* trace = MutationTrace::Active()) trace->OnRemoveChild(*this, *child);
     }
 }
 
+void Node::NoteStructureChange() noexcept
+{
+    ++t_structureChanges;
+}
+
+std::uint64_t Node::StructureChanges() noexcept
+{
+    return t_structureChanges;
+}
+
+void Node::Publish() noexcept
+{
+    const LayoutBox box{m_Layout.ComputedX, m_Layout.ComputedY, m_Layout.ComputedWidth, m_Layout.ComputedHeight};
+    if (box.X == m_published.X && box.Y == m_published.Y && box.Width == m_published.Width &&
+        box.Height == m_published.Height && m_Layout.LocalX == m_publishedLocalX &&
+        m_Layout.LocalY == m_publishedLocalY)
+        return;
+    m_published = box;
+    m_publishedLocalX = m_Layout.LocalX;
+    m_publishedLocalY = m_Layout.LocalY;
+    m_exportPending = true;
+    for (Node* p = m_Parent; p && !p->m_exportPendingInSubtree; p = p->m_Parent)
+        p->m_exportPendingInSubtree = true;
+}
+
 void Node::MarkDirtyToRoot()
 {
     m_Style.Dirty = true;
-    for (Node* p = m_Parent; p && !p->m_descendantDirty; p = p->m_Parent)
+    m_intrinsicValid = 0;
+    MarkAncestorsDirty();
+}
+
+void Node::MarkAncestorsDirty()
+{
+    // Record the changed child at every level (not just the newly flagged ones): an already
+    // flagged ancestor recorded this path's index in its own parent when it was flagged, so
+    // the walk can still stop there.
+    ++t_treeEdits;
+    const Node* child = this;
+    for (Node* p = m_Parent; p; child = p, p = p->m_Parent)
     {
+        p->NoteChangedChildren(child->m_indexInParent, child->m_indexInParent + 1);
+        if (p->m_descendantDirty) break;
         p->m_descendantDirty = true;
     }
+    // Its own stop condition: an intrinsic query between frames re-caches ancestors that are
+    // still flagged dirty.
+    for (Node* p = m_Parent; p && p->m_intrinsicValid; p = p->m_Parent)
+        p->m_intrinsicValid = 0;
+}
+
+void Node::MarkPositionDirty()
+{
+    m_Style.PositionDirty = true;
+    ++t_treeEdits;
+    // No early-out: m_positionsDirty is also raised per node by strategy runs, so a flagged
+    // ancestor says nothing about the ones above it.
+    for (Node* p = m_Parent; p; p = p->m_Parent)
+        p->m_positionsDirty = true;
+}
+
+void Node::SetRootFontSize(float size)
+{
+    if (size == m_rootFontSize) return;
+    if (MutationTrace* trace = MutationTrace::Active()) trace->OnRootFontSize(*this, size);
+    // The next frame's ApplyUnitContext sees the change and dirties the dependents.
+    m_rootFontSize = size;
+}
+
+void Node::ApplyUnitContext(float availableWidth, float availableHeight)
+{
+    UnitContext& units = UnitContext::Current();
+    units.ViewportWidth = std::isnan(availableWidth) ? 0.0f : availableWidth;
+    units.ViewportHeight = std::isnan(availableHeight) ? 0.0f : availableHeight;
+    units.RootFontSize = m_rootFontSize;
+
+    std::uint8_t changed = 0;
+    if (units.ViewportWidth != m_unitsWidth) changed |= UnitDependency::ViewportWidth;
+    if (units.ViewportHeight != m_unitsHeight) changed |= UnitDependency::ViewportHeight;
+    if (units.RootFontSize != m_unitsFontSize) changed |= UnitDependency::FontSize;
+    m_unitsWidth = units.ViewportWidth;
+    m_unitsHeight = units.ViewportHeight;
+    m_unitsFontSize = units.RootFontSize;
+    if (!changed) return;
+    // The root's own lengths are not in any parent's walk; a new available space re-solves it
+    // anyway, but a font size change would not.
+    if (m_Style.UnitDependencies() & changed) MarkDirtyToRoot();
+    if (m_unitsInSubtree) DirtyUnitDependents(changed);
+}
+
+void Node::DirtyUnitDependents(std::uint8_t changed)
+{
+    for (auto& child : m_Children)
+    {
+        if (child->m_unitDependencies & changed) child->MarkDirtyToRoot();
+        if (child->m_unitsInSubtree) child->DirtyUnitDependents(changed);
+    }
+}
+
+void Node::SetScrollOffset(float x, float y)
+{
+    if (m_scrollPort && x == m_scrollX && y == m_scrollY) return;
+    if (MutationTrace* trace = MutationTrace::Active()) trace->OnScroll(*this, x, y);
+    m_scrollPort = true;
+    m_scrollX = x;
+    m_scrollY = y;
+    m_scrollChanged = true;
+    ++t_treeEdits;
+    // A virtual list materializes a different window: that is a real layout change.
+    if (m_virtual)
+        MarkDirtyToRoot();
+    // Otherwise position-only: the walk must reach this node (not just its parent) to re-pin.
+    m_positionsDirty = true;
+    for (Node* p = m_Parent; p; p = p->m_Parent)
+        p->m_positionsDirty = true;
+}
+
+void Node::SetVirtualSource(std::shared_ptr<VirtualListSource> source, std::size_t overscan)
+{
+    if (m_virtual)
+    {
+        for (std::size_t i = 0; i < m_Children.size(); ++i)
+        {
+            m_Children[i]->SetParent(nullptr);
+            m_virtual->Source->Recycle(m_virtual->First + i, std::move(m_Children[i]));
+        }
+    }
+    m_virtual.reset();
+    if (source)
+    {
+        m_virtual = std::make_unique<VirtualListState>();
+        m_virtual->Estimate = std::max(1.0f, source->EstimatedItemSize());
+        m_virtual->Source = std::move(source);
+        m_virtual->Overscan = overscan;
+    }
+    ClearChildren();
+}
+
+void Node::WalkPositions(LayoutContext& ctx)
+{
+    ScrollPortScope port(ctx, m_scrollPort ? this : nullptr, m_scrollX, m_scrollY, m_scrollChanged);
+    m_scrollChanged = false;
+    StartUpdatingPositions(ctx);
+    PositionOutOfFlowChildren(ctx);
+    AggregateSubtreeFlags();
+}
+
+void Node::AggregateSubtreeFlags()
+{
+    // Only now: every child the walk entered (in flow or out of flow) has recomputed its own
+    // flags, so they reach up from any depth, not just from direct children.
+    bool stickyInSubtree = false;
+    bool unitsInSubtree = false;
+    bool autoVisibilityInSubtree = false;
+    bool deferredInSubtree = false;
+    for (const auto& child : m_Children)
+    {
+        // Hidden ones included for the units: see StartUpdatingPositions.
+        unitsInSubtree = unitsInSubtree || child->m_unitDependencies || child->m_unitsInSubtree;
+        const auto& dim = child->GetStyle().GetDimensions();
+        if (dim.Display == OuterDisplay::None) continue;
+        stickyInSubtree = stickyInSubtree || dim.Position == PositionType::Sticky || child->m_stickyInSubtree;
+        autoVisibilityInSubtree = autoVisibilityInSubtree || child->m_autoVisibilityInSubtree ||
+            child->m_contentSkipped || dim.Visibility == ContentVisibility::Auto;
+        deferredInSubtree = deferredInSubtree || child->m_contentSkipped || child->m_deferredInSubtree;
+    }
+    m_stickyInSubtree = stickyInSubtree;
+    m_unitsInSubtree = unitsInSubtree;
+    m_autoVisibilityInSubtree = autoVisibilityInSubtree;
+    m_deferredInSubtree = deferredInSubtree;
 }
 
 void Node::StartUpdatingPositions(LayoutContext& ctx)
@@ -95,22 +355,24 @@ void Node::StartUpdatingPositions(LayoutContext& ctx)
     // Clear dirty at end of frame (not mid-solve, which would hide a change from the
     // later definite-size pass).
     m_Style.Dirty = false;
+    m_Style.PositionDirty = false;
     m_descendantDirty = false;
     m_positionsDirty = false;
+    ClearChangedChildren();
 
     const float absX = m_Layout.ComputedX;
     const float absY = m_Layout.ComputedY;
+    const auto& padding = m_Style.GetPadding();
+    const auto& border = m_Style.GetBorder();
+    const float contentW = m_Layout.ComputedWidth - padding.Left - padding.Right - border.WidthLeft - border.WidthRight;
+    const float contentH = m_Layout.ComputedHeight - padding.Top - padding.Bottom - border.WidthTop - border.WidthBottom;
+    bool placeholderAbove = false;
     for (auto& child : m_Children)
     {
-        auto& position = child->GetStyle().GetDimensions().Position;
-        if (position != PositionType::Static &&
-            position != PositionType::Relative)
-        {
-            // Out-of-flow subtrees are solved, positioned AND walked by
-            // PositionOutOfFlowChildren — touching them here would clear their dirty
-            // flags before that solve runs.
-            continue;
-        }
+        // Hidden ones included: SetDisplay may show a retained layout, which a change of the
+        // unit references while hidden must still invalidate.
+        if (child->m_Style.Dirty || child->m_Style.PositionDirty)
+            child->m_unitDependencies = child->m_Style.UnitDependencies();
         // A display:none subtree generates no boxes: its strategy never ran this frame, so its
         // descendants' out-of-flow lists may be stale (and, with raw-pointer storage, dangling).
         // Do not derive positions for it or walk into it.
@@ -118,25 +380,61 @@ void Node::StartUpdatingPositions(LayoutContext& ctx)
         {
             continue;
         }
+        const auto position = child->GetStyle().GetDimensions().Position;
+        if (IsOutOfFlow(position))
+        {
+            // Out-of-flow subtrees are solved, positioned AND walked by
+            // PositionOutOfFlowChildren — touching them here would clear their dirty
+            // flags before that solve runs.
+            continue;
+        }
         auto& childLayout = child->m_Layout;
         // Derive absolute from stable local (idempotent: a skipped clean subtree still
-        // lands correctly when an ancestor moves).
-        const float newX = absX + childLayout.LocalX;
-        const float newY = absY + childLayout.LocalY;
+        // lands correctly when an ancestor moves), plus the relative shift.
+        const auto [shiftX, shiftY] = RelativeShift(child->m_Style, contentW, contentH);
+        float newX = absX + childLayout.LocalX + shiftX;
+        float newY = absY + childLayout.LocalY + shiftY;
+        if (position == PositionType::Sticky)
+        {
+            // Pin against the innermost scroll port's padding box, scrolled by its offset and
+            // expressed in its content space, within this node's content box.
+            Node* port = ctx.ScrollPort ? ctx.ScrollPort : this;
+            const auto& portLayout = port->m_Layout;
+            const auto& portBorder = port->m_Style.GetBorder();
+            const float viewX = portLayout.ComputedX + portBorder.WidthLeft + ctx.ScrollPortOffsetX;
+            const float viewY = portLayout.ComputedY + portBorder.WidthTop + ctx.ScrollPortOffsetY;
+            const float viewW = portLayout.ComputedWidth - portBorder.WidthLeft - portBorder.WidthRight;
+            const float viewH = portLayout.ComputedHeight - portBorder.WidthTop - portBorder.WidthBottom;
+            const auto& dim = child->m_Style.GetDimensions();
+            newX += StickyAxisShift(dim.Left, newX, childLayout.ComputedWidth, viewX, viewW,
+                                    absX + border.WidthLeft + padding.Left + contentW);
+            newY += StickyAxisShift(dim.Top, newY, childLayout.ComputedHeight, viewY, viewH,
+                                    absY + border.WidthTop + padding.Top + contentH);
+        }
         // NaN-safe: NaN != NaN forces a visit, never a skip.
         const bool originChanged = newX != childLayout.ComputedX || newY != childLayout.ComputedY;
         childLayout.ComputedX = newX;
         childLayout.ComputedY = newY;
+        child->Publish();
+        if (child->UpdateContentVisibility(ctx, placeholderAbove))
+        {
+            // A progressive frame reveals flow siblings in order: below a never-solved
+            // placeholder nothing is where it will be once that one is solved.
+            placeholderAbove = placeholderAbove || (ctx.DeferOffscreen && std::isnan(child->m_rememberedH));
+            continue;
+        }
 
         // Recurse only where something can have changed: the subtree moved, was re-solved
         // (m_positionsDirty), or carries dirt to clear. MarkDirtyToRoot flags every ancestor
         // and a strategy only runs while all ancestors' strategies are on the stack, so a
         // flagged node is always reachable through flagged ancestors — skipped subtrees are
         // flag-free by construction. Idle frames touch only the clean frontier.
-        if (originChanged || child->m_positionsDirty || child->m_Style.Dirty || child->m_descendantDirty)
+        // Inside a port whose offset changed, also descend towards every sticky node to re-pin.
+        if (originChanged || child->m_positionsDirty || child->m_Style.Dirty || child->m_Style.PositionDirty ||
+            child->m_descendantDirty || (ctx.ForcePin && child->m_stickyInSubtree) ||
+            (ctx.ViewportMoved && child->m_autoVisibilityInSubtree))
         {
-            child->StartUpdatingPositions(ctx);
-            child->PositionOutOfFlowChildren(ctx);
+            child->WalkPositions(ctx);
         }
     }
 }
@@ -176,8 +474,18 @@ void Node::PositionOutOfFlowChildren(LayoutContext& ctx)
         // Measure against the containing block, but let an AUTO axis shrink-to-fit instead of
         // stretching to fill it (the cross axis would otherwise fill the whole block).
         const auto& cdim = child->GetStyle().GetDimensions();
-        const float availW = OutOfFlowAvailable(cdim.Width, cdim.Left, cdim.Right, refWidth);
+        float availW = OutOfFlowAvailable(cdim.Width, cdim.Left, cdim.Right, refWidth);
         const float availH = OutOfFlowAvailable(cdim.Height, cdim.Top, cdim.Bottom, refHeight);
+        // A shrink-to-fit width comes from the intrinsic widths, in the containing block less the
+        // one inset given; the child then fills exactly that margin box. The height is its
+        // content's, which the solve yields at that width.
+        if (std::isnan(availW))
+        {
+            const auto& margin = child->GetStyle().GetMargin();
+            availW = child->ShrinkToFitWidth(refWidth - cdim.Left.ResolveValue(refWidth) -
+                                             cdim.Right.ResolveValue(refWidth)) +
+                margin.Left.ResolveValue(refWidth) + margin.Right.ResolveValue(refWidth);
+        }
 
         const bool widthPinned = cdim.Width.Unit == CSSUnit::Auto &&
             cdim.Left.Unit != CSSUnit::Auto && cdim.Right.Unit != CSSUnit::Auto;
@@ -192,35 +500,271 @@ void Node::PositionOutOfFlowChildren(LayoutContext& ctx)
         child->m_mainSizeDefinite = false;
         child->m_crossSizeDefinite = false;
 
-        if (position == PositionType::Sticky)
-        {
-            child->HandleStickyPosition(refWidth, refHeight);
-        }
-        else
-        {
-            child->PositionOutOfFlowChild(ancestor, refWidth, refHeight);
-        }
+        child->PositionOutOfFlowChild(ancestor, refWidth, refHeight);
+        child->Publish();
+        if (child->UpdateContentVisibility(ctx))
+            continue;
 
         // The main walk skips out-of-flow subtrees entirely; derive their descendants'
         // absolute coordinates from the origin just set, and re-position nested out-of-flow
         // lists. This runs in the same frame — no one-frame lag, no stale fix-ups.
-        child->StartUpdatingPositions(ctx);
-        child->PositionOutOfFlowChildren(ctx);
+        child->WalkPositions(ctx);
     }
 }
 
 void Node::Calculate(float availableWidth, float availableHeight)
 {
-    m_generation = BumpTreeGeneration();
+    if (MutationTrace* trace = MutationTrace::Active()) trace->OnCalculate(*this, availableWidth, availableHeight);
+    LayoutContext ctx;
+    // Leaving viewport mode: every skipped subtree is near now and must be revealed.
+    ctx.ViewportMoved = m_hadViewport;
+    m_hadViewport = false;
+    m_slicedFrame.reset();
+    CalculateFrame(ctx, availableWidth, availableHeight);
+}
+
+void Node::Calculate(float availableWidth, float availableHeight, const ViewportRect& viewport)
+{
+    if (MutationTrace* trace = MutationTrace::Active())
+        trace->OnCalculate(*this, availableWidth, availableHeight, viewport, false);
     LayoutContext ctx;
-    LayoutImpl(ctx, availableWidth, availableHeight);
+    ctx.Viewport = viewport;
+    ctx.ViewportBounded = true;
+    ctx.ViewportMoved = !m_hadViewport || viewport.X != m_lastViewport.X || viewport.Y != m_lastViewport.Y ||
+        viewport.Width != m_lastViewport.Width || viewport.Height != m_lastViewport.Height ||
+        viewport.Margin != m_lastViewport.Margin;
+    m_lastViewport = viewport;
+    m_hadViewport = true;
+    m_slicedFrame.reset();
+    CalculateFrame(ctx, availableWidth, availableHeight);
+}
+
+void Node::CalculateVisibleFirst(float availableWidth, float availableHeight, const ViewportRect& viewport)
+{
+    if (MutationTrace* trace = MutationTrace::Active())
+        trace->OnCalculate(*this, availableWidth, availableHeight, viewport, true);
+    LayoutContext ctx;
+    ctx.Viewport = viewport;
+    ctx.ViewportBounded = true;
+    ctx.DeferOffscreen = true;
+    // Every deferrable node re-decides, not only the auto ones a moved viewport would reach.
+    ctx.ViewportMoved = true;
+    m_lastViewport = viewport;
+    m_hadViewport = true;
+    m_slicedFrame.reset();
+    CalculateFrame(ctx, availableWidth, availableHeight);
+}
+
+LayoutProgress Node::CalculateFor(float availableWidth, float availableHeight,
+                                  std::chrono::steady_clock::time_point deadline)
+{
+    if (MutationTrace* trace = MutationTrace::Active())
+        trace->OnCalculateFor(*this, availableWidth, availableHeight, deadline);
+    // Ahead of the resume check: dirtying the dependents of a new font size is an edit.
+    ApplyUnitContext(availableWidth, availableHeight);
+    // Resume only the frame that is still current: same inputs, no edits since the last slice
+    // and no other solve in between (which would have moved the tree generation on).
+    const bool resume = m_slicedFrame && m_slicedFrame->Generation == m_generation &&
+        m_slicedFrame->Edits == t_treeEdits &&
+        SameSize(availableWidth, m_slicedFrame->AvailW) && SameSize(availableHeight, m_slicedFrame->AvailH);
+    if (!resume)
+    {
+        m_slicedFrame = std::make_unique<SlicedFrame>();
+        m_slicedFrame->Generation = BumpTreeGeneration();
+        m_slicedFrame->AvailW = availableWidth;
+        m_slicedFrame->AvailH = availableHeight;
+        m_slicedFrame->Pending.push_back({this, availableWidth, availableHeight, false});
+    }
+    SlicedFrame& frame = *m_slicedFrame;
+    ++frame.Progress.Slices;
+
+    LayoutContext ctx;
+    ctx.ViewportMoved = m_hadViewport;
+    ctx.HasDeadline = true;
+    ctx.Deadline = deadline;
+    ctx.SlicedRoot = this;
+    ctx.Tracer = LayoutTracer::Active();
+    ctx.Profiler = LayoutProfiler::Active();
+    AttachLayoutStats(ctx);
+    const TraceSlice trace(ctx, TraceSliceKind::Frame, LayoutTracer::NoDetail, this, availableWidth, availableHeight);
+    for (;;)
+    {
+        // Each call finishes one the slice before stopped in, which then replays it.
+        while (!frame.Pending.empty())
+        {
+            const PendingSolve next = frame.Pending.back();
+            frame.Pending.pop_back();
+            const std::size_t outer = frame.Pending.size();
+            next.Target->LayoutImpl(ctx, next.AvailW, next.AvailH, next.IgnoreMinMax);
+            if (ctx.Yielded)
+            {
+                // The calls that stopped queued themselves innermost first; run that one first.
+                std::reverse(frame.Pending.begin() + static_cast<std::ptrdiff_t>(outer), frame.Pending.end());
+                PublishCacheStats(ctx);
+                frame.Progress.Solves += ctx.Solves;
+                frame.Edits = t_treeEdits;
+                return frame.Progress;
+            }
+        }
+        // The root is solved: the positions walk runs unsliced, so the published boxes switch
+        // to this pass all at once.
+        ctx.HasDeadline = false;
+        FinishFrame(ctx, availableWidth, availableHeight);
+        m_hadViewport = false;
+        if (!ctx.Revealed) break;
+        // The walk revealed subtrees a viewport frame left unsolved (see CalculateFrame): solve
+        // them as another sliced pass under a fresh generation.
+        ctx.Revealed = false;
+        ctx.HasDeadline = true;
+        frame.Generation = BumpTreeGeneration();
+        frame.Pending.push_back({this, availableWidth, availableHeight, false});
+    }
+    frame.Progress.Solves += ctx.Solves;
+    PublishCacheStats(ctx);
+
+    LayoutProgress progress = frame.Progress;
+    progress.Done = true;
+    m_slicedFrame.reset();
+    return progress;
+}
+
+const LayoutStats& Node::GetLayoutStats() const noexcept
+{
+#ifdef MASHARIF_LAYOUT_STATS
+    if (m_stats) return *m_stats;
+#endif
+    static const LayoutStats disabled;
+    return disabled;
+}
+
+void Node::AttachLayoutStats([[maybe_unused]] LayoutContext& ctx)
+{
+#ifdef MASHARIF_LAYOUT_STATS
+    if (!m_stats) m_stats = std::make_unique<LayoutStats>();
+    *m_stats = LayoutStats{};
+    m_stats->Enabled = true;
+    ctx.Stats = m_stats.get();
+#endif
+}
+
+const CacheStats& Node::GetCacheStats() const noexcept
+{
+    static const CacheStats none;
+    return m_cacheStats ? *m_cacheStats : none;
+}
+
+void Node::PublishCacheStats(const LayoutContext& ctx)
+{
+    if (!m_cacheStats) m_cacheStats = std::make_unique<CacheStats>();
+    *m_cacheStats = ctx.Cache;
+}
+
+void Node::CalculateFrame(LayoutContext& ctx, float availableWidth, float availableHeight)
+{
+    ApplyUnitContext(availableWidth, availableHeight);
+    ctx.Tracer = LayoutTracer::Active();
+    ctx.Profiler = LayoutProfiler::Active();
+    AttachLayoutStats(ctx);
+    const TraceSlice trace(ctx, TraceSliceKind::Frame, LayoutTracer::NoDetail, this, availableWidth, availableHeight);
+    do
+    {
+        // A fresh generation per pass: the reveal pass must not replay this frame's measures.
+        m_generation = BumpTreeGeneration();
+        ctx.Revealed = false;
+        LayoutImpl(ctx, availableWidth, availableHeight);
+        FinishFrame(ctx, availableWidth, availableHeight);
+    }
+    while (ctx.Revealed);
+    PublishCacheStats(ctx);
+}
+
+void Node::FinishFrame(LayoutContext& ctx, float availableWidth, float availableHeight)
+{
     // Root's local origin is its absolute origin; descendants derive theirs from it.
-    m_Layout.ComputedX = m_Layout.LocalX;
-    m_Layout.ComputedY = m_Layout.LocalY;
-    StartUpdatingPositions(ctx);
+    const auto [shiftX, shiftY] = RelativeShift(m_Style, availableWidth, availableHeight);
+    m_Layout.ComputedX = m_Layout.LocalX + shiftX;
+    m_Layout.ComputedY = m_Layout.LocalY + shiftY;
+    Publish();
+    // The root is the viewport: sticky nodes outside any scroll port pin against it.
+    ctx.ScrollPort = this;
+    ctx.ScrollPortOffsetX = m_scrollX;
+    ctx.ScrollPortOffsetY = m_scrollY;
     // The walk consumes every descendant's out-of-flow list; the root's own list has no
-    // other consumer, so it is handled here.
-    PositionOutOfFlowChildren(ctx);
+    // other consumer, so WalkPositions handles it too.
+    {
+        MASHARIF_LAYOUT_PHASE(ctx, LayoutPhase::PositionsWalk);
+        const TraceSlice trace(ctx, TraceSliceKind::Phase, static_cast<std::uint8_t>(LayoutPhase::PositionsWalk), this);
+        WalkPositions(ctx);
+    }
+    // Positions only move where a reveal changed a size, and the reveal flagged that path.
+    ctx.ViewportMoved = false;
+}
+
+bool Node::DefersOffscreen(const LayoutContext& ctx) const
+{
+    if (!ctx.DeferOffscreen || !m_Parent || m_Children.empty() || m_virtual || m_Parent->m_virtual) return false;
+    // A box with contents stacked in a normal-flow parent: its size only shifts the siblings
+    // after it.
+    const auto& dim = m_Style.GetDimensions();
+    const auto parentDisplay = m_Parent->m_Style.GetDimensions().Display;
+    return !IsOutOfFlow(dim.Position) &&
+        (dim.Display == OuterDisplay::Block || dim.Display == OuterDisplay::InlineBlock) &&
+        (parentDisplay == OuterDisplay::Block || parentDisplay == OuterDisplay::InlineBlock);
+}
+
+bool Node::UpdateContentVisibility(LayoutContext& ctx, bool positionUnknown)
+{
+    // A skipped subtree re-decides in any frame (a full frame reveals it).
+    if (m_Style.GetDimensions().Visibility != ContentVisibility::Auto && !m_contentSkipped &&
+        !DefersOffscreen(ctx))
+        return false;
+    bool near = true;
+    if (ctx.ViewportBounded)
+    {
+        const ViewportRect& view = ctx.Viewport;
+        // Inclusive at the start edges, so an empty placeholder at the viewport's top counts.
+        near = m_Layout.ComputedX < view.X + view.Width + view.Margin &&
+            m_Layout.ComputedX + m_Layout.ComputedWidth >= view.X - view.Margin &&
+            m_Layout.ComputedY < view.Y + view.Height + view.Margin &&
+            m_Layout.ComputedY + m_Layout.ComputedHeight >= view.Y - view.Margin;
+    }
+    if (positionUnknown && m_contentSkipped) near = false;
+    m_contentRevealed = near;
+    if (near && m_contentSkipped)
+    {
+        // Solve it in the frame's next pass; its stale contents are not walked in this one.
+        MarkDirtyToRoot();
+        ctx.Revealed = true;
+    }
+    return m_contentSkipped;
+}
+
+void Node::SizeSkippedContents(float availableWidth, float availableHeight)
+{
+    const auto& dim = m_Style.GetDimensions();
+    const bool inlineAutoWidth = dim.Width.Unit == CSSUnit::Auto &&
+        (dim.Display == OuterDisplay::Inline || dim.Display == OuterDisplay::InlineBlock);
+    // An AUTO inline width would shrink-to-fit the contents, which a skipped subtree does not
+    // consult: handled below.
+    if (!inlineAutoWidth)
+        ComputeDimensions(availableWidth, availableHeight);
+
+    const auto& padding = m_Style.GetPadding();
+    const auto& border = m_Style.GetBorder();
+    if (inlineAutoWidth)
+    {
+        m_Layout.ComputedWidth = !std::isnan(m_rememberedW)
+                                     ? m_rememberedW
+                                     : dim.ContainIntrinsicWidth.ResolveValue(availableWidth) +
+                                     padding.Left + padding.Right + border.WidthLeft + border.WidthRight;
+    }
+    if (dim.Height.Unit == CSSUnit::Auto)
+    {
+        m_Layout.ComputedHeight = !std::isnan(m_rememberedH)
+                                      ? m_rememberedH
+                                      : dim.ContainIntrinsicHeight.ResolveValue(availableHeight) +
+                                      padding.Top + padding.Bottom + border.WidthTop + border.WidthBottom;
+    }
 }
 
 void Node::LayoutImpl(float availableWidth, float availableHeight, bool ignoreMinMax)
@@ -243,15 +787,52 @@ const Node::MeasureCacheEntry* Node::FindMeasure(float availW, float availH, boo
     return nullptr;
 }
 
-void Node::RecordMeasure(float availW, float availH, bool ignoreMinMax, float resultW, float resultH)
+void Node::RecordMeasure(LayoutContext& ctx, float availW, float availH, bool ignoreMinMax, float resultW,
+                         float resultH)
 {
+    if (m_generation != 0 && m_measureCache[m_measureCacheNext].Generation == m_generation)
+        CountCache(ctx, CacheEvent::RingEviction);
     m_measureCache[m_measureCacheNext] = {m_generation, availW, availH, ignoreMinMax, resultW, resultH};
     m_measureCacheNext = static_cast<std::uint8_t>((m_measureCacheNext + 1) % MeasureCacheSize);
 }
 
+CacheEvent Node::LayoutMissReason(float availW, float availH, bool ignoreMinMax) const
+{
+    bool ringFull = m_generation != 0;
+    bool stale = false;
+    for (const auto& entry : m_measureCache)
+    {
+        ringFull = ringFull && entry.Generation == m_generation;
+        stale = stale || (entry.Generation != 0 && entry.Generation != m_generation &&
+            entry.IgnoreMinMax == ignoreMinMax && SameSize(entry.AvailW, availW) && SameSize(entry.AvailH, availH));
+    }
+    // A full ring means this frame already solved the node MeasureCacheSize times: the inputs
+    // may have been evicted, whatever else changed.
+    if (ringFull) return CacheEvent::LayoutMissRingOverflow;
+    if (m_Style.Dirty) return CacheEvent::LayoutMissDirty;
+    if (m_descendantDirty) return CacheEvent::LayoutMissDescendantDirty;
+    return stale ? CacheEvent::LayoutMissGenerationStale : CacheEvent::LayoutMissSpaceChanged;
+}
+
+void Node::CountCache(LayoutContext& ctx, CacheEvent event)
+{
+    ++ctx.Cache[event];
+    if (ctx.OpenSlice && event != CacheEvent::RingEviction) ctx.OpenSlice->Verdict(this, event);
+#ifdef MASHARIF_NODE_CACHE_STATS
+    if (m_nodeCacheGeneration != m_generation)
+    {
+        m_nodeCacheStats = {};
+        m_nodeCacheGeneration = m_generation;
+    }
+    ++m_nodeCacheStats[event];
+#endif
+}
+
 void Node::LayoutImpl(LayoutContext& ctx, float availableWidth, float availableHeight, bool ignoreMinMax)
 {
     PullGeneration();
+    const TraceSlice trace(ctx, TraceSliceKind::Layout, LayoutTracer::NoDetail, this, availableWidth, availableHeight);
+    const ProfileScope profile(ctx, this, m_Layout.StrategyRuns);
 
     if (m_Style.GetDimensions().Display == OuterDisplay::None)
     {
@@ -274,7 +855,8 @@ void Node::LayoutImpl(LayoutContext& ctx, float availableWidth, float availableH
         // Make the result replayable for this frame: if a later full solve at different
         // inputs overwrites m_LastAvail, a repeat call at these inputs must not re-solve.
         if (!FindMeasure(availableWidth, availableHeight, ignoreMinMax))
-            RecordMeasure(availableWidth, availableHeight, ignoreMinMax, m_implW, m_implH);
+            RecordMeasure(ctx, availableWidth, availableHeight, ignoreMinMax, m_implW, m_implH);
+        CountCache(ctx, CacheEvent::FullReuseHit);
         return;
     }
 
@@ -286,17 +868,60 @@ void Node::LayoutImpl(LayoutContext& ctx, float availableWidth, float availableH
     {
         m_Layout.ComputedWidth = hit->ResultW;
         m_Layout.ComputedHeight = hit->ResultH;
+        CountCache(ctx, CacheEvent::MeasureHit);
         return;
     }
 
-    m_lastAvailW = availableWidth;
-    m_lastAvailH = availableHeight;
+    // A time-sliced solve stops here, before any state of this node is touched; the next slice
+    // starts with this call.
+    if (ctx.HasDeadline && !ctx.YieldBlocked && ctx.Solves > 0 && --ctx.DeadlineCountdown == 0)
+    {
+        ctx.DeadlineCountdown = LayoutContext::DeadlineStride;
+        if (std::chrono::steady_clock::now() >= ctx.Deadline)
+        {
+            ctx.Yielded = true;
+            ctx.SlicedRoot->m_slicedFrame->Pending.push_back({this, availableWidth, availableHeight, ignoreMinMax});
+            return;
+        }
+    }
+
+    // content-visibility:auto (or deferred by a progressive frame) away from the viewport: size
+    // only, leave the contents as they are. The node stays Dirty (the walk does not visit it),
+    // so a reveal re-solves it in full.
+    const bool skippable = m_Style.GetDimensions().Visibility == ContentVisibility::Auto ||
+        DefersOffscreen(ctx);
+    m_contentSkipped = skippable && m_Parent && ctx.ViewportBounded && !m_contentRevealed;
+    if (m_contentSkipped)
+    {
+        SizeSkippedContents(availableWidth, availableHeight);
+        m_lastAvailW = availableWidth;
+        m_lastAvailH = availableHeight;
+        m_implW = m_Layout.ComputedWidth;
+        m_implH = m_Layout.ComputedHeight;
+        RecordMeasure(ctx, availableWidth, availableHeight, ignoreMinMax, m_implW, m_implH);
+        return;
+    }
 
-    if (m_Style.Dirty || !spaceSame)
-        ComputeDimensions(ctx, availableWidth, availableHeight, ignoreMinMax);
+    CountCache(ctx, LayoutMissReason(availableWidth, availableHeight, ignoreMinMax));
+    // Also when only a descendant changed: a shrink-to-fit width follows the contents (re-read
+    // from the intrinsic cache, which the edit invalidated), and a flex parent's
+    // grow/shrink may have left another size in ComputedWidth/Height since the last solve.
+    ComputeDimensions(availableWidth, availableHeight, ignoreMinMax);
 
-    LayoutStrategy::For(m_Style.GetDimensions().Display).Layout(*this, ctx, availableWidth, availableHeight);
+    LayoutStrategy::For(*this).Layout(*this, ctx, availableWidth, availableHeight);
+    if (ctx.Yielded)
+    {
+        // Stopped inside: record nothing, and run this call again once the one it stopped in
+        // is finished.
+        MarkSuspended();
+        ctx.SlicedRoot->m_slicedFrame->Pending.push_back({this, availableWidth, availableHeight, ignoreMinMax});
+        return;
+    }
     ++m_Layout.StrategyRuns;
+    ++ctx.Solves;
+    m_lastAvailW = availableWidth;
+    m_lastAvailH = availableHeight;
+    m_solvedDisplay = m_Style.GetDimensions().Display;
 
     // Descendants now reflect this available-space run, not the last definite distribution;
     // the next definite pass must re-run even if its size memo matches. (Subsumes the old
@@ -304,16 +929,10 @@ void Node::LayoutImpl(LayoutContext& ctx, float availableWidth, float availableH
     m_strategyRanSinceDefinite = true;
     m_positionsDirty = true;
 
-    if (auto& position = m_Style.GetDimensions().Position; position == PositionType::Relative)
-    {
-        auto& offset = m_Style.GetOffsets();
-        m_Layout.LocalX += offset.Left.ResolveValue(availableWidth) - offset.Right.ResolveValue(availableWidth);
-        m_Layout.LocalY += offset.Top.ResolveValue(availableHeight) - offset.Bottom.ResolveValue(availableHeight);
-    }
-
-    // Only Block/InlineBlock get an AUTO-height override; flex handles its own height.
+    // Only Block/InlineBlock get an AUTO-height override; flex, grid and virtual lists handle
+    // their own height (a virtual list's is its estimated extent, not its window's).
     const auto display = m_Style.GetDimensions().Display;
-    const bool isBlock = display == OuterDisplay::Block || display == OuterDisplay::InlineBlock;
+    const bool isBlock = !m_virtual && (display == OuterDisplay::Block || display == OuterDisplay::InlineBlock);
 
     if (isBlock && m_Style.GetDimensions().Height.Unit == CSSUnit::Auto)
     {
@@ -324,7 +943,8 @@ void Node::LayoutImpl(LayoutContext& ctx, float availableWidth, float availableH
             auto& childStyle = child->m_Style;
             const auto position = childStyle.GetDimensions().Position;
             auto& childMargin = childStyle.GetMargin();
-            if (position == PositionType::Static || position == PositionType::Relative)
+            // A display:none child keeps its last layout (see SetDisplay) but has no box.
+            if (!IsOutOfFlow(position) && childStyle.GetDimensions().Display != OuterDisplay::None)
             {
                 maxChildBottom = std::max(maxChildBottom,
                                           childLayout.LocalY + childLayout.ComputedHeight + childMargin.Bottom +
@@ -343,12 +963,28 @@ void Node::LayoutImpl(LayoutContext& ctx, float availableWidth, float availableH
     // repeat same-input calls within this frame.
     m_implW = m_Layout.ComputedWidth;
     m_implH = m_Layout.ComputedHeight;
-    RecordMeasure(availableWidth, availableHeight, ignoreMinMax, m_implW, m_implH);
+    RecordMeasure(ctx, availableWidth, availableHeight, ignoreMinMax, m_implW, m_implH);
+    // Any node can be deferred by a later progressive frame, so every real solve is remembered.
+    m_rememberedW = m_implW;
+    m_rememberedH = m_implH;
+}
+
+void Node::MarkSuspended() noexcept
+{
+    // Neither the full-reuse early-out nor the definite-size memo may take the partial run for a
+    // finished one, also if the frame is abandoned. The parent's changed range is left alone: the
+    // parent stopped too, and a stopped strategy run keeps its own memos for that frame only.
+    m_descendantDirty = true;
+    m_strategyRanSinceDefinite = true;
+    m_positionsDirty = true;
 }
 
 void Node::LayoutContentsWithDefiniteSize(LayoutContext& ctx, float borderBoxWidth, float borderBoxHeight)
 {
     PullGeneration();
+    const TraceSlice trace(ctx, TraceSliceKind::DefiniteSize, LayoutTracer::NoDetail, this, borderBoxWidth,
+                           borderBoxHeight);
+    const ProfileScope profile(ctx, this, m_Layout.StrategyRuns);
 
     if (m_Style.GetDimensions().Display == OuterDisplay::None) return;
     if (m_Children.empty()) return; // leaf: nothing to re-lay-out
@@ -357,6 +993,7 @@ void Node::LayoutContentsWithDefiniteSize(LayoutContext& ctx, float borderBoxWid
     // Adopt the border-box size decided by the flex parent (main) and the cross-axis stretch.
     m_Layout.ComputedWidth = borderBoxWidth;
     m_Layout.ComputedHeight = borderBoxHeight;
+    if (m_contentSkipped) return; // offscreen content-visibility:auto: contents stay unsolved
 
     // The memo is only meaningful while the descendants still reflect the last definite
     // distribution; any impl-path strategy run since then repositioned them.
@@ -368,12 +1005,15 @@ void Node::LayoutContentsWithDefiniteSize(LayoutContext& ctx, float borderBoxWid
     // distribution already ran this generation (the flex parent's second pass).
     if (stillDefinite &&
         ((!m_Style.Dirty && !m_descendantDirty) || (m_generation != 0 && m_defGeneration == m_generation)))
+    {
+        CountCache(ctx, CacheEvent::DefiniteHit);
         return;
-
-    m_strategyRanSinceDefinite = false;
-    m_lastDefW = borderBoxWidth;
-    m_lastDefH = borderBoxHeight;
-    m_defGeneration = m_generation;
+    }
+    CountCache(ctx, !SameSize(borderBoxWidth, m_lastDefW) || !SameSize(borderBoxHeight, m_lastDefH)
+                        ? CacheEvent::DefiniteMissSizeChanged
+                        : m_strategyRanSinceDefinite
+                        ? CacheEvent::DefiniteMissStrategyRan
+                        : CacheEvent::DefiniteMissDirty);
 
     // Border-box -> content-box for the strategy (ComputeDimensions re-adds padding+border,
     // so subtract them here exactly once).
@@ -388,11 +1028,19 @@ void Node::LayoutContentsWithDefiniteSize(LayoutContext& ctx, float borderBoxWid
     // and discard the adopted size). MainSizeIsDefinite tells flex to fill, not shrink-wrap;
     // CrossSizeIsDefinite tells a single flex line to clamp to this border box, not grow to a
     // taller item (the parent fixed both axes here).
-    m_mainSizeDefinite = true;
-    m_crossSizeDefinite = true;
-    LayoutStrategy::For(m_Style.GetDimensions().Display).Layout(*this, ctx, contentWidth, contentHeight);
-    m_mainSizeDefinite = false;
-    m_crossSizeDefinite = false;
+    {
+        DefiniteSizeScope definite(m_mainSizeDefinite, m_crossSizeDefinite);
+        LayoutStrategy::For(*this).Layout(*this, ctx, contentWidth, contentHeight);
+    }
+    if (ctx.Yielded)
+    {
+        MarkSuspended();
+        return;
+    }
+    m_strategyRanSinceDefinite = false;
+    m_lastDefW = borderBoxWidth;
+    m_lastDefH = borderBoxHeight;
+    m_defGeneration = m_generation;
     ++m_Layout.StrategyRuns;
     m_positionsDirty = true;
 
@@ -401,7 +1049,71 @@ void Node::LayoutContentsWithDefiniteSize(LayoutContext& ctx, float borderBoxWid
     m_Layout.ComputedHeight = borderBoxHeight;
 }
 
-void Node::ComputeDimensions(LayoutContext& ctx, float availableWidth, float availableHeight, bool ignoreMinMax)
+float Node::GetIntrinsicSize(IntrinsicSizing sizing, LayoutAxis axis)
+{
+    const auto& dimensions = m_Style.GetDimensions();
+    // Ahead of the cache: hiding a node (SetDisplay) flags only its ancestors.
+    if (dimensions.Display == OuterDisplay::None) return 0.0f;
+    const std::size_t index = static_cast<std::size_t>(sizing) * 2 + static_cast<std::size_t>(axis);
+    const auto bit = static_cast<std::uint8_t>(1u << index);
+    if (!(m_intrinsicValid & bit))
+    {
+        m_intrinsic[index] = ComputeIntrinsicSize(sizing, axis, false);
+        m_intrinsicValid |= bit;
+    }
+    return m_intrinsic[index];
+}
+
+float Node::ComputeIntrinsicSize(IntrinsicSizing sizing, LayoutAxis axis, bool ignoreMinMax)
+{
+    const auto& dimensions = m_Style.GetDimensions();
+    const bool horizontal = axis == LayoutAxis::Horizontal;
+    const CSSValue& size = horizontal ? dimensions.Width : dimensions.Height;
+    const CSSValue& minSize = horizontal ? dimensions.MinWidth : dimensions.MinHeight;
+    const CSSValue& maxSize = horizontal ? dimensions.MaxWidth : dimensions.MaxHeight;
+    auto& padding = m_Style.GetPadding();
+    auto& border = m_Style.GetBorder();
+    const float inset = horizontal
+        ? padding.Left + padding.Right + border.WidthLeft + border.WidthRight
+        : padding.Top + padding.Bottom + border.WidthTop + border.WidthBottom;
+
+    // As ComputeDimensions sizes the box: an explicit size is the border box, an AUTO one the
+    // content plus padding and border, min/max clamping before padding is added.
+    const bool explicitSize = size.IsLength();
+    float result = explicitSize ? size.Length() : LayoutStrategy::For(*this).IntrinsicContentSize(*this, sizing, axis);
+    if (!ignoreMinMax && minSize.IsLength()) result = std::max(result, minSize.Length());
+    if (!ignoreMinMax && maxSize.IsLength()) result = std::min(result, maxSize.Length());
+    if (!explicitSize) result += inset;
+    return result;
+}
+
+float Node::OuterIntrinsicSize(IntrinsicSizing sizing, LayoutAxis axis, bool ignoreMinMax)
+{
+    const auto& dimensions = m_Style.GetDimensions();
+    const bool horizontal = axis == LayoutAxis::Horizontal;
+    const auto& margin = m_Style.GetMargin();
+    const float margins = horizontal
+        ? margin.Left.ResolveValue(0.0f) + margin.Right.ResolveValue(0.0f)
+        : margin.Top.ResolveValue(0.0f) + margin.Bottom.ResolveValue(0.0f);
+    const bool clamped = (horizontal ? dimensions.MinWidth : dimensions.MinHeight).IsLength() ||
+        (horizontal ? dimensions.MaxWidth : dimensions.MaxHeight).IsLength();
+    if (ignoreMinMax && clamped && dimensions.Display != OuterDisplay::None)
+        return ComputeIntrinsicSize(sizing, axis, true) + margins;
+    return GetIntrinsicSize(sizing, axis) + margins;
+}
+
+float Node::ShrinkToFitWidth(float availableWidth)
+{
+    const float maxContent = GetIntrinsicSize(IntrinsicSizing::MaxContent, LayoutAxis::Horizontal);
+    if (std::isnan(availableWidth)) return maxContent;
+    const auto& margin = m_Style.GetMargin();
+    const float space = availableWidth - margin.Left.ResolveValue(availableWidth) -
+        margin.Right.ResolveValue(availableWidth);
+    return std::min(std::max(GetIntrinsicSize(IntrinsicSizing::MinContent, LayoutAxis::Horizontal), space),
+                    maxContent);
+}
+
+void Node::ComputeDimensions(float availableWidth, float availableHeight, bool ignoreMinMax)
 {
     auto& dimensions = m_Style.GetDimensions();
     auto& width = dimensions.Width;
@@ -413,17 +1125,17 @@ void Node::ComputeDimensions(LayoutContext& ctx, float availableWidth, float ava
     auto& maxHeight = dimensions.MaxHeight;
     const auto display = dimensions.Display;
     float computedWidth = NAN, computedHeight = NAN;
-    if (width.Unit == CSSUnit::Px)
+    if (width.IsLength())
     {
-        computedWidth = width.Value;
+        computedWidth = width.Length();
     }
-    else if (width.Unit == CSSUnit::Percent)
+    else if (width.HasPercentage())
     {
-        computedWidth = availableWidth * (width / 100.0f);
+        computedWidth = width.ResolveValue(availableWidth);
     }
     else
     {
-        if (display == OuterDisplay::Block || display == OuterDisplay::Flex)
+        if (display == OuterDisplay::Block || display == OuterDisplay::Flex || display == OuterDisplay::Grid)
         {
             auto& margin = m_Style.GetMargin();
             auto& padding = m_Style.GetPadding();
@@ -443,16 +1155,12 @@ void Node::ComputeDimensions(LayoutContext& ctx, float availableWidth, float ava
         }
         else if (display == OuterDisplay::Inline || display == OuterDisplay::InlineBlock)
         {
-            computedWidth = 100.0f; // Placeholder: known limitation, no shrink-to-fit floor yet
-            for (const auto& child : m_Children)
-            {
-                child->LayoutImpl(ctx, availableWidth, availableHeight);
-                auto& childLayout = child->m_Layout;
-                auto& childStyle = child->m_Style;
-                computedWidth = std::max(computedWidth, childLayout.ComputedWidth +
-                                         childStyle.GetMargin().Left.ResolveValue(0) + childStyle.GetMargin().
-                                         Right.ResolveValue(0));
-            }
+            // Shrink-to-fit from the cached intrinsic widths; the content size (padding and
+            // border are re-added below).
+            auto& padding = m_Style.GetPadding();
+            auto& border = m_Style.GetBorder();
+            computedWidth = std::max(0.0f, ShrinkToFitWidth(availableWidth) - padding.Left - padding.Right -
+                                     border.WidthLeft - border.WidthRight);
         }
     }
     auto& stylePadding = m_Style.GetPadding();
@@ -464,8 +1172,8 @@ void Node::ComputeDimensions(LayoutContext& ctx, float availableWidth, float ava
 
     // Explicit Px/Percent sizes are border-box (padding+border inset the content); the AUTO
     // branches produced a content size, so only those re-add padding+border below.
-    const bool widthIsExplicit = (width.Unit == CSSUnit::Px || width.Unit == CSSUnit::Percent);
-    const bool heightIsExplicit = (height.Unit == CSSUnit::Px || height.Unit == CSSUnit::Percent);
+    const bool widthIsExplicit = (width.IsLength() || width.HasPercentage());
+    const bool heightIsExplicit = (height.IsLength() || height.HasPercentage());
 
     if (!std::isnan(computedWidth))
     {
@@ -481,15 +1189,15 @@ void Node::ComputeDimensions(LayoutContext& ctx, float availableWidth, float ava
     }
 
 
-    if (height.Unit == CSSUnit::Px)
+    if (height.IsLength())
     {
-        computedHeight = height.Value;
+        computedHeight = height.Length();
     }
-    else if (height.Unit == CSSUnit::Percent)
+    else if (height.HasPercentage())
     {
         if (!std::isnan(availableHeight))
         {
-            computedHeight = availableHeight * (height.Value / 100.0f);
+            computedHeight = height.ResolveValue(availableHeight);
         }
     }
     if (!std::isnan(computedHeight))
@@ -599,19 +1307,3 @@ void Node::PositionOutOfFlowChild(Node* ancestor, float refWidth, float refHeigh
         if (autoY) m_Layout.ComputedY = staticY;
     }
 }
-
-void Node::HandleStickyPosition(float /*refWidth*/, float refHeight)
-{
-    // TODO: wire a real scroll offset; sticky is only clamped within the parent bounds for now.
-    const float scrollY = 0;
-
-    auto& dimensions = m_Style.GetDimensions();
-    const float stickyTop = dimensions.Top.ResolveValue(refHeight);
-
-    const float parentTop = m_Layout.ComputedY;
-    const float parentBottom = m_Layout.ComputedY + m_Layout.ComputedHeight;
-
-    float newStickyY = std::max(parentTop + stickyTop, scrollY + stickyTop);
-    newStickyY = std::min(newStickyY, parentBottom - m_Layout.ComputedHeight);
-    m_Layout.ComputedY = newStickyY;
-}
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
@@ -11,6 +13,9 @@
 
 
 #include "Layout.h"
+#include "LayoutStats.h"
+#include "MutationTrace.h"
+#include "VirtualList.h"
 
 
 namespace masharif
@@ -28,18 +33,76 @@ namespace masharif
             SetDisplay(display);
         }
 
+        ~Node()
+        {
+            if (m_traceStyle)
+                if (MutationTrace* trace = MutationTrace::Active()) trace->OnDestroy(*this);
+        }
+
         [[nodiscard]] Layout& GetLayout() { return m_Layout; }
 
         [[nodiscard]] Style& GetStyle() { return m_Style; }
 
+        [[nodiscard]] const Style& GetStyle() const { return m_Style; }
+
         /// Solve this subtree against the given available space, then derive absolute
         /// positions and clear dirty flags: the per-frame entry point.
         void Calculate(float availableWidth, float availableHeight);
 
+        /// Calculate for a frame showing `viewport`: ContentVisibility::Auto subtrees away from it
+        /// are sized by their placeholder and neither solved nor walked. Ones that come near are
+        /// solved within the same call, so the frame ends fully laid out where it is visible.
+        void Calculate(float availableWidth, float availableHeight, const ViewportRect& viewport);
+
+        /// Progressive first pass for `viewport`: like Calculate(…, viewport), but every block
+        /// box with contents in normal flow is treated as content-visibility:auto, so only the
+        /// subtrees near the viewport are solved and the rest keep a placeholder (their last
+        /// size, else contain-intrinsic-size). Complete the frame with Calculate or
+        /// CalculateFor at the same space; until then HasDeferredLayout() is true.
+        void CalculateVisibleFirst(float availableWidth, float availableHeight, const ViewportRect& viewport);
+
+        /// Some subtree was left unsolved by a progressive or viewport-bounded frame.
+        [[nodiscard]] bool HasDeferredLayout() const noexcept { return m_deferredInSubtree; }
+
+        /// Time-sliced Calculate: solves until `deadline` and returns, keeping the work done
+        /// (Done == false); call again, e.g. next frame, with the same space to continue. The
+        /// next slice starts at the solve the last one stopped before, then finishes the solves
+        /// it was nested in, innermost first: finished subtrees replay from the frame's measure
+        /// cache and a normal-flow container continues at the child it stopped on.
+        /// GetPublishedBox keeps the last completed frame until the root is solved (completing a
+        /// viewport frame takes a pass per reveal, each published as it ends). Editing the tree
+        /// between slices restarts the frame; a plain Calculate abandons it.
+        LayoutProgress CalculateFor(float availableWidth, float availableHeight,
+                                    std::chrono::steady_clock::time_point deadline);
+
+        /// Absolute box of this node in the last completed frame. Matches GetLayout() after
+        /// Calculate, but never shows a CalculateFor frame that is still in progress.
+        [[nodiscard]] const LayoutBox& GetPublishedBox() const noexcept { return m_published; }
+
+        /// Per-phase time and call counts of this root's last Calculate (of the last slice, for
+        /// CalculateFor). Empty (Enabled == false) unless built with MASHARIF_LAYOUT_STATS.
+        [[nodiscard]] const LayoutStats& GetLayoutStats() const noexcept;
+
+        /// Tree-wide reuse-check counts of this root's last Calculate (of the last slice, for
+        /// CalculateFor): which memo served each solve request, and why the others missed.
+        [[nodiscard]] const CacheStats& GetCacheStats() const noexcept;
+
+#ifdef MASHARIF_NODE_CACHE_STATS
+        /// This node's reuse-check counts in the last frame that reached it (Debug builds).
+        [[nodiscard]] const CacheStats& GetNodeCacheStats() const noexcept { return m_nodeCacheStats; }
+#endif
+
         /// Standalone solve at the given available space (builds its own LayoutContext).
         /// Unlike Calculate it neither clears dirty flags nor derives absolute positions.
         void LayoutImpl(float availableWidth, float availableHeight, bool ignoreMinMax = false);
 
+        /// Border-box size of this node on `axis` under a min-content or max-content constraint,
+        /// without laying anything out: explicit px sizes as given, AUTO (and percentage, whose
+        /// basis is unknown here) ones from the children's intrinsic sizes as this node's layout
+        /// strategy combines them. Computed bottom-up and cached per node until a change in the
+        /// subtree (MarkDirtyToRoot) invalidates it.
+        [[nodiscard]] float GetIntrinsicSize(IntrinsicSizing sizing, LayoutAxis axis);
+
         [[nodiscard]] Node* Parent() const { return m_Parent; }
 
         [[nodiscard]] const std::vector<SharedNode>& Children() const noexcept { return m_Children; }
@@ -49,22 +112,39 @@ namespace masharif
         /// stale handles).
         void SetChildren(std::vector<SharedNode> children)
         {
-            for (auto& child : children) child->SetParent(this);
+            for (std::size_t i = 0; i < children.size(); ++i)
+            {
+                children[i]->SetParent(this);
+                children[i]->m_indexInParent = static_cast<std::uint32_t>(i);
+            }
             m_Children = std::move(children);
+            m_flowTable.Offsets.clear();
+            m_OutOfFlowChildren.clear(); // may point into the dropped children
+            NoteStructureChange();
+            NoteChangedChildren(0, m_Children.size());
             MarkDirtyToRoot();
+            if (MutationTrace* trace = MutationTrace::Active()) trace->OnSetChildren(*this);
         }
 
         void ClearChildren()
         {
             m_Children.clear();
+            m_flowTable.Offsets.clear();
+            m_OutOfFlowChildren.clear();
+            NoteStructureChange();
             MarkDirtyToRoot();
+            if (MutationTrace* trace = MutationTrace::Active()) trace->OnClearChildren(*this);
         }
 
         void AddChild(const SharedNode& child)
         {
             m_Children.push_back(child);
             child->SetParent(this);
+            child->m_indexInParent = static_cast<std::uint32_t>(m_Children.size() - 1);
+            NoteStructureChange();
+            NoteChangedChildren(m_Children.size() - 1, m_Children.size());
             MarkDirtyToRoot();
+            if (MutationTrace* trace = MutationTrace::Active()) trace->OnAddChild(*this, *child);
         }
 
         void RemoveChild(SharedNode& child);
@@ -75,8 +155,23 @@ namespace masharif
 
         /// Pure style write: the layout algorithm is selected from the display type at solve
         /// time (LayoutStrategy::For), so switching display allocates nothing.
+        ///
+        /// Hiding (to None) and re-showing with the display the node was last solved with only
+        /// change whether the box exists, which is the parent's concern: the node keeps its
+        /// cached layout, so showing it again at the same space is a full-reuse hit plus a
+        /// positions pass (tab switching). Writing Display through Modify<Dimensions> instead
+        /// treats the toggle as an ordinary change and re-solves the node.
         void SetDisplay(OuterDisplay display)
         {
+            const OuterDisplay current = m_Style.GetDimensions().Display;
+            if (display == current) return;
+            if (display == OuterDisplay::None || display == m_solvedDisplay)
+            {
+                m_Style.SetDisplayRetainingLayout(display);
+                MarkAncestorsDirty();
+                if (MutationTrace* trace = MutationTrace::Active()) trace->OnSetDisplay(*this, display);
+                return;
+            }
             GetStyle().Modify<Dimensions>().Display = display;
         }
 
@@ -85,9 +180,57 @@ namespace masharif
         /// GetStyle().Dirty write) still need it explicitly.
         void MarkDirtyToRoot();
 
+        /// The ancestors' half of MarkDirtyToRoot, for a change only the parent's layout sees
+        /// (this node's box appearing or disappearing); the node's own cache stays valid.
+        void MarkAncestorsDirty();
+
+        /// Flag a position-only change of this node: every ancestor re-runs its positions walk
+        /// (not its strategy) so the walk reaches the node's parent, which re-derives the
+        /// relative shift or re-positions the out-of-flow child. Style::ModifyOffsets and
+        /// ModifyInsets call this automatically.
+        void MarkPositionDirty();
+
+        /// Make this node a scroll port and set its scroll offset (content scrolled by x/y).
+        /// Descendant coordinates stay in the port's unscrolled content space; the offset only
+        /// moves sticky descendants, which pin against the port's visible rect. A change
+        /// re-runs the positions walk down to the sticky nodes and runs no strategy.
+        void SetScrollOffset(float x, float y);
+
+        [[nodiscard]] float ScrollOffsetX() const { return m_scrollX; }
+
+        [[nodiscard]] float ScrollOffsetY() const { return m_scrollY; }
+
+        /// Root only: the font size Rem and Em lengths resolve to (16 by default). A change
+        /// re-solves, on the next frame, only the nodes using those units.
+        void SetRootFontSize(float size);
+
+        [[nodiscard]] float RootFontSize() const { return m_rootFontSize; }
+
+        /// Make this node a virtual list over `source` (nullptr makes it a plain node again).
+        /// Its children are then only the items intersecting the visible block range — scroll
+        /// offset plus content height, or the available height when the height is AUTO — and
+        /// `overscan` items either side, materialized while laying out and stacked as blocks;
+        /// every other item never exists as a node. Call MarkDirtyToRoot when the items change.
+        void SetVirtualSource(std::shared_ptr<VirtualListSource> source, std::size_t overscan = 2);
+
+        [[nodiscard]] bool IsVirtualList() const noexcept { return m_virtual != nullptr; }
+
+        /// Source index of the first materialized child of a virtual list.
+        [[nodiscard]] std::size_t VirtualFirstIndex() const noexcept { return m_virtual ? m_virtual->First : 0; }
+
+        /// Block-axis extent of all items of a virtual list: the laid-out window plus the
+        /// running estimate for the rest. The list's scroll extent.
+        [[nodiscard]] float VirtualExtent() const noexcept { return m_virtual ? m_virtual->Extent : 0.0f; }
+
     private:
         friend class FlexLayoutStrategy;
         friend class NormalFlowStrategy;
+        friend class GridLayoutStrategy;
+        friend class VirtualListStrategy;
+        friend class TreeBuilder;
+        friend class Snapshot;
+        friend class LayoutExporter;
+        friend class MutationTrace;
 
         void LayoutImpl(LayoutContext& ctx, float availableWidth, float availableHeight,
                         bool ignoreMinMax = false);
@@ -97,16 +240,85 @@ namespace masharif
         /// flex-basis phase measures AUTO items against NaN and collapses them to 0.
         void LayoutContentsWithDefiniteSize(LayoutContext& ctx, float borderBoxWidth, float borderBoxHeight);
 
+        /// A time-sliced solve stopped inside this node's strategy run: flag the node so that
+        /// nothing reuses the partly solved subtree as a result.
+        void MarkSuspended() noexcept;
+
+        /// One frame: solve and walk, again while the walk reveals skipped subtrees. A reveal
+        /// changes a placeholder size once (solved subtrees keep their size when they go
+        /// offscreen), so the passes settle.
+        void CalculateFrame(LayoutContext& ctx, float availableWidth, float availableHeight);
+
+        /// Reset this root's LayoutStats and collect the frame in `ctx` into them (no-op unless
+        /// built with MASHARIF_LAYOUT_STATS).
+        void AttachLayoutStats(LayoutContext& ctx);
+
+        /// Keep the reuse-check counts of the frame in `ctx` as this root's GetCacheStats.
+        void PublishCacheStats(const LayoutContext& ctx);
+
+        /// Make this frame's box the published one; a box that changed is queued for the next
+        /// LayoutExporter::Export.
+        void Publish() noexcept;
+
+        /// Count a change to some child list, for LayoutExporter (whose node indices it
+        /// invalidates). Per thread, like the tree edit count.
+        static void NoteStructureChange() noexcept;
+
+        [[nodiscard]] static std::uint64_t StructureChanges() noexcept;
+
+        /// Second half of a frame once the root is solved: root origin, positions walk, and
+        /// publication of every box the walk re-derived.
+        void FinishFrame(LayoutContext& ctx, float availableWidth, float availableHeight);
+
+        /// Placeholder sizing of a ContentVisibility::Auto node whose contents are skipped:
+        /// explicit sizes and a block's fill width as usual, AUTO sizes from the last laid-out
+        /// size or else contain-intrinsic-size. Never descends.
+        void SizeSkippedContents(float availableWidth, float availableHeight);
+
+        /// Whether a progressive frame may defer this node like a content-visibility:auto one.
+        [[nodiscard]] bool DefersOffscreen(const LayoutContext& ctx) const;
+
+        /// GetIntrinsicSize plus the margins on `axis` (a percentage margin counts as 0): the
+        /// node's contribution to its parent's intrinsic size. With ignoreMinMax, the size before
+        /// min/max clamping (a flex base size), computed afresh when a clamp applies.
+        [[nodiscard]] float OuterIntrinsicSize(IntrinsicSizing sizing, LayoutAxis axis, bool ignoreMinMax = false);
+
+        /// GetIntrinsicSize's computation, uncached.
+        [[nodiscard]] float ComputeIntrinsicSize(IntrinsicSizing sizing, LayoutAxis axis, bool ignoreMinMax);
+
+        /// Shrink-to-fit border-box width in `availableWidth` (the space for the margin box):
+        /// min(max(min-content, available), max-content), the max-content width when NaN.
+        [[nodiscard]] float ShrinkToFitWidth(float availableWidth);
+
+        /// Walk-time content-visibility decision for a node just positioned; true when its
+        /// contents stay skipped, so the walk must not descend into it. `positionUnknown`: a
+        /// sibling above still stands in with a size never solved, so this node's position is
+        /// not real yet and it may not be revealed in this pass.
+        bool UpdateContentVisibility(LayoutContext& ctx, bool positionUnknown = false);
+
+        /// Positions walk of this subtree: StartUpdatingPositions then PositionOutOfFlowChildren,
+        /// entered as the innermost scroll port when this node is one.
+        void WalkPositions(LayoutContext& ctx);
+
         void StartUpdatingPositions(LayoutContext& ctx);
 
         void PositionOutOfFlowChildren(LayoutContext& ctx);
 
-        void ComputeDimensions(LayoutContext& ctx, float availableWidth, float availableHeight,
-                               bool ignoreMinMax = false);
+        /// End of this node's walk: recompute the *InSubtree flags from the children, which
+        /// the walk has already visited (or left unchanged).
+        void AggregateSubtreeFlags();
 
-        void PositionOutOfFlowChild(Node* ancestor, float refWidth, float refHeight);
+        /// Frame start at the root: install its UnitContext and, where that changed since the
+        /// last frame, dirty the nodes whose lengths depend on it.
+        void ApplyUnitContext(float availableWidth, float availableHeight);
+
+        /// MarkDirtyToRoot every descendant whose m_unitDependencies intersect `changed`,
+        /// entering only subtrees flagged m_unitsInSubtree.
+        void DirtyUnitDependents(std::uint8_t changed);
 
-        void HandleStickyPosition(float refWidth, float refHeight);
+        void ComputeDimensions(float availableWidth, float availableHeight, bool ignoreMinMax = false);
+
+        void PositionOutOfFlowChild(Node* ancestor, float refWidth, float refHeight);
 
         void SetParent(Node* parent)
         {
@@ -153,12 +365,32 @@ namespace masharif
                 m_generation = m_Parent->m_generation;
         }
 
-        void RecordMeasure(float availW, float availH, bool ignoreMinMax,
+        void RecordMeasure(LayoutContext& ctx, float availW, float availH, bool ignoreMinMax,
                            float resultW, float resultH);
 
+        /// Why LayoutImpl found nothing to reuse at these inputs.
+        [[nodiscard]] CacheEvent LayoutMissReason(float availW, float availH, bool ignoreMinMax) const;
+
+        /// Count a reuse check in the frame's CacheStats (and the node's own, in Debug builds).
+        void CountCache(LayoutContext& ctx, CacheEvent event);
+
         [[nodiscard]] const MeasureCacheEntry* FindMeasure(float availW, float availH,
                                                            bool ignoreMinMax) const;
 
+        /// Widen the range of children changed since the flags were last cleared; see
+        /// m_changedBegin.
+        void NoteChangedChildren(std::size_t begin, std::size_t end)
+        {
+            m_changedBegin = std::min(m_changedBegin, static_cast<std::uint32_t>(begin));
+            m_changedEnd = std::max(m_changedEnd, static_cast<std::uint32_t>(end));
+        }
+
+        void ClearChangedChildren()
+        {
+            m_changedBegin = UINT32_MAX;
+            m_changedEnd = 0;
+        }
+
         /// Frame stamps are only comparable within one tree; clear them when this node is
         /// re-parented so entries from another tree's counter can never match.
         void ResetFrameStamps()
@@ -175,7 +407,7 @@ namespace masharif
 
         std::vector<SharedNode> m_Children;
 
-        /// Out-of-flow (absolute/fixed/sticky) children diverted by the last strategy run;
+        /// Out-of-flow (absolute/fixed) children diverted by the last strategy run;
         /// (re-)laid-out and positioned by the positions walk. Persisted (not cleared after
         /// positioning) so a move-only frame can re-position them against a moved containing
         /// block; the strategy clears and repopulates it on every real layout run.
@@ -190,6 +422,116 @@ namespace masharif
         /// m_Style.Dirty nor m_DescendantDirty (and unchanged space) reuses its cached layout.
         bool m_descendantDirty = false;
 
+        /// This node's index in its parent's m_Children, kept current by every child-list
+        /// mutator so MarkDirtyToRoot can report which child changed in O(1).
+        std::uint32_t m_indexInParent = 0;
+
+        /// Half-open range [begin, end) of children that were dirtied, added or removed since
+        /// the flags were last cleared (end of frame, alongside m_descendantDirty). Children
+        /// outside it are clean, so a strategy that can resume from a table may skip them.
+        /// Empty when begin >= end.
+        std::uint32_t m_changedBegin = UINT32_MAX;
+        std::uint32_t m_changedEnd = 0;
+
+        /// Running offset table of the last NormalFlowStrategy run: Offsets[i] is the block
+        /// cursor (y) before child i when no inline line is open there, NaN otherwise, and the
+        /// extra last entry is the cursor after the final child. Valid only
+        /// while Run equals StrategyRuns (no other strategy run since) and the inputs match;
+        /// lets a run resume at the first changed child and shift the clean tail by a delta.
+        /// Suspended is the generation of the frame a time-sliced solve stopped the run in (0
+        /// otherwise): the table then ends at the child it stopped on, where that frame resumes.
+        struct FlowOffsetTable
+        {
+            std::uint32_t Run = 0;
+            float AvailW = NAN, AvailH = NAN;
+            float OriginX = NAN, OriginY = NAN;
+            std::uint64_t Suspended = 0;
+            std::vector<float> Offsets;
+        };
+
+        FlowOffsetTable m_flowTable;
+
+        /// Per-child record of the last FlexLayoutStrategy run, indexed like m_Children.
+        struct FlexItemMemo
+        {
+            bool InFlow = false;
+            float MainPos = 0; ///< main-axis cursor before the item's start margin
+            float Outer = 0; ///< start margin + resolved main size + end margin
+            float Taken = 0; ///< the item's share of FlexLine::TakenSize (margins + basis)
+            float Cross = 0; ///< measured cross size (before stretch)
+            float Grow = 0;
+            float ShrinkScaled = 0;
+        };
+
+        /// Summary of the last flex run when it produced a single inflexible flex-start line
+        /// whose main size does not depend on content (Eligible). Valid only while Run equals
+        /// StrategyRuns and the inputs match; lets a run whose only change is one item's size
+        /// re-measure that item and translate its successors instead of re-solving the line.
+        struct FlexLineMemo
+        {
+            std::uint32_t Run = 0;
+            bool Eligible = false;
+            bool MainDefinite = false, CrossDefinite = false;
+            float AvailW = NAN, AvailH = NAN; ///< strategy inputs
+            float EntryW = NAN, EntryH = NAN; ///< container size on entry...
+            float ExitW = NAN, ExitH = NAN; ///< ...and as the run left it
+            float MeasureAvailW = NAN, MeasureAvailH = NAN; ///< space the bases were measured in
+            float ResolvedAvailW = NAN, ResolvedAvailH = NAN; ///< space after ResolveContainerSize
+            float AvailableSpace = 0; ///< main-axis content size the line was resolved in
+            float TakenSize = 0, TotalGrow = 0, TotalShrinkScaled = 0;
+            float MaxCross = 0; ///< tallest measured item; the line's natural cross size
+            float LineCrossStart = 0, LineCrossSize = 0;
+            std::vector<FlexItemMemo> Items;
+        };
+
+        FlexLineMemo m_flexMemo;
+
+        /// Grid area of one child in the last GridLayoutStrategy run (0-based tracks).
+        struct GridArea
+        {
+            std::uint32_t Row = 0, Column = 0;
+            std::uint32_t RowSpan = 1, ColumnSpan = 1;
+            bool InFlow = false;
+        };
+
+        /// Placement and track sizes of the last GridLayoutStrategy run. Valid only while Run
+        /// equals StrategyRuns: the placement while no child's style changed, the column sizes
+        /// while the content width matches (and, when they depend on content, no child changed),
+        /// the row sizes likewise against the content height.
+        struct GridMemo
+        {
+            std::uint32_t Run = 0;
+            std::uint32_t ChildCount = 0;
+            float ContentW = NAN, ContentH = NAN;
+            bool ColumnsIntrinsic = false, RowsIntrinsic = false;
+            /// Generation of the frame a time-sliced solve stopped the run in (0 otherwise), and
+            /// which track sizes that run had finished.
+            std::uint64_t Suspended = 0;
+            bool ColumnsSized = false, RowsSized = false;
+            std::vector<GridArea> Areas; ///< indexed like m_Children
+            std::vector<float> Columns, Rows; ///< resolved track sizes
+            std::vector<float> ColumnStarts, RowStarts; ///< track offsets in the content box
+            std::vector<std::uint8_t> Occupied; ///< auto-placement scratch, row-major
+        };
+
+        GridMemo m_gridMemo;
+
+        /// Virtual list state (SetVirtualSource); null for every other node. m_Children holds
+        /// the materialized window, items [First, First + m_Children.size()).
+        struct VirtualListState
+        {
+            std::shared_ptr<VirtualListSource> Source;
+            std::size_t Overscan = 2;
+            std::size_t First = 0;
+            float Estimate = 1.0f; ///< per-item block size assumed for unmeasured items
+            double MeasuredSum = 0.0; ///< running sum / count of measured item sizes
+            std::size_t MeasuredCount = 0;
+            float Extent = 0.0f;
+            std::vector<SharedNode> Window; ///< scratch for the next window, kept warm
+        };
+
+        std::unique_ptr<VirtualListState> m_virtual;
+
         /// See MainSizeIsDefinite().
         bool m_mainSizeDefinite = false;
 
@@ -201,10 +543,111 @@ namespace masharif
         /// re-run even when its size memo matches. Subsumes the old shrink-wrap special case.
         bool m_strategyRanSinceDefinite = false;
 
-        /// Set whenever a strategy runs for this node (its children were repositioned);
-        /// consumed by the gated StartUpdatingPositions walk.
+        /// Set whenever a strategy runs for this node (its children were repositioned), and on
+        /// every ancestor of a position-only change; consumed by the gated StartUpdatingPositions
+        /// walk.
         bool m_positionsDirty = false;
 
+        /// Scroll port state (SetScrollOffset). m_scrollChanged is consumed by the next
+        /// positions walk, which then re-pins every sticky descendant of the port.
+        bool m_scrollPort = false;
+        bool m_scrollChanged = false;
+        float m_scrollX = 0.0f, m_scrollY = 0.0f;
+
+        /// Some descendant reachable by the positions walk is position:sticky. Recomputed from
+        /// the children whenever the walk visits this node (AggregateSubtreeFlags, after them);
+        /// a skipped subtree is unchanged, so its flag stays valid. Lets a scroll-only walk skip
+        /// subtrees with nothing to re-pin.
+        bool m_stickyInSubtree = false;
+
+        /// Same, for ContentVisibility::Auto descendants and skipped subtrees: lets a walk after
+        /// a viewport move reach every one of them without visiting the rest.
+        bool m_autoVisibilityInSubtree = false;
+
+        /// Style::UnitDependencies of this node, re-read by the walk whenever its style was
+        /// written, and whether some descendant has any: the registry a UnitContext change
+        /// walks (DirtyUnitDependents) instead of the whole tree.
+        std::uint8_t m_unitDependencies = 0;
+        bool m_unitsInSubtree = false;
+
+        /// Same, for skipped subtrees only (HasDeferredLayout).
+        bool m_deferredInSubtree = false;
+
+        /// Display of the last strategy run from LayoutImpl: the layout the node's cache holds.
+        /// None until the first solve. See SetDisplay.
+        OuterDisplay m_solvedDisplay = OuterDisplay::None;
+
+        /// content-visibility:auto state, also used for the subtrees a progressive frame defers
+        /// (DefersOffscreen). m_contentRevealed is the last walk's "near the viewport" decision;
+        /// m_contentSkipped says the last solve only sized this node (its contents are stale
+        /// and not walked). The remembered size is the last real solve's, reused as placeholder
+        /// so a subtree scrolling away does not change size.
+        bool m_contentRevealed = false;
+        bool m_contentSkipped = false;
+        float m_rememberedW = NAN, m_rememberedH = NAN;
+
+        /// See GetPublishedBox. Written by the positions walk, which visits the parent of every
+        /// box that can have changed.
+        LayoutBox m_published;
+
+        /// LayoutExporter state: this node's entry in the export, whether its published box (or
+        /// local origin) changed since it was last exported, and whether some descendant's did.
+        std::uint32_t m_exportIndex = 0;
+        bool m_exportPending = false;
+        bool m_exportPendingInSubtree = false;
+        float m_publishedLocalX = NAN, m_publishedLocalY = NAN;
+
+        /// MutationTrace state: this node's id in the trace being recorded (0 outside the
+        /// recorded tree) and which kinds of style write it has pending (MutationTrace::OnStyle).
+        std::uint32_t m_traceId = 0;
+        std::uint8_t m_traceStyle = 0;
+
+        /// A LayoutImpl call a time-sliced solve stopped in, and its inputs. Non-owning: the
+        /// frame holding it restarts on any tree edit, before a removed node could be reached.
+        struct PendingSolve
+        {
+            Node* Target = nullptr;
+            float AvailW = NAN, AvailH = NAN;
+            bool IgnoreMinMax = false;
+        };
+
+        /// Root only: the unfinished frame of CalculateFor, if any. Pending is its work stack:
+        /// the calls still to (re)run, the next one at the back.
+        struct SlicedFrame
+        {
+            std::uint64_t Generation = 0;
+            float AvailW = NAN, AvailH = NAN;
+            std::uint64_t Edits = 0; ///< tree edit count when the last slice returned
+            LayoutProgress Progress;
+            std::vector<PendingSolve> Pending;
+        };
+
+        std::unique_ptr<SlicedFrame> m_slicedFrame;
+
+#ifdef MASHARIF_LAYOUT_STATS
+        /// Root only: GetLayoutStats, allocated by the first Calculate.
+        std::unique_ptr<LayoutStats> m_stats;
+#endif
+
+        /// Root only: GetCacheStats, allocated by the first Calculate.
+        std::unique_ptr<CacheStats> m_cacheStats;
+
+#ifdef MASHARIF_NODE_CACHE_STATS
+        /// GetNodeCacheStats, and the generation they were counted under (reset on the first
+        /// count of a newer one).
+        CacheStats m_nodeCacheStats;
+        std::uint64_t m_nodeCacheGeneration = 0;
+#endif
+
+        /// Root only: the previous viewport frame's viewport, to detect a moved viewport.
+        ViewportRect m_lastViewport;
+        bool m_hadViewport = false;
+
+        /// Root only: SetRootFontSize, and the UnitContext of the last frame (NaN before the
+        /// first) to detect which references changed.
+        float m_rootFontSize = 16.0f;
+        float m_unitsWidth = NAN, m_unitsHeight = NAN, m_unitsFontSize = NAN;
+
         /// Tree-frame counter: the root owns the running value (bumped per Calculate /
         /// standalone LayoutImpl); every other node carries the stamp it last solved under.
         std::uint64_t m_generation = 0;
@@ -224,5 +667,11 @@ namespace masharif
         /// grow/shrink). Restored on the reuse early-out so a clean child reports its content
         /// size for flex-basis derivation rather than a transient grown/collapsed value.
         float m_implW = NAN, m_implH = NAN;
+
+        /// GetIntrinsicSize cache, indexed by sizing * 2 + axis; an entry is valid while its bit
+        /// is set in m_intrinsicValid. A node's entry is only computed from valid child entries, so
+        /// invalidation walks up only until an ancestor with nothing cached.
+        std::array<float, 4> m_intrinsic{};
+        std::uint8_t m_intrinsicValid = 0;
     };
 }
@@ -0,0 +1,74 @@
+#include "NodeBlock.h"
+
+#include "Node.h"
+
+#include <new>
+
+using namespace masharif;
+
+namespace {
+    /// The shared buffer: carved into equal slots, one per control block, on first use (only
+    /// then is the control block's type, and so the slot size, known).
+    struct BlockStorage {
+        std::size_t Count = 0;
+        std::size_t Stride = 0;
+        std::size_t Used = 0;
+        std::unique_ptr<std::byte[]> Bytes;
+
+        [[nodiscard]] bool Owns(const void *memory) const noexcept {
+            const auto *byte = static_cast<const std::byte *>(memory);
+            return Bytes && byte >= Bytes.get() && byte < Bytes.get() + Count * Stride;
+        }
+    };
+
+    /// Allocator of allocate_shared: every node's control block keeps the storage alive. A slot
+    /// is never reused; one outside the buffer (a larger request) is a plain allocation.
+    template<typename T>
+    struct BlockAllocator {
+        using value_type = T;
+
+        explicit BlockAllocator(std::shared_ptr<BlockStorage> storage) noexcept : Storage(std::move(storage)) {
+        }
+
+        template<typename U>
+        BlockAllocator(const BlockAllocator<U> &other) noexcept : Storage(other.Storage) {
+        }
+
+        T *allocate(const std::size_t n) {
+            static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+            BlockStorage &storage = *Storage;
+            const std::size_t bytes = n * sizeof(T);
+            if (!storage.Bytes) {
+                constexpr std::size_t align = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+                storage.Stride = (bytes + align - 1) / align * align;
+                storage.Bytes.reset(new std::byte[storage.Count * storage.Stride]);
+            }
+            if (bytes <= storage.Stride && storage.Used < storage.Count)
+                return reinterpret_cast<T *>(storage.Bytes.get() + storage.Stride * storage.Used++);
+            return static_cast<T *>(::operator new(bytes));
+        }
+
+        void deallocate(T *memory, std::size_t) noexcept {
+            if (!Storage->Owns(memory))
+                ::operator delete(memory);
+        }
+
+        template<typename U>
+        bool operator==(const BlockAllocator<U> &other) const noexcept { return Storage == other.Storage; }
+
+        std::shared_ptr<BlockStorage> Storage;
+    };
+}
+
+std::vector<SharedNode> masharif::AllocateNodeBlock(const std::size_t count) {
+    std::vector<SharedNode> nodes;
+    nodes.reserve(count);
+    if (count == 0)
+        return nodes;
+    auto storage = std::make_shared<BlockStorage>();
+    storage->Count = count;
+    const BlockAllocator<Node> allocator(std::move(storage));
+    for (std::size_t i = 0; i < count; ++i)
+        nodes.push_back(std::allocate_shared<Node>(allocator));
+    return nodes;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace masharif {
+    class Node;
+    using SharedNode = std::shared_ptr<Node>;
+
+    /// `count` default nodes for a bulk build (TreeBuilder, Snapshot): one buffer holds every
+    /// node with its own control block, so each node lives exactly as long as its handles (a
+    /// parent's child list included) and the buffer goes with the last of them. Nothing in the
+    /// buffer owns it, so a built tree has no ownership cycle.
+    [[nodiscard]] std::vector<SharedNode> AllocateNodeBlock(std::size_t count);
+}
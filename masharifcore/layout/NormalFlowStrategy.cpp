@@ -4,6 +4,7 @@
 #include "Node.h"
 
 #include <algorithm>
+#include <cmath>
 
 using namespace masharif;
 
@@ -17,26 +18,96 @@ namespace {
             const auto &childStyle = child->GetStyle();
             childLayout.LocalX = x;
             childLayout.LocalY = y;
-            x += childLayout.ComputedWidth + childStyle.GetMargin().Left.Value + childStyle.GetMargin().Right.Value;
+            x += childLayout.ComputedWidth + childStyle.GetMargin().Left.Length() + childStyle.GetMargin().Right.Length();
         }
     }
+
+    /// NaN (AUTO) compares equal to NaN, matching Node's space memo.
+    bool SameSpace(const float a, const float b) {
+        return (std::isnan(a) && std::isnan(b)) || a == b;
+    }
+}
+
+void NormalFlowStrategy::ShiftTail(Node &container, const std::size_t from, const float delta) {
+    auto &table = container.m_flowTable;
+    const auto &children = container.m_Children;
+    for (std::size_t i = from; i < children.size(); ++i) {
+        table.Offsets[i] += delta; // NaN (mid-line) entries stay NaN
+        Node *child = children[i].get();
+        const auto &dim = child->GetStyle().GetDimensions();
+        if (dim.Display == OuterDisplay::None)
+            continue;
+        if (IsOutOfFlow(dim.Position)) {
+            container.m_OutOfFlowChildren.push_back(child);
+            continue;
+        }
+        child->GetLayout().LocalY += delta;
+    }
+    table.Offsets[children.size()] += delta;
 }
 
 void NormalFlowStrategy::Layout(Node &container, LayoutContext &ctx,
                                 const float availableWidth, const float availableHeight) const {
-    // The out-of-flow list must reflect exactly this run; see FlexLayoutStrategy::Layout.
-    container.m_OutOfFlowChildren.clear();
+    MASHARIF_LAYOUT_PHASE(ctx, LayoutPhase::NormalFlowStrategy);
+    const TraceSlice trace(ctx, TraceSliceKind::Strategy, static_cast<std::uint8_t>(LayoutPhase::NormalFlowStrategy),
+                           &container, availableWidth, availableHeight);
+    const auto &containerStyle = container.GetStyle();
+    const auto &containerBorder = containerStyle.GetBorder();
+    const auto &containerPadding = containerStyle.GetPadding();
+    const float originX = containerPadding.Left.Length() + containerBorder.WidthLeft.Length();
+    const float originY = containerPadding.Top.Length() + containerBorder.WidthTop.Length();
+
+    const auto &children = container.m_Children;
+    const std::size_t count = children.size();
+    auto &table = container.m_flowTable;
+
+    // Resume from the offset table when it describes the previous run of this container (no
+    // other strategy ran since) under the same inputs: every child before the first changed one
+    // is clean and was laid out at this exact space, so its size and position still hold.
+    const bool sameRun = table.Run == container.GetLayout().StrategyRuns &&
+                         SameSpace(table.AvailW, availableWidth) && SameSpace(table.AvailH, availableHeight) &&
+                         table.OriginX == originX && table.OriginY == originY;
+    // A run a time-sliced solve stopped in continues at the child it stopped on, but only within
+    // the frame it stopped in: its entries are this frame's, with no clean tail past them.
+    const bool resumed = sameRun && table.Suspended != 0 && table.Suspended == container.m_generation;
+    const bool tableValid = sameRun && table.Suspended == 0;
+    // Entries [0, known) still describe the current children (plus the end cursor).
+    const std::size_t known = tableValid || resumed ? std::min(table.Offsets.size(), count + 1) : 0;
+    const std::size_t tail = tableValid ? known : 0;
+
+    // Entries are rewritten as the run goes; the table describes no run until it completes or
+    // a time-sliced solve stops it.
+    table.Run = 0;
+    table.Suspended = 0;
+
+    std::size_t start = known ? std::min<std::size_t>(resumed ? known - 1 : container.m_changedBegin, known - 1) : 0;
+    while (start > 0 && std::isnan(table.Offsets[start])) --start; // back to the open line's start
+    table.Offsets.resize(count + 1, NAN);
+
+    // The out-of-flow list must reflect exactly this run; see FlexLayoutStrategy::Layout. It is
+    // in child order, so only the entries at or past the resume point are rebuilt.
+    auto &outOfFlow = container.m_OutOfFlowChildren;
+    while (!outOfFlow.empty() && outOfFlow.back()->m_indexInParent >= start)
+        outOfFlow.pop_back();
 
     float currentX = 0.0f;
-    float currentY = 0.0f;
+    float currentY = known ? table.Offsets[start] : 0.0f;
     float lineHeight = 0.0f;
     ArenaSlice<Node *> line(ctx.InFlowItems);
+    bool shifted = false;
 
-    const auto &containerStyle = container.GetStyle();
-    const auto &containerBorder = containerStyle.GetBorder();
-    const auto &containerPadding = containerStyle.GetPadding();
+    for (std::size_t i = start; i < count; ++i) {
+        Node *child = children[i].get();
+
+        // Past the last changed child at a line boundary that also was one last run: the rest
+        // of the flow is clean and wraps identically, so it only moves by the cursor delta.
+        if (line.Empty() && i >= container.m_changedEnd && i < tail && !std::isnan(table.Offsets[i])) {
+            ShiftTail(container, i, currentY - table.Offsets[i]);
+            shifted = true;
+            break;
+        }
+        table.Offsets[i] = line.Empty() ? currentY : NAN;
 
-    for (const auto &child: container.m_Children) {
         const auto &childStyle = child->GetStyle();
 
         // display:none generates no box — skip entirely (in-flow and out-of-flow alike), so it
@@ -45,9 +116,8 @@ void NormalFlowStrategy::Layout(Node &container, LayoutContext &ctx,
             continue;
 
         const auto position = childStyle.GetDimensions().Position;
-        if (position != PositionType::Static &&
-            position != PositionType::Relative) {
-            container.m_OutOfFlowChildren.push_back(child.get());
+        if (IsOutOfFlow(position)) {
+            outOfFlow.push_back(child);
             continue;
         }
         auto &childLayout = child->GetLayout();
@@ -55,9 +125,21 @@ void NormalFlowStrategy::Layout(Node &container, LayoutContext &ctx,
         const auto &childPadding = childStyle.GetPadding();
 
         child->LayoutImpl(ctx, availableWidth, availableHeight);
+        if (ctx.Yielded) {
+            // Keep the entries up to this child: the frame's next run of this container resumes
+            // here (from the line's start when one is open).
+            table.Offsets.resize(i + 1);
+            table.Run = container.GetLayout().StrategyRuns;
+            table.Suspended = container.m_generation;
+            table.AvailW = availableWidth;
+            table.AvailH = availableHeight;
+            table.OriginX = originX;
+            table.OriginY = originY;
+            return;
+        }
 
         const auto display = childStyle.GetDimensions().Display;
-        if (display == OuterDisplay::Block || display == OuterDisplay::Flex) {
+        if (display == OuterDisplay::Block || display == OuterDisplay::Flex || display == OuterDisplay::Grid) {
             if (!line.Empty()) {
                 LayoutLine(line, currentY);
                 currentY += lineHeight;
@@ -66,11 +148,11 @@ void NormalFlowStrategy::Layout(Node &container, LayoutContext &ctx,
                 lineHeight = 0.0f;
             }
 
-            childLayout.LocalX = containerPadding.Left.Value + containerBorder.WidthLeft.Value;
-            childLayout.LocalY = currentY + containerPadding.Top.Value + containerBorder.WidthTop.Value;
-            currentY += childLayout.ComputedHeight + childMargin.Top.Value + childMargin.Bottom.Value;
+            childLayout.LocalX = originX;
+            childLayout.LocalY = currentY + originY;
+            currentY += childLayout.ComputedHeight + childMargin.Top.Length() + childMargin.Bottom.Length();
         } else if (display == OuterDisplay::InlineBlock || display == OuterDisplay::InlineFlex) {
-            const float childWidth = childLayout.ComputedWidth + childMargin.Left.Value + childMargin.Right.Value;
+            const float childWidth = childLayout.ComputedWidth + childMargin.Left.Length() + childMargin.Right.Length();
 
             if (currentX + childWidth > availableWidth && !line.Empty()) {
                 LayoutLine(line, currentY);
@@ -80,15 +162,60 @@ void NormalFlowStrategy::Layout(Node &container, LayoutContext &ctx,
                 lineHeight = 0.0f;
             }
             const auto &childBorder = childStyle.GetBorder();
-            line.Append(child.get());
+            line.Append(child);
             currentX += childWidth;
             lineHeight = std::max(lineHeight,
-                                  childLayout.ComputedHeight + childMargin.Top.Value + childMargin.Bottom.Value +
-                                  childPadding.Top.Value + childPadding.Bottom.Value +
-                                  childBorder.WidthTop.Value + childBorder.WidthBottom.Value);
+                                  childLayout.ComputedHeight + childMargin.Top.Length() + childMargin.Bottom.Length() +
+                                  childPadding.Top.Length() + childPadding.Bottom.Length() +
+                                  childBorder.WidthTop.Length() + childBorder.WidthBottom.Length());
         }
     }
 
-    if (!line.Empty())
+    // End cursor: where an appended child would start, or NaN while the last line is still
+    // open (an append may join it, so it resumes from the line's start).
+    const bool lineOpen = !line.Empty();
+    if (lineOpen) {
         LayoutLine(line, currentY);
+        currentY += lineHeight;
+        line.Clear();
+    }
+    if (!shifted)
+        table.Offsets[count] = lineOpen ? NAN : currentY;
+
+    // The caller bumps StrategyRuns right after this returns; any other run in between
+    // (e.g. a display switch to flex) leaves the table stale.
+    table.Run = container.GetLayout().StrategyRuns + 1;
+    table.AvailW = availableWidth;
+    table.AvailH = availableHeight;
+    table.OriginX = originX;
+    table.OriginY = originY;
+}
+
+float NormalFlowStrategy::IntrinsicContentSize(Node &container, const IntrinsicSizing sizing,
+                                               const LayoutAxis axis) const {
+    // Block-level children stack; a run of inline-level ones forms one line at max-content and
+    // one line per box at min-content.
+    const bool horizontal = axis == LayoutAxis::Horizontal;
+    const bool lineAlongAxis = horizontal != (sizing == IntrinsicSizing::MinContent);
+    float total = 0.0f;
+    float run = 0.0f;
+    const auto endRun = [&] {
+        total = horizontal ? std::max(total, run) : total + run;
+        run = 0.0f;
+    };
+    for (const auto &child: container.m_Children) {
+        const auto &dim = child->GetStyle().GetDimensions();
+        if (dim.Display == OuterDisplay::None || IsOutOfFlow(dim.Position))
+            continue;
+        const float outer = child->OuterIntrinsicSize(sizing, axis);
+        if (dim.Display == OuterDisplay::Block || dim.Display == OuterDisplay::Flex ||
+            dim.Display == OuterDisplay::Grid) {
+            endRun();
+            total = horizontal ? std::max(total, outer) : total + outer;
+        } else {
+            run = lineAlongAxis ? run + outer : std::max(run, outer);
+        }
+    }
+    endRun();
+    return total;
 }
@@ -2,10 +2,20 @@
 
 #include "LayoutStrategy.h"
 
+#include <cstddef>
+
 namespace masharif {
     class NormalFlowStrategy final : public LayoutStrategy {
     public:
         void Layout(Node &container, LayoutContext &ctx,
                     float availableWidth, float availableHeight) const override;
+
+        [[nodiscard]] float IntrinsicContentSize(Node &container, IntrinsicSizing sizing,
+                                                 LayoutAxis axis) const override;
+
+    private:
+        /// Translate children [from, end) by `delta` on the block axis without re-entering
+        /// their solves: they are clean and wrap exactly as in the run that built the table.
+        static void ShiftTail(Node &container, std::size_t from, float delta);
     };
 }
@@ -0,0 +1,313 @@
+#include "Snapshot.h"
+
+#include "Node.h"
+#include "NodeBlock.h"
+
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+using namespace masharif;
+
+namespace {
+    constexpr std::uint32_t SnapshotMagic = 0x504E534D; // "MSNP"
+    constexpr std::uint32_t HasLayout = 1u;
+
+    struct SnapshotHeader {
+        std::uint32_t Magic;
+        std::uint32_t Version;
+        std::uint32_t RecordSize;
+        std::uint32_t Flags;
+        std::uint32_t NodeCount;
+        std::uint32_t OutOfFlowCount; ///< entries of the out-of-flow table after the records
+        float RootFontSize;
+        float UnitsWidth, UnitsHeight, UnitsFontSize; ///< the root's last UnitContext (with layout)
+        std::uint32_t CalcCount; ///< CalcTerms after the out-of-flow table, by image-local id
+    };
+
+    enum RecordFlags : std::uint16_t {
+        StyleDirty = 1 << 0,
+        StylePositionDirty = 1 << 1,
+        DescendantDirty = 1 << 2,
+        PositionsDirty = 1 << 3,
+        StrategyRanSinceDefinite = 1 << 4,
+        StickyInSubtree = 1 << 5,
+        AutoVisibilityInSubtree = 1 << 6,
+        DeferredInSubtree = 1 << 7,
+        ContentRevealed = 1 << 8,
+        ContentSkipped = 1 << 9,
+        ScrollPort = 1 << 10,
+        UnitsInSubtree = 1 << 11,
+    };
+
+    /// One node. The layout part is only meaningful in an image saved with its layout.
+    struct NodeRecord {
+        std::uint32_t Parent;
+        std::uint32_t OutOfFlowCount; ///< this node's entries in the out-of-flow table
+        masharif::Dimensions Dimensions;
+        CSSFlex Flex;
+        MarginEdge Margin;
+        PaddingEdge Padding;
+        BorderProperties Border;
+        PositionOffsets Offsets;
+        CSSGrid Grid;
+        float ScrollX, ScrollY;
+        std::uint16_t Flags;
+        OuterDisplay SolvedDisplay;
+        masharif::Layout Layout;
+        LayoutBox Published;
+        float LastAvailW, LastAvailH;
+        float LastDefW, LastDefH;
+        float ImplW, ImplH;
+        float RememberedW, RememberedH;
+    };
+
+    static_assert(std::is_trivially_copyable_v<NodeRecord>, "records are copied as raw bytes");
+
+    /// Calls `visit` on every length of a record.
+    void ForEachRecordLength(NodeRecord &record, auto &&visit) {
+        ForEachLength(record.Dimensions, record.Flex, record.Margin, record.Padding, record.Border, record.Offsets,
+                      visit);
+    }
+    static_assert(sizeof(SnapshotHeader) % alignof(NodeRecord) == 0);
+
+    constexpr std::uint32_t NoParent = UINT32_MAX;
+}
+
+std::vector<std::uint8_t> Snapshot::Save(const Node &root, const bool withLayout) {
+    std::vector<NodeRecord> records;
+    std::vector<std::uint32_t> outOfFlow;
+    // calc() ids only mean something in this process: the image carries the expressions and
+    // its records number them locally.
+    std::vector<CalcTerms> calc;
+    std::unordered_map<std::uint32_t, std::uint32_t> calcIndex;
+
+    // Pre-order, so every parent index is below its children's.
+    std::vector<std::pair<const Node *, std::uint32_t>> stack{{&root, NoParent}};
+    while (!stack.empty()) {
+        const auto [node, parent] = stack.back();
+        stack.pop_back();
+        const auto index = static_cast<std::uint32_t>(records.size());
+
+        NodeRecord &record = records.emplace_back();
+        std::memset(static_cast<void *>(&record), 0, sizeof record); // deterministic padding
+        const Style &style = node->m_Style;
+        record.Parent = parent;
+        record.Dimensions = style.m_Dimensions;
+        record.Flex = style.m_FlexProps;
+        record.Margin = style.m_MarginProps;
+        record.Padding = style.m_PaddingProps;
+        record.Border = style.m_BorderProps;
+        record.Offsets = style.m_Offsets;
+        record.Grid = style.m_GridProps;
+        ForEachRecordLength(record, [&](CSSValue &value) {
+            if (value.Unit != CSSUnit::Calc)
+                return;
+            const auto [it, added] = calcIndex.try_emplace(static_cast<std::uint32_t>(value.Value),
+                                                           static_cast<std::uint32_t>(calc.size()));
+            if (added)
+                calc.push_back(value.Terms());
+            value.Value = static_cast<float>(it->second);
+        });
+        record.ScrollX = node->m_scrollX;
+        record.ScrollY = node->m_scrollY;
+        record.Flags = node->m_scrollPort ? ScrollPort : 0;
+        if (withLayout) {
+            const std::uint16_t flags =
+                    (style.Dirty ? StyleDirty : 0) | (style.PositionDirty ? StylePositionDirty : 0) |
+                    (node->m_descendantDirty ? DescendantDirty : 0) |
+                    (node->m_positionsDirty ? PositionsDirty : 0) |
+                    (node->m_strategyRanSinceDefinite ? StrategyRanSinceDefinite : 0) |
+                    (node->m_stickyInSubtree ? StickyInSubtree : 0) |
+                    (node->m_autoVisibilityInSubtree ? AutoVisibilityInSubtree : 0) |
+                    (node->m_deferredInSubtree ? DeferredInSubtree : 0) |
+                    (node->m_unitsInSubtree ? UnitsInSubtree : 0) |
+                    (node->m_contentRevealed ? ContentRevealed : 0) |
+                    (node->m_contentSkipped ? ContentSkipped : 0);
+            record.Flags |= flags;
+            record.SolvedDisplay = node->m_solvedDisplay;
+            record.Layout = node->m_Layout;
+            record.Published = node->m_published;
+            record.LastAvailW = node->m_lastAvailW;
+            record.LastAvailH = node->m_lastAvailH;
+            record.LastDefW = node->m_lastDefW;
+            record.LastDefH = node->m_lastDefH;
+            record.ImplW = node->m_implW;
+            record.ImplH = node->m_implH;
+            record.RememberedW = node->m_rememberedW;
+            record.RememberedH = node->m_rememberedH;
+            record.OutOfFlowCount = static_cast<std::uint32_t>(node->m_OutOfFlowChildren.size());
+            for (const Node *child : node->m_OutOfFlowChildren)
+                outOfFlow.push_back(child->m_indexInParent);
+        }
+
+        const auto &children = node->m_Children;
+        for (auto it = children.rbegin(); it != children.rend(); ++it)
+            stack.emplace_back(it->get(), index);
+    }
+
+    SnapshotHeader header{};
+    header.Magic = SnapshotMagic;
+    header.Version = Version;
+    header.RecordSize = sizeof(NodeRecord);
+    header.Flags = withLayout ? HasLayout : 0;
+    header.NodeCount = static_cast<std::uint32_t>(records.size());
+    header.OutOfFlowCount = static_cast<std::uint32_t>(outOfFlow.size());
+    header.RootFontSize = root.m_rootFontSize;
+    header.UnitsWidth = withLayout ? root.m_unitsWidth : NAN;
+    header.UnitsHeight = withLayout ? root.m_unitsHeight : NAN;
+    header.UnitsFontSize = withLayout ? root.m_unitsFontSize : NAN;
+    header.CalcCount = static_cast<std::uint32_t>(calc.size());
+
+    std::vector<std::uint8_t> image(sizeof header + records.size() * sizeof(NodeRecord) +
+                                    outOfFlow.size() * sizeof(std::uint32_t) + calc.size() * sizeof(CalcTerms));
+    std::uint8_t *out = image.data();
+    std::memcpy(out, &header, sizeof header);
+    out += sizeof header;
+    std::memcpy(out, records.data(), records.size() * sizeof(NodeRecord));
+    out += records.size() * sizeof(NodeRecord);
+    if (!outOfFlow.empty())
+        std::memcpy(out, outOfFlow.data(), outOfFlow.size() * sizeof(std::uint32_t));
+    out += outOfFlow.size() * sizeof(std::uint32_t);
+    if (!calc.empty())
+        std::memcpy(out, calc.data(), calc.size() * sizeof(CalcTerms));
+    return image;
+}
+
+SharedNode Snapshot::Load(const void *data, const std::size_t size) {
+    SnapshotHeader header;
+    if (!data || size < sizeof header)
+        return nullptr;
+    std::memcpy(&header, data, sizeof header);
+    if (header.Magic != SnapshotMagic || header.Version != Version || header.RecordSize != sizeof(NodeRecord) ||
+        header.NodeCount == 0)
+        return nullptr;
+    const std::size_t count = header.NodeCount;
+    if ((size - sizeof header) / sizeof(NodeRecord) < count)
+        return nullptr;
+    const std::size_t outOfFlowOffset = sizeof header + count * sizeof(NodeRecord);
+    if ((size - outOfFlowOffset) / sizeof(std::uint32_t) < header.OutOfFlowCount)
+        return nullptr;
+    const std::size_t calcOffset = outOfFlowOffset + header.OutOfFlowCount * sizeof(std::uint32_t);
+    if ((size - calcOffset) / sizeof(CalcTerms) < header.CalcCount)
+        return nullptr;
+    const auto *records = static_cast<const std::uint8_t *>(data) + sizeof header;
+    const auto *outOfFlow = static_cast<const std::uint8_t *>(data) + outOfFlowOffset;
+    const bool withLayout = header.Flags & HasLayout;
+
+    // The image's expressions, interned in this process.
+    std::vector<std::uint32_t> calcIds(header.CalcCount);
+    for (std::size_t i = 0; i < calcIds.size(); ++i) {
+        CalcTerms terms;
+        std::memcpy(static_cast<void *>(&terms), static_cast<const std::uint8_t *>(data) + calcOffset +
+                                                 i * sizeof(CalcTerms), sizeof terms);
+        calcIds[i] = CalcTable::Intern(terms);
+    }
+
+    // Child counts first, so every child list is reserved exactly (and the structure is
+    // checked before anything is built).
+    std::vector<std::uint32_t> childCounts(count, 0);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::uint32_t parent;
+        std::memcpy(&parent, records + i * sizeof(NodeRecord) + offsetof(NodeRecord, Parent), sizeof parent);
+        if ((i == 0) != (parent == NoParent) || (i != 0 && parent >= i))
+            return nullptr;
+        if (i != 0)
+            ++childCounts[parent];
+    }
+
+    // One allocation for every node, as TreeBuilder::Build.
+    const std::vector<SharedNode> nodes = AllocateNodeBlock(count);
+    std::vector<std::uint32_t> outOfFlowCounts(count, 0);
+    for (std::size_t i = 0; i < count; ++i) {
+        NodeRecord record;
+        std::memcpy(static_cast<void *>(&record), records + i * sizeof(NodeRecord), sizeof record);
+        bool calcValid = true;
+        ForEachRecordLength(record, [&](CSSValue &value) {
+            if (value.Unit != CSSUnit::Calc)
+                return;
+            const float local = value.Value;
+            calcValid = calcValid && local >= 0.0f && local < static_cast<float>(calcIds.size());
+            value.Value = calcValid ? static_cast<float>(calcIds[static_cast<std::size_t>(local)]) : 0.0f;
+        });
+        if (!calcValid)
+            return nullptr;
+        Node &node = *nodes[i];
+        Style &style = node.m_Style;
+        style.m_Dimensions = record.Dimensions;
+        style.m_FlexProps = record.Flex;
+        style.m_MarginProps = record.Margin;
+        style.m_PaddingProps = record.Padding;
+        style.m_BorderProps = record.Border;
+        style.m_Offsets = record.Offsets;
+        style.m_GridProps = record.Grid;
+        node.m_scrollPort = record.Flags & ScrollPort;
+        node.m_scrollX = record.ScrollX;
+        node.m_scrollY = record.ScrollY;
+        if (childCounts[i])
+            node.m_Children.reserve(childCounts[i]);
+        if (i != 0) {
+            Node &parent = *nodes[record.Parent];
+            node.m_Parent = &parent;
+            node.m_indexInParent = static_cast<std::uint32_t>(parent.m_Children.size());
+            parent.m_Children.push_back(nodes[i]);
+        }
+        if (!withLayout) {
+            // Fresh, like a built tree: dirty by default, with every parent flagged.
+            if (childCounts[i])
+                node.m_descendantDirty = true;
+            continue;
+        }
+        style.Dirty = record.Flags & StyleDirty;
+        style.PositionDirty = record.Flags & StylePositionDirty;
+        node.m_descendantDirty = record.Flags & DescendantDirty;
+        node.m_positionsDirty = record.Flags & PositionsDirty;
+        node.m_strategyRanSinceDefinite = record.Flags & StrategyRanSinceDefinite;
+        node.m_stickyInSubtree = record.Flags & StickyInSubtree;
+        node.m_autoVisibilityInSubtree = record.Flags & AutoVisibilityInSubtree;
+        node.m_deferredInSubtree = record.Flags & DeferredInSubtree;
+        node.m_unitsInSubtree = record.Flags & UnitsInSubtree;
+        node.m_unitDependencies = style.UnitDependencies();
+        node.m_contentRevealed = record.Flags & ContentRevealed;
+        node.m_contentSkipped = record.Flags & ContentSkipped;
+        node.m_solvedDisplay = record.SolvedDisplay;
+        node.m_Layout = record.Layout;
+        node.m_published = record.Published;
+        node.m_lastAvailW = record.LastAvailW;
+        node.m_lastAvailH = record.LastAvailH;
+        node.m_lastDefW = record.LastDefW;
+        node.m_lastDefH = record.LastDefH;
+        node.m_implW = record.ImplW;
+        node.m_implH = record.ImplH;
+        node.m_rememberedW = record.RememberedW;
+        node.m_rememberedH = record.RememberedH;
+        outOfFlowCounts[i] = record.OutOfFlowCount;
+    }
+
+    // Fix-ups that need the complete child lists: the changed-children ranges and the
+    // out-of-flow lists the positions walk consumes.
+    std::size_t nextOutOfFlow = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        Node &node = *nodes[i];
+        if (node.m_descendantDirty)
+            node.NoteChangedChildren(0, node.m_Children.size());
+        if (outOfFlowCounts[i] > header.OutOfFlowCount - nextOutOfFlow)
+            return nullptr;
+        node.m_OutOfFlowChildren.reserve(outOfFlowCounts[i]);
+        for (std::uint32_t k = 0; k < outOfFlowCounts[i]; ++k, ++nextOutOfFlow) {
+            std::uint32_t child;
+            std::memcpy(&child, outOfFlow + nextOutOfFlow * sizeof child, sizeof child);
+            if (child >= node.m_Children.size())
+                return nullptr;
+            node.m_OutOfFlowChildren.push_back(node.m_Children[child].get());
+        }
+    }
+    Node &root = *nodes[0];
+    root.m_rootFontSize = header.RootFontSize;
+    root.m_unitsWidth = header.UnitsWidth;
+    root.m_unitsHeight = header.UnitsHeight;
+    root.m_unitsFontSize = header.UnitsFontSize;
+    return nodes[0];
+}
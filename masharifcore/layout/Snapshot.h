@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace masharif {
+    class Node;
+    using SharedNode = std::shared_ptr<Node>;
+
+    /// Binary image of a node tree: styles and child structure, and optionally the solved
+    /// layout with the memos that make it reusable. A tree saved after Calculate and loaded at
+    /// startup solves nothing on its first Calculate at the same available space.
+    ///
+    /// The image is a header followed by one fixed-size record per node in pre-order (a parent
+    /// before its children) and a table of out-of-flow child indices; nothing in it needs
+    /// parsing, so it can be loaded straight from a mapped file. Records hold the in-memory
+    /// style structs, so an image is only valid for a build with the same layout of them
+    /// (same compiler ABI and endianness); Load rejects images whose version or record size
+    /// differ. A virtual list is saved as a plain node holding its materialized window.
+    class Snapshot {
+    public:
+        static constexpr std::uint32_t Version = 4;
+
+        /// Image of `root`'s subtree; without `withLayout` it reloads unsolved.
+        [[nodiscard]] static std::vector<std::uint8_t> Save(const Node &root, bool withLayout = true);
+
+        /// Rebuild the tree from an image (all nodes in one allocation, like TreeBuilder).
+        /// Null if the image is truncated, malformed, or from another version or build.
+        [[nodiscard]] static SharedNode Load(const void *data, std::size_t size);
+    };
+}
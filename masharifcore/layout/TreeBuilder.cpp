@@ -0,0 +1,57 @@
+#include "TreeBuilder.h"
+
+#include "Node.h"
+#include "NodeBlock.h"
+
+using namespace masharif;
+
+std::vector<SharedNode> TreeBuilder::Build() const {
+    const std::size_t count = m_Nodes.size();
+    std::vector<SharedNode> handles = AllocateNodeBlock(count);
+    if (count == 0)
+        return handles;
+
+    std::vector<std::uint32_t> childCounts(count, 0);
+    for (const NodeSpec &spec : m_Nodes) {
+        if (spec.Parent != NoParent)
+            ++childCounts[spec.Parent];
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+        Node &node = *handles[i];
+        // Straight into the property storage: a fresh node is dirty already, and Modify
+        // would walk the (still unwired) ancestors for nothing.
+        const StyleBlock &style = m_Styles[m_Nodes[i].Style];
+        Style &target = node.m_Style;
+        target.m_Dimensions = style.Dimensions;
+        target.m_FlexProps = style.Flex;
+        target.m_MarginProps = style.Margin;
+        target.m_PaddingProps = style.Padding;
+        target.m_BorderProps = style.Border;
+        target.m_Offsets = style.Offsets;
+        target.m_GridProps = style.Grid;
+        if (childCounts[i])
+            node.m_Children.reserve(childCounts[i]);
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::uint32_t parentIndex = m_Nodes[i].Parent;
+        if (parentIndex == NoParent)
+            continue;
+        Node &parent = *handles[parentIndex];
+        Node &node = *handles[i];
+        node.m_Parent = &parent;
+        node.m_indexInParent = static_cast<std::uint32_t>(parent.m_Children.size());
+        parent.m_Children.push_back(handles[i]);
+    }
+
+    // What AddChild would have left behind, once per parent instead of once per child.
+    for (std::size_t i = 0; i < count; ++i) {
+        Node &node = *handles[i];
+        if (node.m_Children.empty())
+            continue;
+        node.NoteChangedChildren(0, node.m_Children.size());
+        node.m_descendantDirty = true;
+    }
+    return handles;
+}
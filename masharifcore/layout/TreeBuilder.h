@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <masharifcore/structure/Style.h>
+
+namespace masharif {
+    class Node;
+    using SharedNode = std::shared_ptr<Node>;
+
+    /// Builds a whole tree from a flat description in one go: a table of style blocks and a
+    /// table of nodes, each naming its parent and its style block by index. Every node is new,
+    /// so nothing is invalidated on the way (the result is as dirty as any unsolved tree), all
+    /// nodes share one allocation and every child list is reserved to its exact size.
+    ///
+    /// Each built node still has its own lifetime (see AllocateNodeBlock): a parent owns its
+    /// children as usual, and the shared storage is released with the last node.
+    class TreeBuilder {
+    public:
+        static constexpr std::uint32_t NoParent = UINT32_MAX;
+
+        /// Every style property of a node; unset fields keep their defaults.
+        struct StyleBlock {
+            masharif::Dimensions Dimensions;
+            CSSFlex Flex;
+            MarginEdge Margin;
+            PaddingEdge Padding;
+            BorderProperties Border;
+            PositionOffsets Offsets;
+            CSSGrid Grid;
+        };
+
+        struct NodeSpec {
+            std::uint32_t Parent = NoParent;
+            std::uint32_t Style = 0;
+        };
+
+        void Reserve(std::size_t nodes, std::size_t styles = 0) {
+            m_Nodes.reserve(nodes);
+            m_Styles.reserve(styles);
+        }
+
+        /// Index of a new style block, for AddNode.
+        std::uint32_t AddStyle(const StyleBlock &style) {
+            m_Styles.push_back(style);
+            return static_cast<std::uint32_t>(m_Styles.size() - 1);
+        }
+
+        /// Index of a new node. A parent must be added before its children; children keep the
+        /// order they are added in.
+        std::uint32_t AddNode(std::uint32_t parent, std::uint32_t style) {
+            m_Nodes.push_back({parent, style});
+            return static_cast<std::uint32_t>(m_Nodes.size() - 1);
+        }
+
+        [[nodiscard]] std::size_t NodeCount() const noexcept { return m_Nodes.size(); }
+
+        /// One handle per node, in AddNode order; nodes without a parent are roots.
+        [[nodiscard]] std::vector<SharedNode> Build() const;
+
+    private:
+        std::vector<StyleBlock> m_Styles;
+        std::vector<NodeSpec> m_Nodes;
+    };
+}
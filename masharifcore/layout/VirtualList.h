@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+namespace masharif {
+    class Node;
+    using SharedNode = std::shared_ptr<Node>;
+
+    /// Item provider of a virtualized list container (Node::SetVirtualSource). The list asks
+    /// for nodes only while laying out, and only for the items near its visible range.
+    class VirtualListSource {
+    public:
+        virtual ~VirtualListSource() = default;
+
+        [[nodiscard]] virtual std::size_t ItemCount() const = 0;
+
+        /// Block-axis size (margins included) assumed for items that were never measured; the
+        /// list refines it with a running mean of the sizes it measures.
+        [[nodiscard]] virtual float EstimatedItemSize() const = 0;
+
+        /// Node for item `index`: a fresh one, or a recycled one rebound to this item (and
+        /// dirtied through its style, as any rebinding edit does).
+        virtual SharedNode Materialize(std::size_t index) = 0;
+
+        /// Item `index` left the materialized window. Its node is already detached from the
+        /// list and may be pooled for a later Materialize.
+        virtual void Recycle(std::size_t /*index*/, SharedNode /*node*/) {
+        }
+    };
+}
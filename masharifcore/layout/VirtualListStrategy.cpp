@@ -0,0 +1,139 @@
+#include "VirtualListStrategy.h"
+
+#include "LayoutContext.h"
+#include "Node.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace masharif;
+
+namespace {
+    /// Block-axis footprint of a laid-out item, as NormalFlowStrategy stacks a block.
+    float OuterHeight(Node &item) {
+        const auto &margin = item.GetStyle().GetMargin();
+        return item.GetLayout().ComputedHeight + margin.Top.Length() + margin.Bottom.Length();
+    }
+}
+
+void VirtualListStrategy::Layout(Node &container, LayoutContext &ctx,
+                                 const float availableWidth, const float availableHeight) const {
+    MASHARIF_LAYOUT_PHASE(ctx, LayoutPhase::VirtualListStrategy);
+    const TraceSlice trace(ctx, TraceSliceKind::Strategy, static_cast<std::uint8_t>(LayoutPhase::VirtualListStrategy),
+                           &container, availableWidth, availableHeight);
+    // Items are moved between the old and new window as they are measured: a time-sliced solve
+    // must not stop in here.
+    const YieldBlockScope noYield(ctx);
+    auto &state = *container.m_virtual;
+    VirtualListSource &source = *state.Source;
+    const auto &containerStyle = container.GetStyle();
+    const auto &containerBorder = containerStyle.GetBorder();
+    const auto &containerPadding = containerStyle.GetPadding();
+    const float originX = containerPadding.Left.Length() + containerBorder.WidthLeft.Length();
+    const float originY = containerPadding.Top.Length() + containerBorder.WidthTop.Length();
+    const float verticalInset = originY + containerPadding.Bottom.Length() + containerBorder.WidthBottom.Length();
+    const bool autoHeight = containerStyle.GetDimensions().Height.Unit == CSSUnit::Auto;
+
+    // Visible block range in content space. Without a definite height there is no viewport
+    // and every item is materialized.
+    float viewHeight = autoHeight ? availableHeight : container.GetLayout().ComputedHeight - verticalInset;
+    if (std::isnan(viewHeight))
+        viewHeight = std::numeric_limits<float>::infinity();
+    const float viewTop = std::max(0.0f, container.ScrollOffsetY());
+    const float viewBottom = viewTop + std::max(0.0f, viewHeight);
+
+    const std::size_t count = source.ItemCount();
+    const float estimate = state.Estimate;
+    const std::size_t first = std::min(count, static_cast<std::size_t>(viewTop / estimate));
+    const std::size_t begin = first > state.Overscan ? first - state.Overscan : 0;
+
+    // The previous window, items [oldFirst, oldFirst + previous.size()). Entries are moved out
+    // as they are reused or recycled, so whatever is left afterwards left the window.
+    auto &previous = container.m_Children;
+    const std::size_t oldFirst = state.First;
+    auto recycle = [&](const std::size_t k) {
+        previous[k]->SetParent(nullptr);
+        source.Recycle(oldFirst + k, std::move(previous[k]));
+    };
+    // Items that scrolled out above go back first, so the source can rebind their nodes to
+    // the items materialized below.
+    for (std::size_t k = 0; k < previous.size() && oldFirst + k < begin; ++k)
+        recycle(k);
+
+    double measuredSum = 0.0;
+    std::size_t measuredCount = 0;
+    auto &window = state.Window;
+    window.clear();
+    auto acquire = [&](const std::size_t index) -> Node & {
+        SharedNode item;
+        if (index >= oldFirst && index - oldFirst < previous.size() && previous[index - oldFirst])
+            item = std::move(previous[index - oldFirst]);
+        else
+            item = source.Materialize(index);
+        item->SetParent(&container);
+        item->m_indexInParent = static_cast<std::uint32_t>(window.size());
+        window.push_back(std::move(item));
+        Node &node = *window.back();
+        node.LayoutImpl(ctx, availableWidth, availableHeight);
+        const bool fresh = index < oldFirst || index - oldFirst >= previous.size();
+        if (fresh) {
+            measuredSum += OuterHeight(node);
+            ++measuredCount;
+        }
+        return node;
+    };
+
+    // Overscan above the anchor, stacked upwards from the anchor's estimated offset; at the
+    // very top the real sizes are known, so the window starts at 0 instead.
+    float above = 0.0f;
+    for (std::size_t i = begin; i < first; ++i)
+        above += OuterHeight(acquire(i));
+    const float windowTop = begin == 0 ? 0.0f : std::max(0.0f, static_cast<float>(first) * estimate - above);
+
+    // From the anchor down until the visible range is covered, plus the overscan below.
+    float cursor = windowTop + above;
+    std::size_t below = 0;
+    for (std::size_t i = first; i < count; ++i) {
+        if (cursor >= viewBottom && below++ == state.Overscan)
+            break;
+        cursor += OuterHeight(acquire(i));
+    }
+    for (std::size_t k = 0; k < previous.size(); ++k)
+        if (previous[k])
+            recycle(k);
+
+    float y = windowTop;
+    for (const auto &item : window) {
+        auto &itemLayout = item->GetLayout();
+        itemLayout.LocalX = originX;
+        itemLayout.LocalY = y + originY;
+        y += OuterHeight(*item);
+    }
+    previous.swap(window);
+    window.clear();
+    Node::NoteStructureChange();
+    state.First = begin;
+    container.m_OutOfFlowChildren.clear(); // items are always stacked in flow
+
+    if (measuredCount) {
+        state.MeasuredSum += measuredSum;
+        state.MeasuredCount += measuredCount;
+        state.Estimate = std::max(1.0f, static_cast<float>(state.MeasuredSum / static_cast<double>(state.MeasuredCount)));
+    }
+    const std::size_t end = begin + previous.size();
+    state.Extent = cursor + static_cast<float>(count - end) * state.Estimate;
+    if (autoHeight)
+        container.GetLayout().ComputedHeight = state.Extent + verticalInset;
+}
+
+float VirtualListStrategy::IntrinsicContentSize(Node &container, const IntrinsicSizing sizing,
+                                                const LayoutAxis axis) const {
+    // Only the window exists: the block axis reports the estimated extent of the last run.
+    if (axis == LayoutAxis::Vertical)
+        return container.m_virtual->Extent;
+    float widest = 0.0f;
+    for (const auto &item: container.m_Children)
+        widest = std::max(widest, item->OuterIntrinsicSize(sizing, axis));
+    return widest;
+}
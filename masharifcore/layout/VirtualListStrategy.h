@@ -0,0 +1,18 @@
+#pragma once
+
+#include "LayoutStrategy.h"
+
+namespace masharif {
+    /// Lays out a virtual list container (Node::SetVirtualSource): materializes the items that
+    /// intersect the visible block range plus the overscan, stacks them as blocks at their
+    /// estimated offset, and recycles the items that left the window. Cost and memory scale
+    /// with the window, not the item count.
+    class VirtualListStrategy final : public LayoutStrategy {
+    public:
+        void Layout(Node &container, LayoutContext &ctx,
+                    float availableWidth, float availableHeight) const override;
+
+        [[nodiscard]] float IntrinsicContentSize(Node &container, IntrinsicSizing sizing,
+                                                 LayoutAxis axis) const override;
+    };
+}
@@ -2,12 +2,36 @@
 #include "../macros.h"
 
 namespace masharif {
-    ENUM_BEGIN(OuterDisplay) { None, Block, Inline, InlineBlock, Flex, InlineFlex } ENUM_END(OuterDisplay);
+    /// Grid is a block-level grid container (GridLayoutStrategy).
+    ENUM_BEGIN(OuterDisplay) { None, Block, Inline, InlineBlock, Flex, InlineFlex, Grid } ENUM_END(OuterDisplay);
 
     ENUM_BEGIN(InnerLayout) { NormalFlow, Flex, Grid } ENUM_END(InnerLayout);
 
+    /// How a display value lays out its children.
+    constexpr InnerLayout InnerLayoutOf(const OuterDisplay display) {
+        switch (display) {
+            case OuterDisplay::Flex:
+            case OuterDisplay::InlineFlex:
+                return InnerLayout::Flex;
+            case OuterDisplay::Grid:
+                return InnerLayout::Grid;
+            default:
+                return InnerLayout::NormalFlow;
+        }
+    }
+
     ENUM_BEGIN(PositionType) { Static, Relative, Absolute, Fixed, Sticky } ENUM_END(PositionType);
 
+    /// content-visibility: an Auto subtree away from the viewport is sized by its placeholder
+    /// (contain-intrinsic-size, or its last laid-out size) and its contents are not laid out.
+    ENUM_BEGIN(ContentVisibility) { Visible, Auto } ENUM_END(ContentVisibility);
+
+    /// Absolute and Fixed boxes leave the flow; Relative and Sticky keep their flow slot and are
+    /// only shifted by the positions walk.
+    inline bool IsOutOfFlow(PositionType position) {
+        return position == PositionType::Absolute || position == PositionType::Fixed;
+    }
+
     ENUM_TO_STRING(OuterDisplay,
                    ENUM_CASE(OuterDisplay::None)
                    ENUM_CASE(OuterDisplay::Block)
@@ -15,6 +39,7 @@ namespace masharif {
                    ENUM_CASE(OuterDisplay::InlineBlock)
                    ENUM_CASE(OuterDisplay::Flex)
                    ENUM_CASE(OuterDisplay::InlineFlex)
+                   ENUM_CASE(OuterDisplay::Grid)
     );
     ENUM_TO_STRING(PositionType,
                    ENUM_CASE(PositionType::Static)
@@ -23,4 +48,8 @@ namespace masharif {
                    ENUM_CASE(PositionType::Fixed)
                    ENUM_CASE(PositionType::Sticky)
     );
+    ENUM_TO_STRING(ContentVisibility,
+                   ENUM_CASE(ContentVisibility::Visible)
+                   ENUM_CASE(ContentVisibility::Auto)
+    );
 }
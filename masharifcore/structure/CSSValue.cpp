@@ -0,0 +1,50 @@
+#include "CSSValue.h"
+
+#include <mutex>
+#include <unordered_map>
+
+using namespace masharif;
+
+std::array<CalcTerms *, CalcTable::MaxChunks> CalcTable::s_chunks{};
+
+namespace {
+    struct TermsHash {
+        std::size_t operator()(const CalcTerms &terms) const noexcept {
+            const std::hash<float> hash;
+            std::size_t h = hash(terms.Constant);
+            for (const float term: {terms.PerReference, terms.PerViewportWidth, terms.PerViewportHeight,
+                                    terms.PerFontSize})
+                h = h * 31 + hash(term);
+            return h;
+        }
+    };
+
+    struct InternState {
+        std::mutex Lock;
+        std::unordered_map<CalcTerms, std::uint32_t, TermsHash> Ids;
+        std::uint32_t Count = 0;
+    };
+
+    InternState &State() {
+        static InternState state;
+        return state;
+    }
+}
+
+std::uint32_t CalcTable::Intern(const CalcTerms &terms) {
+    InternState &state = State();
+    const std::lock_guard lock(state.Lock);
+    if (const auto it = state.Ids.find(terms); it != state.Ids.end())
+        return it->second;
+    const std::uint32_t id = state.Count;
+    if ((id >> ChunkBits) >= MaxChunks)
+        return 0; // table full: the first expression stands in rather than an invalid id
+    // Chunks live as long as the process: any style anywhere may still hold their ids.
+    CalcTerms *&chunk = s_chunks[id >> ChunkBits];
+    if (!chunk)
+        chunk = new CalcTerms[ChunkSize];
+    chunk[id & (ChunkSize - 1)] = terms;
+    ++state.Count;
+    state.Ids.emplace(terms, id);
+    return id;
+}
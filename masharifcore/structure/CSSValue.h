@@ -1,13 +1,99 @@
 #pragma once
 
+#include <array>
 #include <cmath>
+#include <cstdint>
 #include <masharifcore/macros.h>
 
 namespace masharif {
     enum class CSSUnit {
         Px = 0,
         Percent,
-        Auto
+        Auto,
+        Vw, ///< 1/100 of the viewport width (UnitContext)
+        Vh, ///< 1/100 of the viewport height
+        Rem, ///< the root font size
+        Em, ///< the element's font size; there is no font-size property, so the root's
+        Calc ///< calc(): Value is the CalcTable id of the expression
+    };
+
+    /// What a relative unit resolves against, as bits of a dependency mask
+    /// (CSSValue::Dependencies, Style::UnitDependencies).
+    namespace UnitDependency {
+        inline constexpr std::uint8_t ViewportWidth = 1 << 0;
+        inline constexpr std::uint8_t ViewportHeight = 1 << 1;
+        inline constexpr std::uint8_t FontSize = 1 << 2;
+    }
+
+    /// Reference sizes of the relative units. Each Calculate installs its root's for the frame
+    /// (the viewport is the root's available space, the font size Node::SetRootFontSize); they
+    /// stay in place for queries on this thread until the next one.
+    struct UnitContext {
+        float ViewportWidth = 0.0f;
+        float ViewportHeight = 0.0f;
+        float RootFontSize = 16.0f;
+
+        [[nodiscard]] static UnitContext &Current() noexcept {
+            thread_local UnitContext context;
+            return context;
+        }
+    };
+
+    /// calc() as written: the sum of one term per unit, e.g. {.Px = -48, .Percent = 100}.
+    struct CalcExpression {
+        float Px = 0.0f;
+        float Percent = 0.0f;
+        float Vw = 0.0f;
+        float Vh = 0.0f;
+        float Rem = 0.0f;
+        float Em = 0.0f;
+    };
+
+    /// A compiled CalcExpression: one coefficient per reference, the unit scales folded in, so
+    /// equal sums compile (and intern) alike.
+    struct CalcTerms {
+        float Constant = 0.0f;
+        float PerReference = 0.0f;
+        float PerViewportWidth = 0.0f;
+        float PerViewportHeight = 0.0f;
+        float PerFontSize = 0.0f;
+
+        [[nodiscard]] static CalcTerms Compile(const CalcExpression &expression) noexcept {
+            return {expression.Px, expression.Percent / 100.0f, expression.Vw / 100.0f, expression.Vh / 100.0f,
+                    expression.Rem + expression.Em};
+        }
+
+        /// Pixels against the percentage `reference` and the UnitContext. The select only keeps
+        /// an indefinite (NaN) reference out of an expression without a percentage.
+        [[nodiscard]] float Evaluate(const float reference) const noexcept {
+            const UnitContext &units = UnitContext::Current();
+            const float basis = PerReference != 0.0f ? reference : 0.0f;
+            return Constant + PerReference * basis + PerViewportWidth * units.ViewportWidth +
+                   PerViewportHeight * units.ViewportHeight + PerFontSize * units.RootFontSize;
+        }
+
+        bool operator==(const CalcTerms &) const = default;
+    };
+
+    /// Process-wide intern table of CalcTerms: a CSSUnit::Calc value holds an id, so CSSValue
+    /// stays eight bytes and equal expressions compare equal. Ids are never released. Interning
+    /// is thread-safe; a lookup is two loads, the entries never moving once added.
+    class CalcTable {
+    public:
+        static constexpr std::uint32_t ChunkBits = 12;
+        static constexpr std::uint32_t ChunkSize = 1u << ChunkBits;
+        /// 2^24 ids, all exactly representable in a CSSValue's float.
+        static constexpr std::uint32_t MaxChunks = 1u << 12;
+
+        /// The id of `terms`, added on first use.
+        [[nodiscard]] static std::uint32_t Intern(const CalcTerms &terms);
+
+        [[nodiscard]] static const CalcTerms &At(const std::uint32_t id) noexcept {
+            return s_chunks[id >> ChunkBits][id & (ChunkSize - 1)];
+        }
+
+    private:
+        static std::array<CalcTerms *, MaxChunks> s_chunks;
     };
 
     struct CSSValue {
@@ -20,13 +106,69 @@ namespace masharif {
         CSSValue(const float val, CSSUnit u) : Value(val), Unit(u) {
         }
 
+        /// A calc() value for `expression`.
+        [[nodiscard]] static CSSValue Calc(const CalcExpression &expression) {
+            return {static_cast<float>(CalcTable::Intern(CalcTerms::Compile(expression))), CSSUnit::Calc};
+        }
+
+        /// The compiled expression of a Calc value.
+        [[nodiscard]] const CalcTerms &Terms() const noexcept {
+            return CalcTable::At(static_cast<std::uint32_t>(Value));
+        }
+
         /// Resolve to pixels: Px returns the raw value, Percent is taken against
-        /// `reference`, Auto resolves to 0.
+        /// `reference`, a relative unit against the UnitContext, Auto resolves to 0.
         [[nodiscard]] constexpr float ResolveValue(float reference) const {
             switch (Unit) {
                 case CSSUnit::Px: return Value;
                 case CSSUnit::Percent: return reference * (Value / 100.0f);
-                default: return 0.0f;
+                case CSSUnit::Auto: return 0.0f;
+                case CSSUnit::Calc: return Terms().Evaluate(reference);
+                default: return Length();
+            }
+        }
+
+        /// Pixels for Px and the relative units; Percent and Auto give the raw Value, which is
+        /// what the arithmetic operators below have always used, and a Calc value takes its
+        /// percentage of 0.
+        [[nodiscard]] constexpr float Length() const {
+            switch (Unit) {
+                case CSSUnit::Vw: return Value * (UnitContext::Current().ViewportWidth / 100.0f);
+                case CSSUnit::Vh: return Value * (UnitContext::Current().ViewportHeight / 100.0f);
+                case CSSUnit::Rem:
+                case CSSUnit::Em: return Value * UnitContext::Current().RootFontSize;
+                case CSSUnit::Calc: return Terms().Evaluate(0.0f);
+                default: return Value;
+            }
+        }
+
+        /// A definite length needing no percentage basis: Px, a relative unit or a calc()
+        /// without a percentage.
+        [[nodiscard]] constexpr bool IsLength() const {
+            if (Unit == CSSUnit::Calc) return Terms().PerReference == 0.0f;
+            return Unit == CSSUnit::Px || Unit >= CSSUnit::Vw;
+        }
+
+        /// Resolves against a percentage basis: Percent, or a calc() with a percentage.
+        [[nodiscard]] constexpr bool HasPercentage() const {
+            return Unit == CSSUnit::Percent || (Unit == CSSUnit::Calc && Terms().PerReference != 0.0f);
+        }
+
+        /// The UnitDependency bits of a relative unit, 0 for the others.
+        [[nodiscard]] constexpr std::uint8_t Dependencies() const {
+            switch (Unit) {
+                case CSSUnit::Vw: return UnitDependency::ViewportWidth;
+                case CSSUnit::Vh: return UnitDependency::ViewportHeight;
+                case CSSUnit::Rem:
+                case CSSUnit::Em: return UnitDependency::FontSize;
+                case CSSUnit::Calc: {
+                    const CalcTerms &terms = Terms();
+                    return static_cast<std::uint8_t>(
+                        (terms.PerViewportWidth != 0.0f ? UnitDependency::ViewportWidth : 0) |
+                        (terms.PerViewportHeight != 0.0f ? UnitDependency::ViewportHeight : 0) |
+                        (terms.PerFontSize != 0.0f ? UnitDependency::FontSize : 0));
+                }
+                default: return 0;
             }
         }
 
@@ -38,19 +180,19 @@ namespace masharif {
             return Value == rhs.Value && Unit == rhs.Unit;
         }
 
-        constexpr float operator+(const CSSValue &rhs) const { return Value + rhs.Value; }
-        constexpr float operator-(const CSSValue &rhs) const { return Value - rhs.Value; }
-        constexpr float operator*(const CSSValue &rhs) const { return Value * rhs.Value; }
-        constexpr float operator/(const CSSValue &rhs) const { return Value / rhs.Value; }
+        constexpr float operator+(const CSSValue &rhs) const { return Length() + rhs.Length(); }
+        constexpr float operator-(const CSSValue &rhs) const { return Length() - rhs.Length(); }
+        constexpr float operator*(const CSSValue &rhs) const { return Length() * rhs.Length(); }
+        constexpr float operator/(const CSSValue &rhs) const { return Length() / rhs.Length(); }
 
-        constexpr float operator+(float rhs) const { return Value + rhs; }
-        constexpr float operator-(float rhs) const { return Value - rhs; }
-        constexpr float operator*(float rhs) const { return Value * rhs; }
-        constexpr float operator/(float rhs) const { return Value / rhs; }
+        constexpr float operator+(float rhs) const { return Length() + rhs; }
+        constexpr float operator-(float rhs) const { return Length() - rhs; }
+        constexpr float operator*(float rhs) const { return Length() * rhs; }
+        constexpr float operator/(float rhs) const { return Length() / rhs; }
 
-        friend constexpr float operator+(float lhs, const CSSValue &rhs) { return lhs + rhs.Value; }
-        friend constexpr float operator-(float lhs, const CSSValue &rhs) { return lhs - rhs.Value; }
-        friend constexpr float operator*(float lhs, const CSSValue &rhs) { return lhs * rhs.Value; }
-        friend constexpr float operator/(float lhs, const CSSValue &rhs) { return lhs / rhs.Value; }
+        friend constexpr float operator+(float lhs, const CSSValue &rhs) { return lhs + rhs.Length(); }
+        friend constexpr float operator-(float lhs, const CSSValue &rhs) { return lhs - rhs.Length(); }
+        friend constexpr float operator*(float lhs, const CSSValue &rhs) { return lhs * rhs.Length(); }
+        friend constexpr float operator/(float lhs, const CSSValue &rhs) { return lhs / rhs.Length(); }
     };
 }
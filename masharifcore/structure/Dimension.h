@@ -14,5 +14,8 @@ namespace masharif {
         CSSValue MaxHeight;
         CSSValue Top{0}, Right{0}, Bottom{0}, Left{0};
         PositionType Position = PositionType::Static;
+        ContentVisibility Visibility = ContentVisibility::Visible;
+        /// contain-intrinsic-size: content-box placeholder of a skipped Visibility::Auto subtree.
+        CSSValue ContainIntrinsicWidth{0}, ContainIntrinsicHeight{0};
     };
 }
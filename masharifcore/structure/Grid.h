@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+namespace masharif {
+    /// Sizing function of one grid track.
+    enum class GridTrackUnit : std::uint8_t {
+        Auto, ///< sized to the items in it, then stretched into leftover space
+        Px,
+        Percent, ///< of the grid's content box; auto when that size is indefinite
+        Fr, ///< a share of the space left after every other track
+    };
+
+    struct GridTrack {
+        float Value = 0.0f;
+        GridTrackUnit Unit = GridTrackUnit::Auto;
+
+        [[nodiscard]] static constexpr GridTrack Px(const float value) { return {value, GridTrackUnit::Px}; }
+        [[nodiscard]] static constexpr GridTrack Percent(const float value) { return {value, GridTrackUnit::Percent}; }
+        [[nodiscard]] static constexpr GridTrack Fr(const float value) { return {value, GridTrackUnit::Fr}; }
+        [[nodiscard]] static constexpr GridTrack Auto() { return {}; }
+
+        constexpr bool operator==(const GridTrack &) const = default;
+    };
+
+    /// grid-template-rows / grid-template-columns. The tracks are stored inline, so a style
+    /// stays one flat copyable block (TreeBuilder, Snapshot, MutationTrace copy it as bytes):
+    /// a template holds at most MaxTracks tracks, and a grid that needs more places the rest
+    /// in implicit tracks sized by grid-auto-rows / grid-auto-columns.
+    struct GridTemplate {
+        static constexpr std::size_t MaxTracks = 12;
+
+        std::array<GridTrack, MaxTracks> Tracks{};
+        std::uint8_t Count = 0;
+
+        constexpr GridTemplate() = default;
+
+        /// The first MaxTracks of `tracks`.
+        constexpr GridTemplate(const std::initializer_list<GridTrack> tracks) {
+            for (const GridTrack &track : tracks)
+                if (Count < MaxTracks)
+                    Tracks[Count++] = track;
+        }
+
+        [[nodiscard]] constexpr std::size_t Size() const { return Count; }
+
+        [[nodiscard]] constexpr const GridTrack &operator[](const std::size_t i) const { return Tracks[i]; }
+    };
+
+    /// Grid container and grid item properties. The gaps between tracks are CSSFlex::Gaps
+    /// (row-gap / column-gap serve both layouts).
+    struct CSSGrid {
+        GridTemplate TemplateRows;
+        GridTemplate TemplateColumns;
+        /// grid-auto-rows / grid-auto-columns: size of the implicit tracks past the template.
+        GridTrack AutoRows;
+        GridTrack AutoColumns;
+
+        /// grid-row-start / grid-column-start as 1-based line numbers; 0 is auto (the item is
+        /// auto-placed, row by row, into the first free area that fits it).
+        std::int16_t RowStart = 0;
+        std::int16_t ColumnStart = 0;
+        /// Tracks the item spans (grid-row: span n); at least 1.
+        std::int16_t RowSpan = 1;
+        std::int16_t ColumnSpan = 1;
+    };
+}
@@ -3,6 +3,24 @@
 #include <masharifcore/layout/Node.h>
 
 void masharif::Style::NotifyOwner() {
-    if (m_Owner)
-        m_Owner->MarkDirtyToRoot();
+    if (!m_Owner)
+        return;
+    m_Owner->MarkDirtyToRoot();
+    if (MutationTrace *trace = MutationTrace::Active())
+        trace->OnStyle(*m_Owner, false);
+}
+
+void masharif::Style::NotifyOwnerPosition() {
+    if (!m_Owner)
+        return;
+    m_Owner->MarkPositionDirty();
+    if (MutationTrace *trace = MutationTrace::Active())
+        trace->OnStyle(*m_Owner, true);
+}
+
+std::uint8_t masharif::Style::UnitDependencies() const {
+    std::uint8_t dependencies = 0;
+    ForEachLength(m_Dimensions, m_FlexProps, m_MarginProps, m_PaddingProps, m_BorderProps, m_Offsets,
+                  [&](const CSSValue &value) { dependencies |= value.Dependencies(); });
+    return dependencies;
 }
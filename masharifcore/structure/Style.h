@@ -4,6 +4,7 @@
 #include "Dimension.h"
 #include "Edge.h"
 #include "Flex.h"
+#include "Grid.h"
 #include <type_traits>
 
 namespace masharif {
@@ -18,11 +19,59 @@ namespace masharif {
     struct PositionOffsets : Edge {
     };
 
+    /// Writable view of the inset properties kept in Dimensions (Top/Right/Bottom/Left).
+    struct InsetRefs {
+        CSSValue &Top;
+        CSSValue &Right;
+        CSSValue &Bottom;
+        CSSValue &Left;
+    };
+
+
+    /// Calls `visit` on every CSSValue of the style groups (grid tracks have their own type),
+    /// const or not: the one list of lengths for Style::UnitDependencies and the image formats,
+    /// which store the groups apart from any Style.
+    void ForEachLength(auto &dimensions, auto &flex, auto &margin, auto &padding, auto &border, auto &offsets,
+                       auto &&visit) {
+        const auto edge = [&](auto &sides) {
+            visit(sides.Left);
+            visit(sides.Top);
+            visit(sides.Bottom);
+            visit(sides.Right);
+        };
+        edge(margin);
+        edge(padding);
+        edge(offsets);
+        visit(border.WidthTop);
+        visit(border.WidthBottom);
+        visit(border.WidthLeft);
+        visit(border.WidthRight);
+        visit(dimensions.Width);
+        visit(dimensions.Height);
+        visit(dimensions.MinWidth);
+        visit(dimensions.MinHeight);
+        visit(dimensions.MaxWidth);
+        visit(dimensions.MaxHeight);
+        visit(dimensions.Top);
+        visit(dimensions.Right);
+        visit(dimensions.Bottom);
+        visit(dimensions.Left);
+        visit(dimensions.ContainIntrinsicWidth);
+        visit(dimensions.ContainIntrinsicHeight);
+        visit(flex.FlexBasis);
+        visit(flex.Gaps.Row);
+        visit(flex.Gaps.Column);
+    }
 
     class Style {
     public:
+        /// Size-affecting change: the node and its ancestors re-solve on the next frame.
         bool Dirty = true;
 
+        /// Position-only change (relative offsets, out-of-flow insets): the next frame re-runs
+        /// only the positions walk down to this node; no layout strategy runs for it.
+        bool PositionDirty = false;
+
         Style() = default;
         Style(const Style &) = delete;
         Style &operator=(const Style &) = delete;
@@ -36,6 +85,7 @@ namespace masharif {
         template<typename T, std::enable_if_t<
             std::is_same_v<T, Dimensions> ||
             std::is_same_v<T, CSSFlex> ||
+            std::is_same_v<T, CSSGrid> ||
             std::is_same_v<T, MarginEdge> ||
             std::is_same_v<T, PaddingEdge> ||
             std::is_same_v<T, Edge> ||
@@ -46,21 +96,58 @@ namespace masharif {
             return GetProperty<T>();
         }
 
+        /// Position-only write of the relative-position offsets. They move the box (and its
+        /// subtree) after layout without affecting any size, so only PositionDirty is raised.
+        PositionOffsets &ModifyOffsets() {
+            PositionDirty = true;
+            NotifyOwnerPosition();
+            return m_Offsets;
+        }
+
+        /// Position-only write of the insets an absolute/fixed/sticky node is placed by. Its
+        /// parent re-positions it (re-measuring it only if a pinned AUTO size changed) without
+        /// re-solving any ancestor. Changing Position itself still goes through Modify.
+        InsetRefs ModifyInsets() {
+            PositionDirty = true;
+            NotifyOwnerPosition();
+            return {m_Dimensions.Top, m_Dimensions.Right, m_Dimensions.Bottom, m_Dimensions.Left};
+        }
+
         [[nodiscard]] const CSSFlex &GetFlex() const { return m_FlexProps; }
+        [[nodiscard]] const CSSGrid &GetGrid() const { return m_GridProps; }
         [[nodiscard]] const MarginEdge &GetMargin() const { return m_MarginProps; }
         [[nodiscard]] const PaddingEdge &GetPadding() const { return m_PaddingProps; }
         [[nodiscard]] const BorderProperties &GetBorder() const { return m_BorderProps; }
         [[nodiscard]] const Dimensions &GetDimensions() const { return m_Dimensions; }
         [[nodiscard]] const PositionOffsets &GetOffsets() const { return m_Offsets; }
 
+        /// UnitDependency bits of every length in this style: what a change of the UnitContext
+        /// must re-solve this node for.
+        [[nodiscard]] std::uint8_t UnitDependencies() const;
+
     private:
+        friend class Node;
+        friend class TreeBuilder;
+        friend class Snapshot;
+
+        /// Display write that shows or hides the box without invalidating the node's own
+        /// layout; Node::SetDisplay decides when that holds and invalidates the ancestors.
+        void SetDisplayRetainingLayout(OuterDisplay display) { m_Dimensions.Display = display; }
+
         void NotifyOwner();
 
+        void NotifyOwnerPosition();
+
         template<typename T>
         std::enable_if_t<std::is_same_v<T, CSSFlex>, T &> GetProperty() {
             return m_FlexProps;
         }
 
+        template<typename T>
+        std::enable_if_t<std::is_same_v<T, CSSGrid>, T &> GetProperty() {
+            return m_GridProps;
+        }
+
         template<typename T>
         std::enable_if_t<std::is_same_v<T, MarginEdge>, T &> GetProperty() {
             return m_MarginProps;
@@ -95,5 +182,6 @@ namespace masharif {
         PositionOffsets m_Offsets;
         BorderProperties m_BorderProps;
         Dimensions m_Dimensions;
+        CSSGrid m_GridProps;
     };
 }
@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+#include <masharifcore/Masharif.h>
+
+using namespace masharif;
+
+// Replays a MutationTrace recording: rebuilds the recorded tree, applies each frame's edits
+// and times only the frame's Calculate. Per frame it reports the time, the strategy runs the
+// frame cost and how many nodes ran one, against the number of nodes in the tree, and the
+// frame's reuse-check hits and misses (Node::GetCacheStats).
+
+namespace {
+    const char *kindName(const TraceReplayer::FrameKind kind) {
+        switch (kind) {
+            case TraceReplayer::FrameKind::Plain: return "plain";
+            case TraceReplayer::FrameKind::Viewport: return "viewport";
+            case TraceReplayer::FrameKind::VisibleFirst: return "visible-first";
+            case TraceReplayer::FrameKind::Sliced: return "sliced";
+        }
+        return "?";
+    }
+
+    void collectRuns(Node &node, std::unordered_map<const Node *, std::uint64_t> &runs) {
+        runs[&node] = node.GetLayout().StrategyRuns;
+        for (const auto &child : node.Children())
+            collectRuns(*child, runs);
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        std::cerr << "usage: masharif_replay <trace file>\n";
+        return 2;
+    }
+    std::ifstream file(argv[1], std::ios::binary);
+    const std::vector<char> trace{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    TraceReplayer replayer(trace.data(), trace.size());
+    if (!file || !replayer.Valid()) {
+        std::cerr << "masharif_replay: cannot read a trace from " << argv[1] << "\n";
+        return 1;
+    }
+
+    std::cout << "frame kind width height us strategy_runs nodes_solved nodes cache_hits cache_misses\n";
+    std::vector<long long> times;
+    std::uint64_t totalRuns = 0;
+    std::unordered_map<const Node *, std::uint64_t> before, after;
+    TraceReplayer::Frame frame;
+    while (replayer.NextFrame(frame)) {
+        before.clear();
+        collectRuns(*replayer.Root(), before);
+
+        const auto start = std::chrono::steady_clock::now();
+        TraceReplayer::Run(frame);
+        const auto end = std::chrono::steady_clock::now();
+        const long long us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+        after.clear();
+        collectRuns(*replayer.Root(), after);
+        std::uint64_t runs = 0;
+        std::size_t solved = 0;
+        for (const auto &[node, count] : after) {
+            const auto it = before.find(node);
+            const std::uint64_t delta = count - (it != before.end() ? it->second : 0);
+            runs += delta;
+            solved += delta != 0;
+        }
+        totalRuns += runs;
+        times.push_back(us);
+        std::cout << times.size() - 1 << ' ' << kindName(frame.Kind) << ' ' << frame.Width << ' ' << frame.Height
+                << ' ' << us << ' ' << runs << ' ' << solved << ' ' << after.size() << ' '
+                << frame.Target->GetCacheStats().Hits() << ' ' << frame.Target->GetCacheStats().Misses() << '\n';
+    }
+    if (times.empty()) {
+        std::cout << "no frames\n";
+        return 0;
+    }
+
+    std::vector<long long> sorted = times;
+    std::sort(sorted.begin(), sorted.end());
+    long long total = 0;
+    for (const long long us : times)
+        total += us;
+    std::cout << "frames: " << times.size() << ", total: " << total << " us, p50: " << sorted[sorted.size() / 2]
+            << " us, p95: " << sorted[sorted.size() * 95 / 100] << " us, max: " << sorted.back()
+            << " us, strategy runs: " << totalRuns << "\n";
+    return 0;
+}
@@ -0,0 +1,216 @@
+#include <gtest/gtest.h>
+#include "masharifcore/Masharif.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <new>
+
+using namespace masharif;
+
+// Every allocation of the test binary goes through here, so a test can count what one
+// Calculate allocates. Every form of the global operators is replaced, so new and delete stay
+// paired over malloc/free (a sanitizer's allocator would otherwise see a mismatch).
+namespace {
+    std::atomic<std::uint64_t> g_allocations{0};
+
+    void *countedAllocate(const std::size_t size, const std::size_t alignment = 0) noexcept {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        const std::size_t bytes = size ? size : 1;
+        if (alignment <= alignof(std::max_align_t))
+            return std::malloc(bytes);
+        // aligned_alloc wants a multiple of the alignment.
+        return std::aligned_alloc(alignment, (bytes + alignment - 1) / alignment * alignment);
+    }
+
+    void *countedAllocateOrThrow(const std::size_t size, const std::size_t alignment = 0) {
+        if (void *memory = countedAllocate(size, alignment))
+            return memory;
+        throw std::bad_alloc();
+    }
+}
+
+void *operator new(const std::size_t size) { return countedAllocateOrThrow(size); }
+void *operator new[](const std::size_t size) { return countedAllocateOrThrow(size); }
+void *operator new(const std::size_t size, const std::nothrow_t &) noexcept { return countedAllocate(size); }
+void *operator new[](const std::size_t size, const std::nothrow_t &) noexcept { return countedAllocate(size); }
+
+void *operator new(const std::size_t size, const std::align_val_t alignment) {
+    return countedAllocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](const std::size_t size, const std::align_val_t alignment) {
+    return countedAllocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new(const std::size_t size, const std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return countedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](const std::size_t size, const std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return countedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete[](void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void *memory, const std::nothrow_t &) noexcept { std::free(memory); }
+void operator delete[](void *memory, const std::nothrow_t &) noexcept { std::free(memory); }
+void operator delete(void *memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void *memory, std::align_val_t, const std::nothrow_t &) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::align_val_t, const std::nothrow_t &) noexcept { std::free(memory); }
+
+namespace {
+    struct Shape {
+        const char *Name;
+        SharedNode Root;
+        std::function<void(bool)> Edit; ///< one leaf's style, alternating between two values
+    };
+
+    std::uint64_t allocationsOf(const std::function<void()> &frame) {
+        const std::uint64_t before = g_allocations.load(std::memory_order_relaxed);
+        frame();
+        return g_allocations.load(std::memory_order_relaxed) - before;
+    }
+
+    SharedNode flexBox(const FlexDirection direction) {
+        auto node = std::make_shared<Node>(OuterDisplay::Flex);
+        node->GetStyle().Modify<CSSFlex>().Direction = direction;
+        return node;
+    }
+
+    SharedNode fixedLeaf(const float width, const float height) {
+        auto leaf = std::make_shared<Node>(OuterDisplay::Flex);
+        leaf->GetStyle().Modify<Dimensions>().Width = width;
+        leaf->GetStyle().Modify<Dimensions>().Height = height;
+        return leaf;
+    }
+
+    Shape resizeLeaf(const char *name, SharedNode root, SharedNode leaf) {
+        return {name, std::move(root), [leaf](const bool wide) {
+            leaf->GetStyle().Modify<Dimensions>().Width = wide ? 12.0f : 8.0f;
+        }};
+    }
+
+    /// Alternating-direction flex boxes, four wide and four deep.
+    Shape wideDeep() {
+        auto root = flexBox(FlexDirection::Column);
+        root->GetStyle().Modify<Dimensions>().Width = 1000.0f;
+        SharedNode leaf;
+        std::function<void(Node &, int)> fill = [&](Node &parent, const int level) {
+            for (int i = 0; i < 4; ++i) {
+                auto child = level == 3 ? fixedLeaf(8.0f, 8.0f)
+                                        : flexBox(level % 2 ? FlexDirection::Column : FlexDirection::Row);
+                parent.AddChild(child);
+                if (level < 3)
+                    fill(*child, level + 1);
+                else
+                    leaf = child;
+            }
+        };
+        fill(*root, 0);
+        return resizeLeaf("wide-deep", root, leaf);
+    }
+
+    /// Wrapping flex rows, one of them with reordered items.
+    Shape flexWrap() {
+        auto root = flexBox(FlexDirection::Column);
+        root->GetStyle().Modify<Dimensions>().Width = 1000.0f;
+        SharedNode leaf;
+        for (int i = 0; i < 10; ++i) {
+            auto row = flexBox(FlexDirection::Row);
+            row->GetStyle().Modify<CSSFlex>().Wrap = FlexWrap::Wrap;
+            for (int j = 0; j < 100; ++j) {
+                leaf = fixedLeaf(30.0f, 10.0f);
+                if (i == 0)
+                    leaf->GetStyle().Modify<CSSFlex>().Order = j % 3;
+                row->AddChild(leaf);
+            }
+            root->AddChild(row);
+        }
+        return resizeLeaf("flex-wrap", root, leaf);
+    }
+
+    /// Nested flex-grow boxes, deeper than the line arena's initial capacity.
+    Shape growChain() {
+        auto root = flexBox(FlexDirection::Column);
+        root->GetStyle().Modify<Dimensions>().Width = 1000.0f;
+        root->GetStyle().Modify<Dimensions>().Height = 1000.0f;
+        Node *cursor = root.get();
+        SharedNode leaf;
+        for (int i = 0; i < 20; ++i) {
+            leaf = fixedLeaf(50.0f, 10.0f);
+            cursor->AddChild(leaf);
+            auto next = flexBox(i % 2 ? FlexDirection::Row : FlexDirection::Column);
+            next->GetStyle().Modify<CSSFlex>().FlexGrow = 1.0f;
+            cursor->AddChild(next);
+            cursor = next.get();
+        }
+        return resizeLeaf("grow-chain", root, leaf);
+    }
+
+    /// A positioned root holding absolutely positioned badges.
+    Shape absoluteHeavy() {
+        auto root = std::make_shared<Node>();
+        root->GetStyle().Modify<Dimensions>().Width = 1000.0f;
+        root->GetStyle().Modify<Dimensions>().Height = 1000.0f;
+        root->GetStyle().Modify<Dimensions>().Position = PositionType::Relative;
+        SharedNode badge;
+        for (int i = 0; i < 200; ++i) {
+            badge = std::make_shared<Node>();
+            badge->GetStyle().Modify<Dimensions>().Position = PositionType::Absolute;
+            badge->GetStyle().Modify<Dimensions>().Width = 16.0f;
+            badge->GetStyle().Modify<Dimensions>().Height = 16.0f;
+            badge->GetStyle().ModifyInsets().Left = static_cast<float>(i % 60 * 16);
+            badge->GetStyle().ModifyInsets().Top = static_cast<float>(i / 60 * 16);
+            root->AddChild(badge);
+        }
+        return resizeLeaf("absolute-heavy", root, badge);
+    }
+
+    /// Normal flow: sections of paragraph blocks.
+    Shape document() {
+        auto root = std::make_shared<Node>();
+        root->GetStyle().Modify<Dimensions>().Width = 1000.0f;
+        SharedNode paragraph;
+        for (int i = 0; i < 20; ++i) {
+            auto section = std::make_shared<Node>();
+            section->GetStyle().Modify<PaddingEdge>().Top = 8.0f;
+            for (int j = 0; j < 10; ++j) {
+                paragraph = std::make_shared<Node>();
+                paragraph->GetStyle().Modify<Dimensions>().Height = 18.0f;
+                paragraph->GetStyle().Modify<MarginEdge>().Bottom = 4.0f;
+                section->AddChild(paragraph);
+            }
+            root->AddChild(section);
+        }
+        return {"document", root, [paragraph](const bool tall) {
+            paragraph->GetStyle().Modify<Dimensions>().Height = tall ? 24.0f : 18.0f;
+        }};
+    }
+}
+
+// Once a shape has been solved (and edited once, so every arena and memo has grown to it),
+// idle frames and single-leaf edits allocate nothing.
+TEST(AllocationTests, steady_state_frames_do_not_allocate) {
+    for (Shape shape : {wideDeep(), flexWrap(), growChain(), absoluteHeavy(), document()}) {
+        Node &root = *shape.Root;
+        root.Calculate(1000.0f, 1000.0f);
+        shape.Edit(true);
+        root.Calculate(1000.0f, 1000.0f);
+        shape.Edit(false);
+        root.Calculate(1000.0f, 1000.0f);
+
+        ASSERT_EQ(0u, allocationsOf([&] { root.Calculate(1000.0f, 1000.0f); })) << shape.Name << ": idle";
+        for (const bool edit : {true, false}) {
+            shape.Edit(edit);
+            ASSERT_EQ(0u, allocationsOf([&] { root.Calculate(1000.0f, 1000.0f); })) << shape.Name << ": edit";
+        }
+    }
+}
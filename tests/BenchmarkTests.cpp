@@ -239,3 +239,226 @@ TEST(BenchmarkTests, IdleRecalculateIsNearZeroWork) {
     EXPECT_EQ(runsAfterInitial, totalStrategyRuns(root))
         << "an idle frame must not run any layout strategy";
 }
+
+/// A 10k-block normal-flow document: appending a block resumes the flow from the offset
+/// table at the end cursor instead of re-entering every earlier sibling, and growing a block
+/// in the middle shifts the clean tail by the delta.
+TEST(BenchmarkTests, NormalFlowDocumentAppendAndMiddleEdit) {
+    constexpr int Blocks = 10000;
+    auto root = std::make_shared<Node>();
+    root->GetStyle().Modify<Dimensions>().Width = 1000.0f;
+    for (int i = 0; i < Blocks; ++i) {
+        auto block = std::make_shared<Node>();
+        block->GetStyle().Modify<Dimensions>().Width = 1000.0f;
+        block->GetStyle().Modify<Dimensions>().Height = 10.0f;
+        root->AddChild(block);
+    }
+    root->Calculate(1000.0f, 1000.0f);
+    const std::uint64_t runsAfterInitial = totalStrategyRuns(root);
+
+    auto appended = std::make_shared<Node>();
+    appended->GetStyle().Modify<Dimensions>().Width = 1000.0f;
+    appended->GetStyle().Modify<Dimensions>().Height = 10.0f;
+    root->AddChild(appended);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    root->Calculate(1000.0f, 1000.0f);
+    auto us = microsSince(start);
+    std::cout << "[BENCHMARK] append to " << Blocks << "-block document: " << us << " us" << std::endl;
+
+    EXPECT_FLOAT_EQ(Blocks * 10.0f, appended->GetLayout().ComputedY);
+    EXPECT_EQ(runsAfterInitial + 2, totalStrategyRuns(root)) << "only the root and the new block may solve";
+
+    root->Children()[Blocks / 2]->GetStyle().Modify<Dimensions>().Height = 20.0f;
+    start = std::chrono::high_resolution_clock::now();
+    root->Calculate(1000.0f, 1000.0f);
+    us = microsSince(start);
+    std::cout << "[BENCHMARK] grow middle block of " << Blocks << "-block document: " << us << " us" << std::endl;
+
+    EXPECT_FLOAT_EQ(Blocks * 10.0f + 10.0f, appended->GetLayout().ComputedY);
+}
+
+// The MassiveLayoutBenchmark tree built in bulk: same layout as the node-by-node build, with
+// one allocation and no invalidation walks.
+TEST(BenchmarkTests, BulkTreeBuildMatchesIncrementalBuild) {
+    const int Containers = 100;
+    const int ItemsPerContainer = 100;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto root = flexBox(FlexDirection::Column);
+    root->GetStyle().Modify<Dimensions>().Width = 1000.0f;
+    root->GetStyle().Modify<Dimensions>().Height = 1000.0f;
+    for (int i = 0; i < Containers; ++i) {
+        auto container = flexBox(FlexDirection::Row);
+        container->GetStyle().Modify<CSSFlex>().Wrap = FlexWrap::Wrap;
+        container->GetStyle().Modify<Dimensions>().Width = 1000.0f;
+        for (int j = 0; j < ItemsPerContainer; ++j)
+            container->AddChild(fixedLeaf(10.0f, 10.0f + static_cast<float>(j % 3)));
+        root->AddChild(container);
+    }
+    const auto incrementalUs = microsSince(start);
+
+    start = std::chrono::high_resolution_clock::now();
+    TreeBuilder builder;
+    builder.Reserve(1 + Containers + Containers * ItemsPerContainer, 5);
+    TreeBuilder::StyleBlock style;
+    style.Dimensions.Display = OuterDisplay::Flex;
+    style.Flex.Direction = FlexDirection::Column;
+    style.Dimensions.Width = 1000.0f;
+    style.Dimensions.Height = 1000.0f;
+    const std::uint32_t rootStyle = builder.AddStyle(style);
+    style = {};
+    style.Dimensions.Display = OuterDisplay::Flex;
+    style.Flex.Direction = FlexDirection::Row;
+    style.Flex.Wrap = FlexWrap::Wrap;
+    style.Dimensions.Width = 1000.0f;
+    const std::uint32_t containerStyle = builder.AddStyle(style);
+    std::uint32_t itemStyles[3];
+    for (int k = 0; k < 3; ++k) {
+        style = {};
+        style.Dimensions.Display = OuterDisplay::Flex;
+        style.Dimensions.Width = 10.0f;
+        style.Dimensions.Height = 10.0f + static_cast<float>(k);
+        itemStyles[k] = builder.AddStyle(style);
+    }
+    const std::uint32_t rootIndex = builder.AddNode(TreeBuilder::NoParent, rootStyle);
+    for (int i = 0; i < Containers; ++i) {
+        const std::uint32_t container = builder.AddNode(rootIndex, containerStyle);
+        for (int j = 0; j < ItemsPerContainer; ++j)
+            builder.AddNode(container, itemStyles[j % 3]);
+    }
+    const std::vector<SharedNode> nodes = builder.Build();
+    const auto bulkUs = microsSince(start);
+    std::cout << "[BENCHMARK] build " << nodes.size() << " nodes: node by node " << incrementalUs
+              << " us, bulk " << bulkUs << " us" << std::endl;
+
+    const SharedNode &bulk = nodes[rootIndex];
+    ASSERT_EQ(nullptr, bulk->Parent());
+    ASSERT_EQ(static_cast<std::size_t>(Containers), bulk->Children().size());
+    ASSERT_EQ(bulk->Children()[1]->Children().size(), bulk->Children()[1]->Children().capacity());
+
+    root->Calculate(1000.0f, 1000.0f);
+    bulk->Calculate(1000.0f, 1000.0f);
+    for (int i = 0; i < Containers; i += 7) {
+        for (int j = 0; j < ItemsPerContainer; j += 5) {
+            const auto &expected = root->Children()[i]->Children()[j]->GetLayout();
+            const auto &actual = bulk->Children()[i]->Children()[j]->GetLayout();
+            ASSERT_FLOAT_EQ(expected.ComputedX, actual.ComputedX);
+            ASSERT_FLOAT_EQ(expected.ComputedY, actual.ComputedY);
+            ASSERT_FLOAT_EQ(expected.ComputedHeight, actual.ComputedHeight);
+        }
+    }
+
+    // Built nodes edit like any others.
+    nodes.back()->GetStyle().Modify<Dimensions>().Height = 40.0f;
+    root->Children().back()->Children().back()->GetStyle().Modify<Dimensions>().Height = 40.0f;
+    root->Calculate(1000.0f, 1000.0f);
+    bulk->Calculate(1000.0f, 1000.0f);
+    ASSERT_FLOAT_EQ(root->Children().back()->GetLayout().ComputedHeight,
+                    bulk->Children().back()->GetLayout().ComputedHeight);
+}
+
+// A built tree owns its nodes like any other: dropping the handles destroys it, and a node
+// still held outlives the rest.
+TEST(BenchmarkTests, BuiltTreeIsDestroyedWithItsHandles) {
+    TreeBuilder builder;
+    const std::uint32_t style = builder.AddStyle({});
+    const std::uint32_t rootIndex = builder.AddNode(TreeBuilder::NoParent, style);
+    const std::uint32_t middle = builder.AddNode(rootIndex, style);
+    const std::uint32_t leafIndex = builder.AddNode(middle, style);
+    std::vector<SharedNode> nodes = builder.Build();
+    SharedNode root = nodes[rootIndex];
+    SharedNode leaf = nodes[leafIndex];
+    const std::weak_ptr<Node> inner = nodes[middle];
+    nodes.clear();
+    root->Calculate(100.0f, 100.0f);
+    ASSERT_FALSE(inner.expired());
+
+    const std::weak_ptr<Node> weakRoot = root;
+    root.reset();
+    EXPECT_TRUE(weakRoot.expired());
+    EXPECT_TRUE(inner.expired());
+    EXPECT_FLOAT_EQ(100.0f, leaf->GetLayout().ComputedWidth);
+
+    const std::weak_ptr<Node> weakLeaf = leaf;
+    leaf.reset();
+    EXPECT_TRUE(weakLeaf.expired());
+}
+
+// Exporting a 50k-node tree to a flat region: a full export, then after a leaf edit only the
+// boxes that moved.
+TEST(BenchmarkTests, FlatExportOf50kNodes) {
+    const int Rows = 500;
+    const int CellsPerRow = 99;
+
+    TreeBuilder builder;
+    TreeBuilder::StyleBlock style;
+    style.Dimensions.Width = 800.0f;
+    const std::uint32_t rootStyle = builder.AddStyle(style);
+    style = {};
+    style.Dimensions.Display = OuterDisplay::Flex;
+    style.Flex.Wrap = FlexWrap::Wrap;
+    const std::uint32_t rowStyle = builder.AddStyle(style);
+    style = {};
+    style.Dimensions.Width = 8.0f;
+    style.Dimensions.Height = 8.0f;
+    const std::uint32_t cellStyle = builder.AddStyle(style);
+    const std::uint32_t rootIndex = builder.AddNode(TreeBuilder::NoParent, rootStyle);
+    for (int i = 0; i < Rows; ++i) {
+        const std::uint32_t row = builder.AddNode(rootIndex, rowStyle);
+        for (int j = 0; j < CellsPerRow; ++j)
+            builder.AddNode(row, cellStyle);
+    }
+    const std::vector<SharedNode> nodes = builder.Build();
+    const SharedNode &root = nodes[rootIndex];
+    root->Calculate(800.0f, 600.0f);
+
+    const std::uint32_t fields = LayoutExporter::AbsoluteRects | LayoutExporter::LocalRects;
+    std::vector<std::uint64_t> region((LayoutExporter::RegionSize(nodes.size(), fields) + 7) / 8);
+    LayoutExporter exporter(region.data(), nodes.size(), fields);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    ASSERT_TRUE(exporter.Export(*root));
+    auto us = microsSince(start);
+    std::cout << "[BENCHMARK] full export of " << nodes.size() << " nodes: " << us << " us" << std::endl;
+
+    // TreeBuilder order is pre-order here, so export indices equal the build indices.
+    ASSERT_EQ(nodes.size(), exporter.Header().NodeCount);
+    ASSERT_EQ(1u, exporter.Header().FullExport);
+    ASSERT_EQ(0u, exporter.Header().Sequence % 2);
+    const std::size_t probe = 1 + 250 * (1 + CellsPerRow) + 1 + 42;
+    ASSERT_EQ(1u + 250u * (1u + CellsPerRow), exporter.Parents()[probe]);
+    ASSERT_FLOAT_EQ(nodes[probe]->GetLayout().ComputedX, exporter.Absolute()[probe].X);
+    ASSERT_FLOAT_EQ(nodes[probe]->GetLayout().ComputedY, exporter.Absolute()[probe].Y);
+    ASSERT_FLOAT_EQ(nodes[probe]->GetLayout().LocalX, exporter.Local()[probe].X);
+
+    // Idle frame: nothing to write.
+    root->Calculate(800.0f, 600.0f);
+    ASSERT_TRUE(exporter.Export(*root));
+    ASSERT_EQ(0u, exporter.Header().ChangedCount);
+
+    // Growing the first cell of the last row moves only that row's cells.
+    const std::size_t lastRow = 1 + (Rows - 1) * (1 + CellsPerRow);
+    nodes[lastRow + 1]->GetStyle().Modify<Dimensions>().Width = 16.0f;
+    root->Calculate(800.0f, 600.0f);
+    start = std::chrono::high_resolution_clock::now();
+    ASSERT_TRUE(exporter.Export(*root));
+    us = microsSince(start);
+    std::cout << "[BENCHMARK] incremental export after one edit: " << us << " us, "
+              << exporter.Header().ChangedCount << " entries" << std::endl;
+    ASSERT_EQ(0u, exporter.Header().FullExport);
+    ASSERT_LE(exporter.Header().ChangedCount, static_cast<std::uint32_t>(CellsPerRow + 1));
+    ASSERT_GT(exporter.Header().ChangedCount, 0u);
+    for (std::uint32_t k = 0; k < exporter.Header().ChangedCount; ++k) {
+        const std::uint32_t index = exporter.Changed()[k];
+        ASSERT_GE(index, lastRow);
+        ASSERT_FLOAT_EQ(nodes[index]->GetLayout().ComputedX, exporter.Absolute()[index].X);
+        ASSERT_FLOAT_EQ(nodes[index]->GetLayout().ComputedWidth, exporter.Absolute()[index].Width);
+    }
+
+    // A child-list change re-indexes everything.
+    root->AddChild(std::make_shared<Node>());
+    root->Calculate(800.0f, 600.0f);
+    ASSERT_FALSE(exporter.Export(*root)); // one node over capacity
+    ASSERT_EQ(0u, exporter.Header().NodeCount);
+}
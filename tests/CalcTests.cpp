@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include "masharifcore/Masharif.h"
+
+using namespace masharif;
+
+namespace {
+    SharedNode block(const CSSValue width, const CSSValue height) {
+        auto node = std::make_shared<Node>();
+        node->GetStyle().Modify<Dimensions>().Width = width;
+        node->GetStyle().Modify<Dimensions>().Height = height;
+        return node;
+    }
+}
+
+// Equal sums intern to one id, so a calc() value is as small as any other and compares equal.
+TEST(CalcTests, equal_expressions_share_an_id) {
+    static_assert(sizeof(CSSValue) == 8);
+    const CSSValue a = CSSValue::Calc({.Px = -48.0f, .Percent = 100.0f});
+    const CSSValue b = CSSValue::Calc({.Px = -48.0f, .Percent = 100.0f});
+    const CSSValue c = CSSValue::Calc({.Rem = 1.0f, .Em = 1.0f});
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(c, CSSValue::Calc({.Rem = 2.0f}));
+    EXPECT_FALSE(a == c);
+    EXPECT_TRUE(a.HasPercentage());
+    EXPECT_TRUE(c.IsLength());
+    EXPECT_FLOAT_EQ(152.0f, a.ResolveValue(200.0f));
+}
+
+// calc(100% - 48px) sizes against the containing block as a percentage does; without a
+// percentage it is a plain length, also in indefinite space. Spacing takes calc() too.
+TEST(CalcTests, sizes_and_spacing_resolve) {
+    auto root = block(300.0f, 200.0f);
+    auto banner = block(CSSValue::Calc({.Px = -48.0f, .Percent = 100.0f}), CSSValue::Calc({.Px = 10.0f, .Rem = 1.0f}));
+    root->GetStyle().Modify<PaddingEdge>().Left = CSSValue::Calc({.Px = 4.0f, .Rem = 0.5f});
+    root->AddChild(banner);
+    auto row = std::make_shared<Node>(OuterDisplay::Flex);
+    auto fixed = block(CSSValue::Calc({.Px = 20.0f, .Rem = 2.0f}), 10.0f);
+    row->AddChild(fixed);
+    root->AddChild(row);
+    root->Calculate(300.0f, 200.0f);
+
+    EXPECT_FLOAT_EQ(252.0f, banner->GetLayout().ComputedWidth);
+    EXPECT_FLOAT_EQ(26.0f, banner->GetLayout().ComputedHeight);
+    EXPECT_FLOAT_EQ(12.0f, banner->GetLayout().ComputedX);
+    EXPECT_FLOAT_EQ(52.0f, fixed->GetLayout().ComputedWidth);
+}
+
+// A viewport term registers the node like a vw length: a resize re-solves it alone.
+TEST(CalcTests, viewport_terms_follow_a_resize) {
+    auto root = std::make_shared<Node>(OuterDisplay::Flex);
+    root->GetStyle().Modify<Dimensions>().Width = 400.0f;
+    root->GetStyle().Modify<Dimensions>().Height = 300.0f;
+    root->GetStyle().Modify<CSSFlex>().Direction = FlexDirection::Column;
+    auto still = block(100.0f, 10.0f);
+    auto panel = block(CSSValue::Calc({.Px = -20.0f, .Vw = 50.0f}), 10.0f);
+    root->AddChild(still);
+    root->AddChild(panel);
+    root->Calculate(400.0f, 300.0f);
+    EXPECT_FLOAT_EQ(180.0f, panel->GetLayout().ComputedWidth);
+
+    root->Calculate(600.0f, 300.0f);
+    EXPECT_FLOAT_EQ(280.0f, panel->GetLayout().ComputedWidth);
+    EXPECT_EQ(1u, still->GetLayout().StrategyRuns);
+}
+
+// Images carry their expressions rather than this process's ids.
+TEST(CalcTests, snapshots_and_traces_carry_expressions) {
+    auto root = block(300.0f, 200.0f);
+    auto banner = block(CSSValue::Calc({.Px = -30.0f, .Percent = 50.0f}), 20.0f);
+    root->AddChild(banner);
+    root->Calculate(300.0f, 200.0f);
+
+    const std::vector<std::uint8_t> image = Snapshot::Save(*root);
+    auto loaded = Snapshot::Load(image.data(), image.size());
+    ASSERT_NE(nullptr, loaded);
+    EXPECT_EQ(banner->GetStyle().GetDimensions().Width, loaded->Children()[0]->GetStyle().GetDimensions().Width);
+    loaded->Calculate(300.0f, 200.0f);
+    EXPECT_FLOAT_EQ(120.0f, loaded->Children()[0]->GetLayout().ComputedWidth);
+
+    std::vector<std::uint8_t> trace;
+    {
+        MutationTrace recorder(*root);
+        banner->GetStyle().Modify<Dimensions>().Width = CSSValue::Calc({.Px = 10.0f, .Percent = 25.0f});
+        root->Calculate(300.0f, 200.0f);
+        trace = recorder.Data();
+    }
+    TraceReplayer replayer(trace.data(), trace.size());
+    ASSERT_TRUE(replayer.Valid());
+    TraceReplayer::Frame frame;
+    ASSERT_TRUE(replayer.NextFrame(frame));
+    TraceReplayer::Run(frame);
+    EXPECT_FLOAT_EQ(85.0f, replayer.Root()->Children()[0]->GetLayout().ComputedWidth);
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include "masharifcore/Masharif.h"
+
+#include <chrono>
+
+using namespace masharif;
+
+namespace {
+    std::uint64_t totalStrategyRuns(const SharedNode &node) {
+        std::uint64_t runs = node->GetLayout().StrategyRuns;
+        for (const auto &child : node->Children())
+            runs += totalStrategyRuns(child);
+        return runs;
+    }
+
+    /// A column of `count` content-visibility:auto panels, each 150 tall once laid out
+    /// (three 50px rows) with a 100px placeholder.
+    SharedNode dashboard(const int count) {
+        auto root = std::make_shared<Node>();
+        root->GetStyle().Modify<Dimensions>().Width = 200.0f;
+        for (int i = 0; i < count; ++i) {
+            auto panel = std::make_shared<Node>();
+            panel->GetStyle().Modify<Dimensions>().Visibility = ContentVisibility::Auto;
+            panel->GetStyle().Modify<Dimensions>().ContainIntrinsicHeight = 100.0f;
+            for (int r = 0; r < 3; ++r) {
+                auto row = std::make_shared<Node>();
+                row->GetStyle().Modify<Dimensions>().Height = 50.0f;
+                panel->AddChild(row);
+            }
+            root->AddChild(panel);
+        }
+        return root;
+    }
+}
+
+// Panels near the viewport are laid out within the same Calculate; the rest keep their
+// placeholder and are never solved.
+TEST(ContentVisibilityTests, offscreen_panels_keep_placeholder_size) {
+    auto root = dashboard(100);
+    root->Calculate(200.0f, 1000.0f, ViewportRect{0.0f, 0.0f, 200.0f, 300.0f});
+
+    const auto &panels = root->Children();
+    ASSERT_FLOAT_EQ(150.0f, panels[0]->GetLayout().ComputedHeight);
+    ASSERT_FLOAT_EQ(150.0f, panels[2]->GetLayout().ComputedHeight);
+    ASSERT_FLOAT_EQ(300.0f, panels[2]->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(400.0f, panels[2]->Children()[2]->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(100.0f, panels[3]->GetLayout().ComputedHeight);
+    ASSERT_FLOAT_EQ(450.0f, panels[3]->GetLayout().ComputedY);
+    ASSERT_EQ(0u, panels[50]->GetLayout().StrategyRuns);
+    ASSERT_EQ(0u, panels[50]->Children()[0]->GetLayout().StrategyRuns);
+    ASSERT_FLOAT_EQ(3.0f * 150.0f + 97.0f * 100.0f, root->GetLayout().ComputedHeight);
+}
+
+// A resize re-solves only the laid-out panels; scrolling a panel into view solves it and
+// panels that scroll away keep their laid-out size.
+TEST(ContentVisibilityTests, resize_cost_is_bounded_by_the_visible_panels) {
+    auto root = dashboard(100);
+    root->Calculate(200.0f, 1000.0f, ViewportRect{0.0f, 0.0f, 200.0f, 300.0f});
+
+    const std::uint64_t before = totalStrategyRuns(root);
+    root->GetStyle().Modify<Dimensions>().Width = 300.0f;
+    root->Calculate(300.0f, 1000.0f, ViewportRect{0.0f, 0.0f, 300.0f, 300.0f});
+    ASSERT_LE(totalStrategyRuns(root) - before, 1u + 3u * 4u); // root + 3 panels with 3 rows each
+    ASSERT_FLOAT_EQ(300.0f, root->Children()[0]->GetLayout().ComputedWidth);
+
+    root->Calculate(300.0f, 1000.0f, ViewportRect{0.0f, 1000.0f, 300.0f, 300.0f});
+    const auto &panels = root->Children();
+    ASSERT_FLOAT_EQ(150.0f, panels[0]->GetLayout().ComputedHeight); // remembered, not placeholder
+    ASSERT_FLOAT_EQ(150.0f, panels[9]->GetLayout().ComputedHeight);
+    ASSERT_EQ(0u, panels[20]->GetLayout().StrategyRuns);
+
+    // Without a viewport everything is near: the whole dashboard is laid out.
+    root->Calculate(300.0f, 1000.0f);
+    ASSERT_FLOAT_EQ(150.0f, panels[99]->GetLayout().ComputedHeight);
+    ASSERT_FLOAT_EQ(100.0f * 150.0f, root->GetLayout().ComputedHeight);
+    ASSERT_FLOAT_EQ(99.0f * 150.0f + 100.0f, panels[99]->Children()[2]->GetLayout().ComputedY);
+}
+
+// Panels nested under clean wrappers are reached as well when the viewport moves, and the
+// root still reports the skipped ones deep below it.
+TEST(ContentVisibilityTests, viewport_move_reveals_nested_panels) {
+    auto dash = dashboard(20);
+    auto root = std::make_shared<Node>();
+    root->GetStyle().Modify<Dimensions>().Width = 200.0f;
+    auto outer = std::make_shared<Node>();
+    root->AddChild(outer);
+    auto inner = std::make_shared<Node>();
+    outer->AddChild(inner);
+    inner->AddChild(dash);
+
+    root->Calculate(200.0f, 1000.0f, ViewportRect{0.0f, 0.0f, 200.0f, 300.0f});
+    ASSERT_TRUE(root->HasDeferredLayout());
+    const auto &panels = dash->Children();
+    ASSERT_FLOAT_EQ(100.0f, panels[9]->GetLayout().ComputedHeight);
+
+    root->Calculate(200.0f, 1000.0f, ViewportRect{0.0f, 1000.0f, 200.0f, 300.0f});
+    ASSERT_FLOAT_EQ(150.0f, panels[9]->GetLayout().ComputedHeight);
+}
+
+// A progressive first pass solves the sections in view, in document order, and leaves the
+// rest of the page for a later full frame.
+TEST(ContentVisibilityTests, visible_first_pass_defers_offscreen_sections) {
+    auto page = dashboard(200);
+    for (const auto &section : page->Children())
+        section->GetStyle().Modify<Dimensions>().Visibility = ContentVisibility::Visible;
+    page->CalculateVisibleFirst(200.0f, 1000.0f, ViewportRect{0.0f, 0.0f, 200.0f, 300.0f});
+
+    const auto &sections = page->Children();
+    ASSERT_TRUE(page->HasDeferredLayout());
+    ASSERT_FLOAT_EQ(150.0f, sections[1]->GetLayout().ComputedHeight);
+    ASSERT_FLOAT_EQ(250.0f, sections[1]->Children()[2]->GetPublishedBox().Y);
+    ASSERT_EQ(0u, sections[2]->GetLayout().StrategyRuns);
+    ASSERT_EQ(0u, sections[199]->Children()[0]->GetLayout().StrategyRuns);
+
+    const std::uint64_t before = totalStrategyRuns(page);
+    page->Calculate(200.0f, 1000.0f);
+    ASSERT_FALSE(page->HasDeferredLayout());
+    ASSERT_FLOAT_EQ(200.0f * 150.0f, page->GetLayout().ComputedHeight);
+    ASSERT_FLOAT_EQ(199.0f * 150.0f + 100.0f, sections[199]->Children()[2]->GetPublishedBox().Y);
+    // The completing frame solves only what the first pass left: 198 sections with their rows,
+    // plus the root once per pass.
+    ASSERT_LE(totalStrategyRuns(page) - before, 2u + 198u * 4u);
+}
+
+// The rest of a progressive frame can be completed in slices.
+TEST(ContentVisibilityTests, visible_first_pass_completes_in_slices) {
+    auto page = dashboard(200);
+    for (const auto &section : page->Children())
+        section->GetStyle().Modify<Dimensions>().Visibility = ContentVisibility::Visible;
+    page->CalculateVisibleFirst(200.0f, 1000.0f, ViewportRect{0.0f, 0.0f, 200.0f, 300.0f});
+
+    LayoutProgress progress;
+    while (!progress.Done)
+        progress = page->CalculateFor(200.0f, 1000.0f, std::chrono::steady_clock::time_point{});
+    ASSERT_GT(progress.Slices, 1u);
+    ASSERT_FALSE(page->HasDeferredLayout());
+    ASSERT_FLOAT_EQ(150.0f, page->Children()[120]->GetPublishedBox().Height);
+    ASSERT_FLOAT_EQ(200.0f * 150.0f, page->GetPublishedBox().Height);
+}
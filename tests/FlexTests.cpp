@@ -866,3 +866,88 @@ TEST(FlexTests, percent_cross_margin_offsets_item) {
     ASSERT_FLOAT_EQ(50.0f, child->GetLayout().ComputedWidth);
     ASSERT_FLOAT_EQ(30.0f, child->GetLayout().ComputedHeight);
 }
+
+namespace {
+    /// A fixed-width toolbar row: one inflexible flex-start line.
+    SharedNode toolbar(const std::vector<float> &widths, const float crossOf = 20.0f) {
+        auto root = std::make_shared<Node>();
+        root->SetDisplay(OuterDisplay::Flex);
+        root->GetStyle().Modify<CSSFlex>().Direction = FlexDirection::Row;
+        root->GetStyle().Modify<CSSFlex>().Gaps.Column = 4.0f;
+        root->GetStyle().Modify<Dimensions>().Width = 300.0f;
+        root->GetStyle().Modify<Dimensions>().Height = 40.0f;
+        for (const float width: widths) {
+            auto item = std::make_shared<Node>();
+            item->GetStyle().Modify<Dimensions>().Width = width;
+            item->GetStyle().Modify<Dimensions>().Height = crossOf;
+            item->GetStyle().Modify<MarginEdge>().Left = 2.0f;
+            root->AddChild(item);
+        }
+        // A stretched item: its cross size follows the line, not its content.
+        root->AddChild(std::make_shared<Node>());
+        root->LastChild()->GetStyle().Modify<Dimensions>().Width = 10.0f;
+        return root;
+    }
+
+    void expectSameLayout(const SharedNode &actual, const SharedNode &expected) {
+        ASSERT_EQ(expected->Children().size(), actual->Children().size());
+        for (std::size_t i = 0; i < expected->Children().size(); ++i) {
+            const auto &a = actual->Children()[i]->GetLayout();
+            const auto &e = expected->Children()[i]->GetLayout();
+            EXPECT_FLOAT_EQ(e.ComputedX, a.ComputedX) << "item " << i;
+            EXPECT_FLOAT_EQ(e.ComputedY, a.ComputedY) << "item " << i;
+            EXPECT_FLOAT_EQ(e.ComputedWidth, a.ComputedWidth) << "item " << i;
+            EXPECT_FLOAT_EQ(e.ComputedHeight, a.ComputedHeight) << "item " << i;
+        }
+    }
+}
+
+// Resizing one item of an inflexible line must translate its successors and leave every other
+// item exactly as a from-scratch solve places it, across consecutive incremental frames.
+TEST(FlexTests, inflexible_line_item_resize_matches_full_solve) {
+    auto root = toolbar({40, 40, 40, 40});
+    root->Calculate(300.0f, 40.0f);
+
+    root->Children()[1]->GetStyle().Modify<Dimensions>().Width = 70.0f;
+    root->Calculate(300.0f, 40.0f);
+    // Only the resized item and the root were solved; no other item was even re-measured.
+    EXPECT_EQ(0u, root->GetCacheStats()[CacheEvent::FullReuseHit]);
+    EXPECT_EQ(2u, root->GetCacheStats().Misses());
+    auto expected = toolbar({40, 70, 40, 40});
+    expected->Calculate(300.0f, 40.0f);
+    expectSameLayout(root, expected);
+    ASSERT_FLOAT_EQ(124.0f, root->Children()[2]->GetLayout().ComputedX);
+
+    root->Children()[1]->GetStyle().Modify<Dimensions>().Width = 10.0f;
+    root->Children()[1]->GetStyle().Modify<MarginEdge>().Left = 6.0f;
+    root->Calculate(300.0f, 40.0f);
+    EXPECT_EQ(0u, root->GetCacheStats()[CacheEvent::FullReuseHit]);
+    expected = toolbar({40, 10, 40, 40});
+    expected->Children()[1]->GetStyle().Modify<MarginEdge>().Left = 6.0f;
+    expected->Calculate(300.0f, 40.0f);
+    expectSameLayout(root, expected);
+}
+
+// Edits that change the line's shape fall back to the full solve: an overflowing line shrinks
+// every item, and a taller item changes the line's cross size for the stretched sibling.
+TEST(FlexTests, line_shape_changes_fall_back_to_full_solve) {
+    auto root = toolbar({40, 40, 40, 40});
+    root->Calculate(300.0f, 40.0f);
+
+    root->Children()[0]->GetStyle().Modify<Dimensions>().Width = 260.0f;
+    root->Calculate(300.0f, 40.0f);
+    EXPECT_EQ(4u, root->GetCacheStats()[CacheEvent::FullReuseHit]) << "every other item re-measured";
+    auto expected = toolbar({260, 40, 40, 40});
+    expected->Calculate(300.0f, 40.0f);
+    expectSameLayout(root, expected);
+
+    root->Children()[0]->GetStyle().Modify<Dimensions>().Width = 40.0f;
+    root->Calculate(300.0f, 40.0f);
+    root->Children()[2]->GetStyle().Modify<Dimensions>().Height = 30.0f;
+    root->Calculate(300.0f, 40.0f);
+    EXPECT_LT(0u, root->GetCacheStats()[CacheEvent::FullReuseHit]);
+    expected = toolbar({40, 40, 40, 40});
+    expected->Children()[2]->GetStyle().Modify<Dimensions>().Height = 30.0f;
+    expected->Calculate(300.0f, 40.0f);
+    expectSameLayout(root, expected);
+}
@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include "masharifcore/Masharif.h"
+
+using namespace masharif;
+
+namespace {
+    SharedNode grid(const float width, const GridTemplate &columns, const GridTemplate &rows = {}) {
+        auto node = std::make_shared<Node>(OuterDisplay::Grid);
+        node->GetStyle().Modify<Dimensions>().Width = width;
+        node->GetStyle().Modify<CSSGrid>().TemplateColumns = columns;
+        node->GetStyle().Modify<CSSGrid>().TemplateRows = rows;
+        return node;
+    }
+
+    SharedNode item(const float width = NAN, const float height = NAN) {
+        auto node = std::make_shared<Node>();
+        node->GetStyle().Modify<Dimensions>().Width = width;
+        node->GetStyle().Modify<Dimensions>().Height = height;
+        return node;
+    }
+
+    void expectBox(const SharedNode &node, const float x, const float y, const float w, const float h) {
+        EXPECT_FLOAT_EQ(x, node->GetLayout().ComputedX);
+        EXPECT_FLOAT_EQ(y, node->GetLayout().ComputedY);
+        EXPECT_FLOAT_EQ(w, node->GetLayout().ComputedWidth);
+        EXPECT_FLOAT_EQ(h, node->GetLayout().ComputedHeight);
+    }
+
+    /// A dashboard: four equal columns of cards, each card holding one content leaf.
+    SharedNode dashboard(const int cards, const GridTrack rows) {
+        auto root = grid(400.0f, {GridTrack::Fr(1), GridTrack::Fr(1), GridTrack::Fr(1), GridTrack::Fr(1)});
+        root->GetStyle().Modify<CSSGrid>().AutoRows = rows;
+        root->GetStyle().Modify<CSSFlex>().Gaps.Row = 4.0f;
+        for (int i = 0; i < cards; ++i) {
+            auto card = item();
+            card->AddChild(item(NAN, 30.0f));
+            root->AddChild(card);
+        }
+        return root;
+    }
+}
+
+// Fixed tracks take their size, fr tracks split what is left after them and the gaps; AUTO
+// items stretch to their area, explicit sizes sit at its start.
+TEST(GridTests, px_and_fr_columns_share_the_free_space) {
+    auto root = grid(370.0f, {GridTrack::Px(50), GridTrack::Fr(1), GridTrack::Fr(2)},
+                     {GridTrack::Px(40), GridTrack::Px(20)});
+    root->GetStyle().Modify<CSSFlex>().Gaps.Column = 10.0f;
+    root->GetStyle().Modify<CSSFlex>().Gaps.Row = 5.0f;
+    for (int i = 0; i < 5; ++i)
+        root->AddChild(item());
+    root->AddChild(item(30.0f, 10.0f));
+    root->Calculate(370.0f, 500.0f);
+
+    const auto &c = root->Children();
+    expectBox(c[0], 0.0f, 0.0f, 50.0f, 40.0f);
+    expectBox(c[1], 60.0f, 0.0f, 100.0f, 40.0f);
+    expectBox(c[2], 170.0f, 0.0f, 200.0f, 40.0f);
+    expectBox(c[3], 0.0f, 45.0f, 50.0f, 20.0f);
+    expectBox(c[5], 170.0f, 45.0f, 30.0f, 10.0f);
+    EXPECT_FLOAT_EQ(65.0f, root->GetLayout().ComputedHeight);
+}
+
+// A percentage track resolves against the content box; an auto column takes the leftover
+// space, an auto row its tallest item.
+TEST(GridTests, percent_and_auto_tracks) {
+    auto root = grid(200.0f, {GridTrack::Percent(25), GridTrack::Auto()});
+    root->GetStyle().Modify<PaddingEdge>().Left = 10.0f;
+    root->GetStyle().Modify<PaddingEdge>().Right = 10.0f;
+    root->AddChild(item(NAN, 20.0f));
+    root->AddChild(item(NAN, 35.0f));
+    root->Calculate(200.0f, 500.0f);
+
+    expectBox(root->Children()[0], 10.0f, 0.0f, 45.0f, 20.0f);
+    expectBox(root->Children()[1], 55.0f, 0.0f, 135.0f, 35.0f);
+    EXPECT_FLOAT_EQ(35.0f, root->GetLayout().ComputedHeight);
+}
+
+// Line-based placement claims its area first; the auto-placed items flow around it row by
+// row, spans included.
+TEST(GridTests, explicit_placement_and_spans) {
+    auto root = grid(300.0f, {GridTrack::Px(100), GridTrack::Px(100), GridTrack::Px(100)});
+    root->GetStyle().Modify<CSSGrid>().AutoRows = GridTrack::Px(50);
+    auto placed = item();
+    placed->GetStyle().Modify<CSSGrid>().RowStart = 2;
+    placed->GetStyle().Modify<CSSGrid>().ColumnStart = 2;
+    auto wide = item();
+    wide->GetStyle().Modify<CSSGrid>().ColumnSpan = 2;
+    auto tall = item();
+    tall->GetStyle().Modify<CSSGrid>().RowSpan = 2;
+    root->AddChild(placed);
+    root->AddChild(wide);
+    root->AddChild(tall);
+    root->AddChild(item());
+    root->AddChild(item());
+    root->Calculate(300.0f, 500.0f);
+
+    const auto &c = root->Children();
+    expectBox(c[0], 100.0f, 50.0f, 100.0f, 50.0f);
+    expectBox(c[1], 0.0f, 0.0f, 200.0f, 50.0f);
+    expectBox(c[2], 200.0f, 0.0f, 100.0f, 100.0f);
+    expectBox(c[3], 0.0f, 50.0f, 100.0f, 50.0f);
+    expectBox(c[4], 0.0f, 100.0f, 100.0f, 50.0f);
+    EXPECT_FLOAT_EQ(150.0f, root->GetLayout().ComputedHeight);
+
+    // Moving an item re-places the grid.
+    placed->GetStyle().Modify<CSSGrid>().RowStart = 3;
+    placed->GetStyle().Modify<CSSGrid>().ColumnStart = 3;
+    root->Calculate(300.0f, 500.0f);
+    expectBox(c[0], 200.0f, 100.0f, 100.0f, 50.0f);
+    expectBox(c[3], 0.0f, 50.0f, 100.0f, 50.0f);
+    expectBox(c[4], 100.0f, 50.0f, 100.0f, 50.0f);
+}
+
+// An AUTO-width grid in indefinite space takes its tracks' total: fr tracks size to the
+// largest share any item needs.
+TEST(GridTests, indefinite_grid_sizes_to_its_tracks) {
+    auto row = std::make_shared<Node>(OuterDisplay::Flex);
+    auto root = grid(NAN, {GridTrack::Px(20), GridTrack::Fr(1), GridTrack::Fr(1)});
+    root->GetStyle().Modify<CSSFlex>().Gaps.Column = 5.0f;
+    root->AddChild(item(10.0f, 10.0f));
+    root->AddChild(item(30.0f, 10.0f));
+    root->AddChild(item(40.0f, 10.0f));
+    row->AddChild(root);
+    row->Calculate(500.0f, 500.0f);
+
+    EXPECT_FLOAT_EQ(110.0f, root->GetLayout().ComputedWidth);
+    EXPECT_FLOAT_EQ(70.0f, root->Children()[2]->GetLayout().ComputedX);
+}
+
+// In content-sized rows a percentage height has nothing definite to resolve against: the item
+// stretches to its area as an AUTO one does.
+TEST(GridTests, percent_height_in_content_sized_row_stretches) {
+    auto root = grid(200.0f, {GridTrack::Fr(1), GridTrack::Fr(1)});
+    auto percent = item(50.0f);
+    percent->GetStyle().Modify<Dimensions>().Height = CSSValue(70.0f, CSSUnit::Percent);
+    root->AddChild(percent);
+    root->AddChild(item(NAN, 40.0f));
+    root->Calculate(200.0f, 300.0f);
+
+    expectBox(percent, 0.0f, 0.0f, 50.0f, 40.0f);
+    EXPECT_FLOAT_EQ(40.0f, root->GetLayout().ComputedHeight);
+}
+
+// One grid replaces the row containers of a flex emulation: 200 cards need 401 nodes and the
+// grid solves once per frame. An edit re-solves only its card, and with content-sized rows the
+// memoized tracks are re-sized so the rows below move with it.
+TEST(GridTests, dashboard_solves_once_per_frame) {
+    auto root = dashboard(200, GridTrack::Auto());
+    root->Calculate(400.0f, 10000.0f);
+    EXPECT_EQ(1u, root->GetLayout().StrategyRuns);
+    expectBox(root->Children()[199], 300.0f, 49 * 34.0f, 100.0f, 30.0f);
+    EXPECT_FLOAT_EQ(50 * 34.0f - 4.0f, root->GetLayout().ComputedHeight);
+
+    root->Calculate(400.0f, 10000.0f);
+    EXPECT_EQ(1u, root->GetLayout().StrategyRuns);
+
+    const std::uint32_t neighbourRuns = root->Children()[12]->GetLayout().StrategyRuns;
+    root->Children()[10]->Children()[0]->GetStyle().Modify<Dimensions>().Height = 50.0f;
+    root->Calculate(400.0f, 10000.0f);
+    EXPECT_EQ(2u, root->GetLayout().StrategyRuns);
+    EXPECT_EQ(neighbourRuns, root->Children()[12]->GetLayout().StrategyRuns);
+    expectBox(root->Children()[11], 300.0f, 2 * 34.0f, 100.0f, 50.0f);
+    expectBox(root->Children()[199], 300.0f, 49 * 34.0f + 20.0f, 100.0f, 30.0f);
+}
+
+TEST(GridTests, fixed_rows_keep_their_tracks_when_a_card_changes) {
+    auto root = dashboard(200, GridTrack::Px(40));
+    root->Calculate(400.0f, 10000.0f);
+    expectBox(root->Children()[199], 300.0f, 49 * 44.0f, 100.0f, 40.0f);
+
+    root->Children()[10]->Children()[0]->GetStyle().Modify<Dimensions>().Height = 50.0f;
+    root->Calculate(400.0f, 10000.0f);
+    EXPECT_EQ(2u, root->GetLayout().StrategyRuns);
+    expectBox(root->Children()[10], 200.0f, 2 * 44.0f, 100.0f, 40.0f);
+    expectBox(root->Children()[199], 300.0f, 49 * 44.0f, 100.0f, 40.0f);
+}
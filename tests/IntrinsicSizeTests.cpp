@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include "masharifcore/Masharif.h"
+
+using namespace masharif;
+
+namespace {
+    SharedNode box(const OuterDisplay display, const float width = NAN, const float height = NAN) {
+        auto node = std::make_shared<Node>(display);
+        node->GetStyle().Modify<Dimensions>().Width = width;
+        node->GetStyle().Modify<Dimensions>().Height = height;
+        return node;
+    }
+
+    float size(const SharedNode &node, const IntrinsicSizing sizing, const LayoutAxis axis) {
+        return node->GetIntrinsicSize(sizing, axis);
+    }
+}
+
+// Inline-level boxes share a line at max-content and take one each at min-content; a block
+// always starts its own line. Padding and border wrap the content size.
+TEST(IntrinsicSizeTests, normal_flow_min_and_max_content) {
+    auto root = box(OuterDisplay::Block);
+    root->GetStyle().Modify<PaddingEdge>().Left = 5.0f;
+    root->AddChild(box(OuterDisplay::InlineBlock, 30.0f, 10.0f));
+    root->AddChild(box(OuterDisplay::InlineBlock, 50.0f, 20.0f));
+    root->AddChild(box(OuterDisplay::InlineBlock, 20.0f, 5.0f));
+    root->AddChild(box(OuterDisplay::Block, 40.0f, 8.0f));
+
+    EXPECT_FLOAT_EQ(105.0f, size(root, IntrinsicSizing::MaxContent, LayoutAxis::Horizontal));
+    EXPECT_FLOAT_EQ(55.0f, size(root, IntrinsicSizing::MinContent, LayoutAxis::Horizontal));
+    EXPECT_FLOAT_EQ(28.0f, size(root, IntrinsicSizing::MaxContent, LayoutAxis::Vertical));
+    EXPECT_FLOAT_EQ(43.0f, size(root, IntrinsicSizing::MinContent, LayoutAxis::Vertical));
+}
+
+// Flex items add up along the main axis with the gaps between them, margins included; min/max
+// clamp the container's own size.
+TEST(IntrinsicSizeTests, flex_row_sums_items_and_gaps) {
+    auto row = box(OuterDisplay::Flex);
+    row->GetStyle().Modify<CSSFlex>().Gaps.Column = 5.0f;
+    auto first = box(OuterDisplay::Block, 10.0f, 30.0f);
+    first->GetStyle().Modify<MarginEdge>().Right = 4.0f;
+    row->AddChild(first);
+    row->AddChild(box(OuterDisplay::Block, 20.0f, 12.0f));
+
+    EXPECT_FLOAT_EQ(39.0f, size(row, IntrinsicSizing::MaxContent, LayoutAxis::Horizontal));
+    EXPECT_FLOAT_EQ(30.0f, size(row, IntrinsicSizing::MaxContent, LayoutAxis::Vertical));
+
+    row->GetStyle().Modify<Dimensions>().MaxWidth = 25.0f;
+    EXPECT_FLOAT_EQ(25.0f, size(row, IntrinsicSizing::MaxContent, LayoutAxis::Horizontal));
+}
+
+// The sizes are cached per node; editing a descendant invalidates it and every ancestor.
+TEST(IntrinsicSizeTests, leaf_edit_invalidates_cached_ancestors) {
+    auto root = box(OuterDisplay::Block);
+    auto middle = box(OuterDisplay::InlineBlock);
+    auto leaf = box(OuterDisplay::InlineBlock, 30.0f, 10.0f);
+    middle->AddChild(leaf);
+    root->AddChild(middle);
+    EXPECT_FLOAT_EQ(30.0f, size(root, IntrinsicSizing::MaxContent, LayoutAxis::Horizontal));
+
+    leaf->GetStyle().Modify<Dimensions>().Width = 70.0f;
+    EXPECT_FLOAT_EQ(70.0f, size(middle, IntrinsicSizing::MaxContent, LayoutAxis::Horizontal));
+    EXPECT_FLOAT_EQ(70.0f, size(root, IntrinsicSizing::MaxContent, LayoutAxis::Horizontal));
+}
+
+// An AUTO-width inline-block, and an absolutely positioned block with an AUTO right inset,
+// shrink to fit their content rather than taking a placeholder or the containing block's width.
+TEST(IntrinsicSizeTests, auto_widths_shrink_to_fit) {
+    auto root = box(OuterDisplay::Block, 300.0f);
+    root->GetStyle().Modify<Dimensions>().Position = PositionType::Relative;
+    auto inlineBlock = box(OuterDisplay::InlineBlock);
+    inlineBlock->GetStyle().Modify<PaddingEdge>().Left = 4.0f;
+    inlineBlock->AddChild(box(OuterDisplay::Block, 30.0f, 10.0f));
+    auto overlay = box(OuterDisplay::Block);
+    overlay->GetStyle().Modify<Dimensions>().Position = PositionType::Absolute;
+    overlay->GetStyle().Modify<Dimensions>().Left = 0.0f;
+    overlay->GetStyle().Modify<Dimensions>().Right = CSSValue(0.0f, CSSUnit::Auto);
+    overlay->AddChild(box(OuterDisplay::Block, 45.0f, 10.0f));
+    root->AddChild(inlineBlock);
+    root->AddChild(overlay);
+    root->Calculate(300.0f, 300.0f);
+
+    EXPECT_FLOAT_EQ(34.0f, inlineBlock->GetLayout().ComputedWidth);
+    EXPECT_FLOAT_EQ(45.0f, overlay->GetLayout().ComputedWidth);
+
+    // A containing block narrower than its min-content width does not squeeze it further.
+    root->GetStyle().Modify<Dimensions>().Width = 20.0f;
+    root->Calculate(300.0f, 300.0f);
+    EXPECT_FLOAT_EQ(34.0f, inlineBlock->GetLayout().ComputedWidth);
+}
+
+// Shrink-to-fit reads the intrinsic sizes instead of solving the contents speculatively, so
+// nested inline-blocks take one solve each per frame. An edit re-solves only its path, and
+// every inline-block on it re-fits to the new contents.
+TEST(IntrinsicSizeTests, nested_inline_blocks_solve_once_per_frame) {
+    auto root = box(OuterDisplay::Block, 300.0f);
+    std::vector<SharedNode> path{root};
+    for (int depth = 0; depth < 4; ++depth) {
+        auto inlineBlock = box(OuterDisplay::InlineBlock);
+        inlineBlock->GetStyle().Modify<PaddingEdge>().Left = 2.0f;
+        inlineBlock->AddChild(box(OuterDisplay::InlineBlock, 10.0f, 10.0f));
+        path.back()->AddChild(inlineBlock);
+        path.push_back(inlineBlock);
+    }
+    auto leaf = box(OuterDisplay::InlineBlock, 20.0f, 10.0f);
+    path.back()->AddChild(leaf);
+    root->Calculate(300.0f, 300.0f);
+
+    for (const auto &node: path) {
+        EXPECT_EQ(1u, node->GetLayout().StrategyRuns);
+        EXPECT_EQ(1u, node->Children().front()->GetLayout().StrategyRuns);
+    }
+    EXPECT_FLOAT_EQ(2.0f + 10.0f + 20.0f, path[4]->GetLayout().ComputedWidth);
+    EXPECT_FLOAT_EQ(4 * 12.0f + 20.0f, path[1]->GetLayout().ComputedWidth);
+
+    // Reading the sizes leaves the layout alone.
+    EXPECT_FLOAT_EQ(68.0f, path[1]->GetIntrinsicSize(IntrinsicSizing::MaxContent, LayoutAxis::Horizontal));
+    EXPECT_EQ(1u, path[1]->GetLayout().StrategyRuns);
+
+    leaf->GetStyle().Modify<Dimensions>().Width = 30.0f;
+    root->Calculate(300.0f, 300.0f);
+    for (std::size_t i = 0; i < path.size(); ++i) {
+        EXPECT_EQ(2u, path[i]->GetLayout().StrategyRuns);
+        if (i > 0) {
+            EXPECT_EQ(1u, path[i]->Children().front()->GetLayout().StrategyRuns);
+        }
+    }
+    EXPECT_FLOAT_EQ(78.0f, path[1]->GetLayout().ComputedWidth);
+}
+
+namespace {
+    /// A row too narrow for its three auto-width items, which therefore shrink; the first
+    /// item's grandchild is `leafHeight` tall.
+    SharedNode crowdedRow(const float leafHeight, SharedNode &leaf) {
+        auto row = box(OuterDisplay::Flex, 100.0f, 50.0f);
+        for (int i = 0; i < 3; ++i) {
+            auto item = box(OuterDisplay::Block);
+            auto content = box(OuterDisplay::Block, 40.0f + 20.0f * i, 10.0f);
+            item->AddChild(content);
+            row->AddChild(item);
+        }
+        leaf = box(OuterDisplay::Block, 10.0f, leafHeight);
+        row->Children()[0]->Children()[0]->AddChild(leaf);
+        return row;
+    }
+}
+
+// An item re-solved only for a descendant edit measures its basis from its own width again,
+// not the one its parent's shrink left behind: the row matches a fresh layout.
+TEST(IntrinsicSizeTests, descendant_edit_matches_fresh_layout) {
+    SharedNode leaf, freshLeaf;
+    auto row = crowdedRow(5.0f, leaf);
+    row->Calculate(100.0f, 50.0f);
+    row->Calculate(100.0f, 50.0f);
+    leaf->GetStyle().Modify<Dimensions>().Height = 8.0f;
+    row->Calculate(100.0f, 50.0f);
+
+    auto fresh = crowdedRow(8.0f, freshLeaf);
+    fresh->Calculate(100.0f, 50.0f);
+    for (std::size_t i = 0; i < 3; ++i) {
+        EXPECT_FLOAT_EQ(fresh->Children()[i]->GetLayout().ComputedWidth,
+                        row->Children()[i]->GetLayout().ComputedWidth);
+        EXPECT_FLOAT_EQ(fresh->Children()[i]->GetLayout().ComputedX,
+                        row->Children()[i]->GetLayout().ComputedX);
+    }
+}
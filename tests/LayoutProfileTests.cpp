@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include "masharifcore/Masharif.h"
+
+using namespace masharif;
+
+namespace {
+    std::uint64_t totalStrategyRuns(const SharedNode &node) {
+        std::uint64_t runs = node->GetLayout().StrategyRuns;
+        for (const auto &child : node->Children())
+            runs += totalStrategyRuns(child);
+        return runs;
+    }
+
+    const LayoutProfiler::SubtreeCost *find(const std::vector<LayoutProfiler::SubtreeCost> &top,
+                                            const std::string &tag) {
+        for (const auto &cost : top)
+            if (cost.Tag == tag)
+                return &cost;
+        return nullptr;
+    }
+}
+
+// Strategy runs and time are charged to the tagged subtree they happened in, summed up the
+// tree; untagged nodes count toward the nearest tagged ancestor, here the root.
+TEST(LayoutProfileTests, costs_are_attributed_to_tagged_subtrees) {
+    auto root = std::make_shared<Node>(OuterDisplay::Flex);
+    root->GetStyle().Modify<CSSFlex>().Direction = FlexDirection::Column;
+    auto heavy = std::make_shared<Node>(OuterDisplay::Flex);
+    heavy->GetStyle().Modify<CSSFlex>().Wrap = FlexWrap::Wrap;
+    for (int i = 0; i < 50; ++i) {
+        auto item = std::make_shared<Node>(OuterDisplay::Flex);
+        item->GetStyle().Modify<CSSFlex>().FlexGrow = 1.0f;
+        item->GetStyle().Modify<Dimensions>().Width = 40.0f;
+        heavy->AddChild(item);
+    }
+    auto light = std::make_shared<Node>(OuterDisplay::Flex);
+    light->GetStyle().Modify<Dimensions>().Height = 10.0f;
+    root->AddChild(heavy);
+    root->AddChild(light);
+
+    LayoutProfiler profiler;
+    profiler.Tag(*heavy, "Gallery");
+    profiler.Tag(*heavy->Children()[3], "Gallery"); // nested in a Gallery: counted once
+    profiler.Tag(*light, "Caption");
+    root->Calculate(400.0f, 400.0f);
+
+    const auto top = profiler.Top(*root, 10);
+    ASSERT_EQ(3u, top.size());
+    ASSERT_EQ("root", top[0].Tag);
+    const auto *gallery = find(top, "Gallery");
+    const auto *caption = find(top, "Caption");
+    ASSERT_NE(nullptr, gallery);
+    ASSERT_NE(nullptr, caption);
+    ASSERT_EQ("Gallery", top[1].Tag);
+    ASSERT_EQ(1u, gallery->Instances);
+    ASSERT_EQ(totalStrategyRuns(heavy), gallery->StrategyRuns);
+    ASSERT_EQ(totalStrategyRuns(light), caption->StrategyRuns);
+    ASSERT_EQ(totalStrategyRuns(root), top[0].StrategyRuns);
+    ASSERT_GE(top[0].Time, gallery->Time + caption->Time);
+    ASSERT_EQ(1u, profiler.Top(*root, 1).size());
+    ASSERT_NE(std::string::npos, profiler.Report(*root, 3).find("Gallery"));
+
+    // An idle frame only reuses the root: nothing below it was laid out.
+    profiler.Clear();
+    root->Calculate(400.0f, 400.0f);
+    const auto idle = profiler.Top(*root, 10);
+    ASSERT_EQ(1u, idle.size());
+    ASSERT_EQ(1u, idle[0].Calls);
+    ASSERT_EQ(0u, idle[0].StrategyRuns);
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include "masharifcore/Masharif.h"
+
+using namespace masharif;
+
+// A flex row of grow items inside a normal-flow root: every flex phase runs at least once.
+// Without MASHARIF_LAYOUT_STATS nothing is collected.
+TEST(LayoutStatsTests, phases_are_counted_only_when_enabled) {
+    auto root = std::make_shared<Node>();
+    root->GetStyle().Modify<Dimensions>().Width = 300.0f;
+    auto row = std::make_shared<Node>(OuterDisplay::Flex);
+    for (int i = 0; i < 3; ++i) {
+        auto item = std::make_shared<Node>(OuterDisplay::Flex);
+        item->GetStyle().Modify<CSSFlex>().FlexGrow = 1.0f;
+        item->GetStyle().Modify<Dimensions>().Height = 20.0f;
+        row->AddChild(item);
+    }
+    root->AddChild(row);
+    root->Calculate(300.0f, 200.0f);
+    const LayoutStats &stats = root->GetLayoutStats();
+
+#ifdef MASHARIF_LAYOUT_STATS
+    ASSERT_TRUE(stats.Enabled);
+    ASSERT_EQ(1u, stats[LayoutPhase::NormalFlowStrategy].Calls);
+    ASSERT_GE(stats[LayoutPhase::FlexStrategy].Calls, 4u);
+    for (const LayoutPhase phase : {LayoutPhase::FlexCollectAndOrderItems, LayoutPhase::FlexMeasureItemBases,
+                                    LayoutPhase::FlexBuildLine, LayoutPhase::FlexResolveFlexibleLengths,
+                                    LayoutPhase::FlexAlignLinesOnCrossAxis,
+                                    LayoutPhase::FlexRelayoutItemsAtDefiniteSize, LayoutPhase::PositionsWalk})
+        ASSERT_GT(stats[phase].Calls, 0u) << LayoutPhaseName(phase);
+    // The root strategy encloses everything but the walk; nested sections only add exclusive time.
+    const PhaseStats &document = stats[LayoutPhase::NormalFlowStrategy];
+    ASSERT_GE(document.Inclusive, document.Exclusive);
+    ASSERT_GE(document.Inclusive, stats[LayoutPhase::FlexStrategy].Inclusive);
+
+    // Each Calculate reports only its own frame: an idle one runs no strategy.
+    root->Calculate(300.0f, 200.0f);
+    ASSERT_EQ(0u, root->GetLayoutStats()[LayoutPhase::FlexStrategy].Calls);
+    ASSERT_EQ(1u, root->GetLayoutStats()[LayoutPhase::PositionsWalk].Calls);
+#else
+    ASSERT_FALSE(stats.Enabled);
+    for (const PhaseStats &phase : stats.Phases)
+        ASSERT_EQ(0u, phase.Calls);
+#endif
+}
+
+namespace {
+    std::uint64_t totalStrategyRuns(const SharedNode &node) {
+        std::uint64_t runs = node->GetLayout().StrategyRuns;
+        for (const auto &child : node->Children())
+            runs += totalStrategyRuns(child);
+        return runs;
+    }
+}
+
+// Every strategy run is a counted miss with a reason; idle frames are all hits.
+TEST(LayoutStatsTests, cache_counters_account_for_every_strategy_run) {
+    auto root = std::make_shared<Node>(OuterDisplay::Flex);
+    root->GetStyle().Modify<CSSFlex>().Direction = FlexDirection::Column;
+    std::vector<SharedNode> items;
+    for (int i = 0; i < 4; ++i) {
+        auto row = std::make_shared<Node>(OuterDisplay::Flex);
+        for (int j = 0; j < 4; ++j) {
+            auto item = std::make_shared<Node>(OuterDisplay::Flex);
+            item->GetStyle().Modify<CSSFlex>().FlexGrow = 1.0f;
+            item->GetStyle().Modify<Dimensions>().Height = 10.0f;
+            row->AddChild(item);
+            items.push_back(item);
+        }
+        root->AddChild(row);
+    }
+    auto frame = [&](const float width) {
+        const std::uint64_t before = totalStrategyRuns(root);
+        root->Calculate(width, 400.0f);
+        const CacheStats &stats = root->GetCacheStats();
+        EXPECT_EQ(totalStrategyRuns(root) - before, stats.Misses());
+        return stats;
+    };
+
+    CacheStats stats = frame(300.0f);
+    ASSERT_GT(stats[CacheEvent::LayoutMissDirty], 0u);
+
+    stats = frame(300.0f);
+    ASSERT_EQ(0u, stats.Misses());
+    ASSERT_EQ(1u, stats[CacheEvent::FullReuseHit]);
+
+    items[5]->GetStyle().Modify<Dimensions>().Height = 30.0f;
+    stats = frame(300.0f);
+    ASSERT_GE(stats[CacheEvent::LayoutMissDirty], 1u);
+    ASSERT_GE(stats[CacheEvent::LayoutMissDescendantDirty], 2u); // its row and the root
+    ASSERT_GT(stats.Hits(), 0u); // the untouched rows
+
+    stats = frame(500.0f);
+    ASSERT_GT(stats[CacheEvent::LayoutMissSpaceChanged] + stats[CacheEvent::DefiniteMissSizeChanged], 0u);
+    ASSERT_EQ(0u, stats[CacheEvent::LayoutMissDirty]);
+
+#ifdef MASHARIF_NODE_CACHE_STATS
+    ASSERT_GT(items[5]->GetNodeCacheStats().Hits() + items[5]->GetNodeCacheStats().Misses(), 0u);
+#endif
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include "masharifcore/Masharif.h"
+
+#include <string>
+
+using namespace masharif;
+
+namespace {
+    std::size_t occurrences(const std::string &text, const std::string &needle) {
+        std::size_t count = 0;
+        for (auto at = text.find(needle); at != std::string::npos; at = text.find(needle, at + needle.size()))
+            ++count;
+        return count;
+    }
+
+    SharedNode growRow(const int items) {
+        auto row = std::make_shared<Node>(OuterDisplay::Flex);
+        row->GetStyle().Modify<Dimensions>().Width = 300.0f;
+        for (int i = 0; i < items; ++i) {
+            auto item = std::make_shared<Node>(OuterDisplay::Flex);
+            item->GetStyle().Modify<CSSFlex>().FlexGrow = 1.0f;
+            item->AddChild(std::make_shared<Node>(OuterDisplay::Flex));
+            row->AddChild(item);
+        }
+        return row;
+    }
+}
+
+// One slice per Calculate, LayoutImpl call, definite pass and strategy run, each with the
+// verdict of its reuse check; an idle frame is one slice per reused root.
+TEST(LayoutTraceTests, slices_cover_the_recursion_with_cache_verdicts) {
+    auto row = growRow(3);
+    LayoutTracer tracer;
+    ASSERT_EQ(&tracer, LayoutTracer::Active());
+    row->Calculate(300.0f, 100.0f);
+    const std::string solve = tracer.ToJson();
+
+    ASSERT_EQ(0u, solve.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[{"));
+    ASSERT_EQ(1u, occurrences(solve, "\"name\":\"Calculate\""));
+    ASSERT_EQ(1u, occurrences(solve, "\"name\":\"PositionsWalk\""));
+    ASSERT_GE(occurrences(solve, "\"name\":\"LayoutImpl\""), 7u);
+    ASSERT_EQ(7u, occurrences(solve, "\"cache\":\"LayoutMissDirty\""));
+    // The items' definite passes re-run their contents; a leaf's returns before any check.
+    ASSERT_GE(occurrences(solve, "\"name\":\"LayoutContentsWithDefiniteSize\""), 6u);
+    ASSERT_EQ(3u, occurrences(solve, "\"cache\":\"DefiniteMissSizeChanged\""));
+    ASSERT_NE(std::string::npos, solve.find("\"availableWidth\":300,\"availableHeight\":100"));
+    // Every slice begun was closed: a strategy run per miss, nothing left open.
+    ASSERT_EQ(tracer.Count(), occurrences(solve, "\"ph\":\"X\""));
+
+    tracer.Clear();
+    row->Calculate(300.0f, 100.0f);
+    const std::string idle = tracer.ToJson();
+    ASSERT_EQ(1u, occurrences(idle, "\"name\":\"LayoutImpl\""));
+    ASSERT_EQ(1u, occurrences(idle, "\"cache\":\"FullReuseHit\""));
+    ASSERT_EQ(0u, occurrences(idle, "Strategy\""));
+}
+
+// The ring keeps the newest slices; untraced solves record nothing.
+TEST(LayoutTraceTests, ring_keeps_the_latest_slices) {
+    auto row = growRow(8);
+    {
+        LayoutTracer tracer(4);
+        row->Calculate(300.0f, 100.0f);
+        ASSERT_GT(tracer.Count(), 4u);
+        const std::string json = tracer.ToJson();
+        // The frame slice opened first and was overwritten; the walk ended last and survives.
+        ASSERT_LE(occurrences(json, "\"ph\":\"X\""), 4u);
+        ASSERT_EQ(0u, occurrences(json, "\"name\":\"Calculate\""));
+        ASSERT_EQ(1u, occurrences(json, "\"name\":\"PositionsWalk\""));
+    }
+    ASSERT_EQ(nullptr, LayoutTracer::Active());
+    row->GetStyle().Modify<Dimensions>().Width = 200.0f;
+    row->Calculate(300.0f, 100.0f);
+}
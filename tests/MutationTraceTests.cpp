@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "masharifcore/Masharif.h"
+
+using namespace masharif;
+
+namespace {
+    std::uint64_t totalStrategyRuns(const SharedNode &node) {
+        std::uint64_t runs = node->GetLayout().StrategyRuns;
+        for (const auto &child : node->Children())
+            runs += totalStrategyRuns(child);
+        return runs;
+    }
+
+    SharedNode card(const float height) {
+        auto node = std::make_shared<Node>(OuterDisplay::Flex);
+        node->GetStyle().Modify<Dimensions>().Height = height;
+        auto label = std::make_shared<Node>();
+        label->GetStyle().Modify<CSSFlex>().FlexGrow = 1.0f;
+        node->AddChild(label);
+        return node;
+    }
+
+    /// A column of cards and an absolutely positioned badge.
+    SharedNode screen() {
+        auto root = std::make_shared<Node>();
+        root->GetStyle().Modify<Dimensions>().Width = 320.0f;
+        root->GetStyle().Modify<Dimensions>().Position = PositionType::Relative;
+        for (int i = 0; i < 4; ++i)
+            root->AddChild(card(40.0f + 10.0f * static_cast<float>(i)));
+        auto badge = std::make_shared<Node>();
+        badge->GetStyle().Modify<Dimensions>().Position = PositionType::Absolute;
+        badge->GetStyle().Modify<Dimensions>().Width = 20.0f;
+        badge->GetStyle().Modify<Dimensions>().Height = 20.0f;
+        root->AddChild(badge);
+        return root;
+    }
+
+    void expectSameLayout(const SharedNode &expected, const SharedNode &actual) {
+        ASSERT_EQ(expected->Children().size(), actual->Children().size());
+        EXPECT_FLOAT_EQ(expected->GetLayout().ComputedX, actual->GetLayout().ComputedX);
+        EXPECT_FLOAT_EQ(expected->GetLayout().ComputedY, actual->GetLayout().ComputedY);
+        EXPECT_FLOAT_EQ(expected->GetLayout().ComputedWidth, actual->GetLayout().ComputedWidth);
+        EXPECT_FLOAT_EQ(expected->GetLayout().ComputedHeight, actual->GetLayout().ComputedHeight);
+        for (std::size_t i = 0; i < expected->Children().size(); ++i)
+            expectSameLayout(expected->Children()[i], actual->Children()[i]);
+    }
+}
+
+// Replaying a recorded session reproduces every frame's layout and its strategy runs, from
+// the solved tree recording started on.
+TEST(MutationTraceTests, replay_reproduces_frames_and_strategy_runs) {
+    auto root = screen();
+    root->Calculate(320.0f, 480.0f);
+
+    std::vector<std::uint64_t> recordedRuns;
+    std::vector<std::uint8_t> trace;
+    {
+        MutationTrace recorder(*root);
+        auto frame = [&] {
+            const std::uint64_t before = totalStrategyRuns(root);
+            root->Calculate(320.0f, 480.0f);
+            recordedRuns.push_back(totalStrategyRuns(root) - before);
+        };
+        frame(); // idle
+        root->Children()[1]->GetStyle().Modify<Dimensions>().Height = 90.0f;
+        frame();
+        root->Children()[4]->GetStyle().ModifyInsets().Left = 12.0f;
+        root->Children()[4]->GetStyle().ModifyInsets().Top = 6.0f;
+        frame();
+        auto added = card(30.0f); // built before it joins: embedded as a subtree
+        root->AddChild(added);
+        added->Children()[0]->GetStyle().Modify<PaddingEdge>().Top = 4.0f;
+        frame();
+        root->Children()[2]->SetDisplay(OuterDisplay::None);
+        SharedNode removed = root->Children()[0];
+        root->RemoveChild(removed);
+        frame();
+        root->Children()[1]->SetDisplay(OuterDisplay::Flex);
+        root->SetScrollOffset(0.0f, 25.0f);
+        frame();
+        trace = recorder.Data();
+    }
+    ASSERT_EQ(nullptr, MutationTrace::Active());
+
+    TraceReplayer replayer(trace.data(), trace.size());
+    ASSERT_TRUE(replayer.Valid());
+    TraceReplayer::Frame frame;
+    std::size_t frames = 0;
+    while (replayer.NextFrame(frame)) {
+        ASSERT_LT(frames, recordedRuns.size());
+        ASSERT_EQ(replayer.Root().get(), frame.Target);
+        const std::uint64_t before = totalStrategyRuns(replayer.Root());
+        TraceReplayer::Run(frame);
+        ASSERT_EQ(recordedRuns[frames], totalStrategyRuns(replayer.Root()) - before) << "frame " << frames;
+        ++frames;
+    }
+    ASSERT_EQ(recordedRuns.size(), frames);
+    expectSameLayout(root, replayer.Root());
+    ASSERT_FLOAT_EQ(25.0f, replayer.Root()->ScrollOffsetY());
+}
+
+TEST(MutationTraceTests, damaged_traces_are_rejected) {
+    auto root = screen();
+    std::vector<std::uint8_t> trace;
+    {
+        MutationTrace recorder(*root);
+        root->Calculate(320.0f, 480.0f);
+        trace = recorder.Data();
+    }
+    ASSERT_FALSE(TraceReplayer(trace.data(), 8).Valid());
+    trace[4] ^= 0xFF; // version
+    ASSERT_FALSE(TraceReplayer(trace.data(), trace.size()).Valid());
+    trace[4] ^= 0xFF;
+
+    // A truncated operation ends the replay instead of being applied.
+    TraceReplayer truncated(trace.data(), trace.size() - 1);
+    ASSERT_TRUE(truncated.Valid());
+    TraceReplayer::Frame frame;
+    ASSERT_FALSE(truncated.NextFrame(frame));
+}
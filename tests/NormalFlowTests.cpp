@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+#include "masharifcore/Masharif.h"
+
+using namespace masharif;
+
+namespace {
+    SharedNode block(const float width, const float height) {
+        auto node = std::make_shared<Node>();
+        node->GetStyle().Modify<Dimensions>().Width = width;
+        node->GetStyle().Modify<Dimensions>().Height = height;
+        return node;
+    }
+
+    std::uint64_t totalStrategyRuns(const SharedNode &node) {
+        std::uint64_t runs = node->GetLayout().StrategyRuns;
+        for (const auto &child : node->Children())
+            runs += totalStrategyRuns(child);
+        return runs;
+    }
+
+    SharedNode document(const int blocks) {
+        auto root = std::make_shared<Node>();
+        root->GetStyle().Modify<Dimensions>().Width = 200.0f;
+        for (int i = 0; i < blocks; ++i)
+            root->AddChild(block(200.0f, 10.0f));
+        return root;
+    }
+}
+
+// Growing one block of a stack re-solves only that block; every later sibling must still
+// land below it (shifted by the delta), and earlier ones must not move.
+TEST(NormalFlowTests, grown_block_shifts_later_siblings) {
+    auto root = document(6);
+    root->Calculate(200.0f, 1000.0f);
+    ASSERT_FLOAT_EQ(50.0f, root->Children()[5]->GetLayout().ComputedY);
+
+    root->Children()[2]->GetStyle().Modify<Dimensions>().Height = 30.0f;
+    root->Calculate(200.0f, 1000.0f);
+
+    ASSERT_FLOAT_EQ(10.0f, root->Children()[1]->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(20.0f, root->Children()[2]->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(50.0f, root->Children()[3]->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(70.0f, root->Children()[5]->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(80.0f, root->GetLayout().ComputedHeight);
+
+    // Shrinking it back must restore the original stack exactly.
+    root->Children()[2]->GetStyle().Modify<Dimensions>().Height = 10.0f;
+    root->Calculate(200.0f, 1000.0f);
+    ASSERT_FLOAT_EQ(30.0f, root->Children()[3]->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(50.0f, root->Children()[5]->GetLayout().ComputedY);
+}
+
+TEST(NormalFlowTests, appended_and_removed_blocks_keep_the_stack_contiguous) {
+    auto root = document(4);
+    root->Calculate(200.0f, 1000.0f);
+
+    auto appended = block(200.0f, 25.0f);
+    root->AddChild(appended);
+    root->Calculate(200.0f, 1000.0f);
+    ASSERT_FLOAT_EQ(40.0f, appended->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(65.0f, root->GetLayout().ComputedHeight);
+
+    auto second = root->Children()[1];
+    root->RemoveChild(second);
+    root->Calculate(200.0f, 1000.0f);
+    ASSERT_FLOAT_EQ(10.0f, root->Children()[1]->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(30.0f, appended->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(55.0f, root->GetLayout().ComputedHeight);
+}
+
+// The clean tail holds a wrapped inline-block line and an absolute child: the line moves as a
+// unit and the absolute child is still collected and positioned.
+TEST(NormalFlowTests, shifted_tail_keeps_inline_lines_and_out_of_flow_children) {
+    auto root = document(2);
+    auto inlineA = block(120.0f, 20.0f);
+    inlineA->SetDisplay(OuterDisplay::InlineBlock);
+    auto inlineB = block(120.0f, 20.0f);
+    inlineB->SetDisplay(OuterDisplay::InlineBlock);
+    root->AddChild(inlineA);
+    root->AddChild(inlineB);
+
+    auto abs = block(10.0f, 10.0f);
+    abs->GetStyle().Modify<Dimensions>().Position = PositionType::Absolute;
+    abs->GetStyle().Modify<Dimensions>().Left = 5.0f;
+    abs->GetStyle().Modify<Dimensions>().Top = 7.0f;
+    root->AddChild(abs);
+
+    root->Calculate(200.0f, 1000.0f);
+    ASSERT_FLOAT_EQ(20.0f, inlineA->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(40.0f, inlineB->GetLayout().ComputedY);
+
+    root->Children()[0]->GetStyle().Modify<Dimensions>().Height = 15.0f;
+    root->Calculate(200.0f, 1000.0f);
+
+    ASSERT_FLOAT_EQ(25.0f, inlineA->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(0.0f, inlineB->GetLayout().ComputedX);
+    ASSERT_FLOAT_EQ(45.0f, inlineB->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(5.0f, abs->GetLayout().ComputedX);
+    ASSERT_FLOAT_EQ(7.0f, abs->GetLayout().ComputedY);
+}
+
+// A container style change that moves the content origin invalidates the offset table.
+TEST(NormalFlowTests, padding_change_moves_every_child) {
+    auto root = document(3);
+    root->Calculate(200.0f, 1000.0f);
+
+    root->GetStyle().Modify<PaddingEdge>().Top = 5.0f;
+    root->Calculate(200.0f, 1000.0f);
+
+    ASSERT_FLOAT_EQ(5.0f, root->Children()[0]->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(25.0f, root->Children()[2]->GetLayout().ComputedY);
+}
+
+// Switching tabs hides one panel and shows another: the panel shown again keeps the layout it
+// had when hidden, so nothing inside it re-solves.
+TEST(NormalFlowTests, reshown_panel_reuses_its_cached_layout) {
+    auto root = std::make_shared<Node>();
+    root->GetStyle().Modify<Dimensions>().Width = 200.0f;
+    auto header = block(200.0f, 30.0f);
+    root->AddChild(header);
+    auto tabA = document(50);
+    auto tabB = document(20);
+    tabB->SetDisplay(OuterDisplay::None);
+    root->AddChild(tabA);
+    root->AddChild(tabB);
+
+    root->Calculate(200.0f, 1000.0f);
+    ASSERT_FLOAT_EQ(520.0f, tabA->Children()[49]->GetLayout().ComputedY);
+    const std::uint64_t tabARuns = totalStrategyRuns(tabA);
+
+    tabA->SetDisplay(OuterDisplay::None);
+    tabB->SetDisplay(OuterDisplay::Block);
+    root->Calculate(200.0f, 1000.0f);
+    ASSERT_FLOAT_EQ(30.0f, tabB->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(230.0f, root->GetLayout().ComputedHeight);
+
+    tabB->SetDisplay(OuterDisplay::None);
+    tabA->SetDisplay(OuterDisplay::Block);
+    root->Calculate(200.0f, 1000.0f);
+    ASSERT_EQ(tabARuns, totalStrategyRuns(tabA)) << "showing a cached panel must not re-solve it";
+    ASSERT_FLOAT_EQ(500.0f, tabA->GetLayout().ComputedHeight);
+    ASSERT_FLOAT_EQ(520.0f, tabA->Children()[49]->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(530.0f, root->GetLayout().ComputedHeight);
+
+    // An edit made while hidden is still solved once the panel is shown.
+    tabA->SetDisplay(OuterDisplay::None);
+    root->Calculate(200.0f, 1000.0f);
+    tabA->Children()[0]->GetStyle().Modify<Dimensions>().Height = 20.0f;
+    tabA->SetDisplay(OuterDisplay::Block);
+    root->Calculate(200.0f, 1000.0f);
+    ASSERT_FLOAT_EQ(510.0f, tabA->GetLayout().ComputedHeight);
+    ASSERT_FLOAT_EQ(530.0f, tabA->Children()[49]->GetLayout().ComputedY);
+}
+
+namespace {
+    SharedNode inlineBlock(const float width, const float height) {
+        auto node = block(width, height);
+        node->SetDisplay(OuterDisplay::InlineBlock);
+        return node;
+    }
+}
+
+// An inline-block appended after a partly filled line joins that line, as in a fresh layout.
+TEST(NormalFlowTests, inline_block_appended_to_open_line_matches_fresh_layout) {
+    auto root = document(1);
+    root->AddChild(inlineBlock(50.0f, 10.0f));
+    root->Calculate(200.0f, 1000.0f);
+
+    auto appended = inlineBlock(50.0f, 10.0f);
+    root->AddChild(appended);
+    root->Calculate(200.0f, 1000.0f);
+
+    auto fresh = document(1);
+    fresh->AddChild(inlineBlock(50.0f, 10.0f));
+    fresh->AddChild(inlineBlock(50.0f, 10.0f));
+    fresh->Calculate(200.0f, 1000.0f);
+    ASSERT_FLOAT_EQ(fresh->Children()[2]->GetLayout().ComputedX, appended->GetLayout().ComputedX);
+    ASSERT_FLOAT_EQ(fresh->Children()[2]->GetLayout().ComputedY, appended->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(50.0f, appended->GetLayout().ComputedX);
+    ASSERT_FLOAT_EQ(fresh->GetLayout().ComputedHeight, root->GetLayout().ComputedHeight);
+}
+
+// Replacing the children drops the out-of-flow list with them: the next solve must not resume
+// from pointers into the old children.
+TEST(NormalFlowTests, replaced_children_drop_out_of_flow_list) {
+    auto root = document(2);
+    auto overlay = block(20.0f, 20.0f);
+    overlay->GetStyle().Modify<Dimensions>().Position = PositionType::Absolute;
+    root->AddChild(overlay);
+    root->AddChild(block(200.0f, 10.0f));
+    root->Calculate(200.0f, 1000.0f);
+    overlay.reset();
+
+    root->SetChildren({block(200.0f, 15.0f), block(200.0f, 15.0f)});
+    root->Calculate(200.0f, 1000.0f);
+    ASSERT_FLOAT_EQ(15.0f, root->Children()[1]->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(30.0f, root->GetLayout().ComputedHeight);
+
+    root->ClearChildren();
+    root->AddChild(block(200.0f, 5.0f));
+    root->Calculate(200.0f, 1000.0f);
+    ASSERT_FLOAT_EQ(5.0f, root->GetLayout().ComputedHeight);
+}
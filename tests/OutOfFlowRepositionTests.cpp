@@ -185,3 +185,200 @@ TEST(OutOfFlowRepositionTests, hidden_ancestor_does_not_walk_stale_nested_out_of
 
     EXPECT_FLOAT_EQ(0.0f, cb->GetLayout().ComputedX); // visible tree still sane; no crash
 }
+
+namespace {
+    std::uint64_t totalStrategyRuns(const SharedNode &node) {
+        std::uint64_t sum = node->GetLayout().StrategyRuns;
+        for (const auto &child: node->Children())
+            sum += totalStrategyRuns(child);
+        return sum;
+    }
+}
+
+// Moving a tooltip by its insets is a position-only change: it lands at the new insets (its
+// subtree follows) without any layout strategy running anywhere in the tree.
+TEST(OutOfFlowRepositionTests, inset_change_repositions_without_strategy_runs) {
+    auto root = std::make_shared<Node>();
+    root->GetStyle().Modify<Dimensions>().Width = 300.0f;
+    root->GetStyle().Modify<Dimensions>().Height = 300.0f;
+
+    auto panel = std::make_shared<Node>();
+    panel->GetStyle().Modify<Dimensions>().Position = PositionType::Relative;
+    panel->GetStyle().Modify<Dimensions>().Width = 200.0f;
+    panel->GetStyle().Modify<Dimensions>().Height = 200.0f;
+    root->AddChild(panel);
+
+    auto tooltip = std::make_shared<Node>();
+    tooltip->GetStyle().Modify<Dimensions>().Position = PositionType::Absolute;
+    tooltip->GetStyle().Modify<Dimensions>().Width = 40.0f;
+    tooltip->GetStyle().Modify<Dimensions>().Height = 20.0f;
+    panel->AddChild(tooltip);
+
+    auto label = std::make_shared<Node>();
+    label->GetStyle().Modify<Dimensions>().Width = 10.0f;
+    label->GetStyle().Modify<Dimensions>().Height = 10.0f;
+    tooltip->AddChild(label);
+
+    root->Calculate(300.0f, 300.0f);
+    const std::uint64_t runs = totalStrategyRuns(root);
+
+    tooltip->GetStyle().ModifyInsets().Left = 50.0f;
+    tooltip->GetStyle().ModifyInsets().Top = 30.0f;
+    root->Calculate(300.0f, 300.0f);
+
+    ASSERT_FLOAT_EQ(50.0f, tooltip->GetLayout().ComputedX);
+    ASSERT_FLOAT_EQ(30.0f, tooltip->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(50.0f, label->GetLayout().ComputedX);
+    ASSERT_FLOAT_EQ(30.0f, label->GetLayout().ComputedY);
+    ASSERT_EQ(runs, totalStrategyRuns(root)) << "a position-only change must not re-solve";
+}
+
+// A relative offset shifts the box and its subtree after layout: it does not move its
+// siblings, and changing it runs no strategy.
+TEST(OutOfFlowRepositionTests, relative_offset_shifts_box_but_not_flow) {
+    auto root = std::make_shared<Node>();
+    root->GetStyle().Modify<Dimensions>().Width = 200.0f;
+
+    auto first = std::make_shared<Node>();
+    first->GetStyle().Modify<Dimensions>().Position = PositionType::Relative;
+    first->GetStyle().Modify<Dimensions>().Width = 100.0f;
+    first->GetStyle().Modify<Dimensions>().Height = 20.0f;
+    first->GetStyle().ModifyOffsets().Left = 10.0f;
+    first->GetStyle().ModifyOffsets().Top = 5.0f;
+    root->AddChild(first);
+
+    auto inner = std::make_shared<Node>();
+    inner->GetStyle().Modify<Dimensions>().Width = 10.0f;
+    inner->GetStyle().Modify<Dimensions>().Height = 10.0f;
+    first->AddChild(inner);
+
+    auto second = std::make_shared<Node>();
+    second->GetStyle().Modify<Dimensions>().Width = 100.0f;
+    second->GetStyle().Modify<Dimensions>().Height = 20.0f;
+    root->AddChild(second);
+
+    root->Calculate(200.0f, 200.0f);
+    ASSERT_FLOAT_EQ(10.0f, first->GetLayout().ComputedX);
+    ASSERT_FLOAT_EQ(5.0f, first->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(5.0f, inner->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(20.0f, second->GetLayout().ComputedY);
+
+    const std::uint64_t runs = totalStrategyRuns(root);
+    first->GetStyle().ModifyOffsets().Top = 25.0f;
+    root->Calculate(200.0f, 200.0f);
+
+    ASSERT_FLOAT_EQ(25.0f, first->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(25.0f, inner->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(20.0f, second->GetLayout().ComputedY);
+    ASSERT_EQ(runs, totalStrategyRuns(root));
+}
+
+namespace {
+    SharedNode stickySection(float height, SharedNode &header) {
+        auto section = std::make_shared<Node>();
+        section->GetStyle().Modify<Dimensions>().Width = 200.0f;
+        section->GetStyle().Modify<Dimensions>().Height = height;
+
+        header = std::make_shared<Node>();
+        header->GetStyle().Modify<Dimensions>().Position = PositionType::Sticky;
+        header->GetStyle().Modify<Dimensions>().Top = 0.0f;
+        header->GetStyle().Modify<Dimensions>().Height = 20.0f;
+        section->AddChild(header);
+
+        auto body = std::make_shared<Node>();
+        body->GetStyle().Modify<Dimensions>().Height = height - 20.0f;
+        section->AddChild(body);
+        return section;
+    }
+}
+
+// Sticky headers keep their flow slot and pin to the top of the scroll port's visible rect,
+// but never leave their section. Scrolling re-pins them and runs no strategy.
+TEST(OutOfFlowRepositionTests, scroll_offset_repins_sticky_headers_without_strategy_runs) {
+    auto root = std::make_shared<Node>();
+    root->GetStyle().Modify<Dimensions>().Width = 200.0f;
+
+    auto spacer = std::make_shared<Node>();
+    spacer->GetStyle().Modify<Dimensions>().Height = 50.0f;
+    root->AddChild(spacer);
+
+    auto port = std::make_shared<Node>();
+    port->GetStyle().Modify<Dimensions>().Height = 100.0f;
+    port->SetScrollOffset(0.0f, 0.0f);
+    root->AddChild(port);
+
+    SharedNode headerA, headerB;
+    auto sectionA = stickySection(300.0f, headerA);
+    auto sectionB = stickySection(300.0f, headerB);
+    port->AddChild(sectionA);
+    port->AddChild(sectionB);
+
+    auto label = std::make_shared<Node>();
+    label->GetStyle().Modify<Dimensions>().Width = 10.0f;
+    label->GetStyle().Modify<Dimensions>().Height = 10.0f;
+    headerA->AddChild(label);
+
+    root->Calculate(200.0f, 400.0f);
+    ASSERT_FLOAT_EQ(50.0f, headerA->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(70.0f, sectionA->Children()[1]->GetLayout().ComputedY); // in flow
+    ASSERT_FLOAT_EQ(350.0f, headerB->GetLayout().ComputedY);
+
+    const std::uint64_t runs = totalStrategyRuns(root);
+
+    port->SetScrollOffset(0.0f, 120.0f);
+    root->Calculate(200.0f, 400.0f);
+    ASSERT_FLOAT_EQ(170.0f, headerA->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(170.0f, label->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(350.0f, headerB->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(50.0f, sectionA->GetLayout().ComputedY); // content does not move
+
+    // Past the end of section A its header stops at the section's bottom edge.
+    port->SetScrollOffset(0.0f, 350.0f);
+    root->Calculate(200.0f, 400.0f);
+    ASSERT_FLOAT_EQ(330.0f, headerA->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(400.0f, headerB->GetLayout().ComputedY);
+
+    port->SetScrollOffset(0.0f, 0.0f);
+    root->Calculate(200.0f, 400.0f);
+    ASSERT_FLOAT_EQ(50.0f, headerA->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(50.0f, label->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(350.0f, headerB->GetLayout().ComputedY);
+    ASSERT_EQ(runs, totalStrategyRuns(root)) << "a scroll-only frame must not re-solve";
+}
+
+// The walk must find a sticky node below clean intermediate boxes: scrolling re-pins it where a
+// fresh tree would put it, however deep it sits under the port.
+TEST(OutOfFlowRepositionTests, scroll_offset_repins_nested_sticky) {
+    auto root = std::make_shared<Node>();
+    root->GetStyle().Modify<Dimensions>().Width = 200.0f;
+    root->GetStyle().Modify<Dimensions>().Height = 300.0f;
+    root->SetScrollOffset(0.0f, 0.0f);
+
+    auto outer = std::make_shared<Node>();
+    outer->GetStyle().Modify<Dimensions>().Height = 1000.0f;
+    root->AddChild(outer);
+    auto inner = std::make_shared<Node>();
+    inner->GetStyle().Modify<Dimensions>().Height = 1000.0f;
+    outer->AddChild(inner);
+
+    auto spacer = std::make_shared<Node>();
+    spacer->GetStyle().Modify<Dimensions>().Height = 100.0f;
+    inner->AddChild(spacer);
+    auto header = std::make_shared<Node>();
+    header->GetStyle().Modify<Dimensions>().Position = PositionType::Sticky;
+    header->GetStyle().Modify<Dimensions>().Top = 0.0f;
+    header->GetStyle().Modify<Dimensions>().Height = 20.0f;
+    inner->AddChild(header);
+
+    root->Calculate(200.0f, 300.0f);
+    root->Calculate(200.0f, 300.0f);
+    ASSERT_FLOAT_EQ(100.0f, header->GetLayout().ComputedY);
+
+    root->SetScrollOffset(0.0f, 500.0f);
+    root->Calculate(200.0f, 300.0f);
+    ASSERT_FLOAT_EQ(500.0f, header->GetLayout().ComputedY);
+
+    root->SetScrollOffset(0.0f, 50.0f);
+    root->Calculate(200.0f, 300.0f);
+    ASSERT_FLOAT_EQ(100.0f, header->GetLayout().ComputedY);
+}
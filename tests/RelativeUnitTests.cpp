@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include "masharifcore/Masharif.h"
+
+using namespace masharif;
+
+namespace {
+    SharedNode block(const CSSValue width, const CSSValue height) {
+        auto node = std::make_shared<Node>();
+        node->GetStyle().Modify<Dimensions>().Width = width;
+        node->GetStyle().Modify<Dimensions>().Height = height;
+        return node;
+    }
+
+    /// A fixed-size flex column of px blocks with one banner: the items see the page's content
+    /// box whatever the viewport, so only a unit dependency can re-solve them.
+    SharedNode page(const SharedNode &banner) {
+        auto root = block(400.0f, 300.0f);
+        root->SetDisplay(OuterDisplay::Flex);
+        root->GetStyle().Modify<CSSFlex>().Direction = FlexDirection::Column;
+        for (int i = 0; i < 20; ++i)
+            root->AddChild(block(100.0f, 10.0f));
+        root->AddChild(banner);
+        return root;
+    }
+}
+
+// Viewport units take the root's available space, font units the root font size, everywhere a
+// length is read: sizes, spacing, gaps.
+TEST(RelativeUnitTests, units_resolve_against_the_frame) {
+    auto root = std::make_shared<Node>(OuterDisplay::Flex);
+    root->GetStyle().Modify<CSSFlex>().Gaps.Column = CSSValue(1.0f, CSSUnit::Rem);
+    auto first = block(CSSValue(25.0f, CSSUnit::Vw), CSSValue(10.0f, CSSUnit::Vh));
+    first->GetStyle().Modify<PaddingEdge>().Left = CSSValue(0.5f, CSSUnit::Em);
+    root->AddChild(first);
+    auto second = block(CSSValue(2.0f, CSSUnit::Rem), 10.0f);
+    root->AddChild(second);
+    root->Calculate(400.0f, 300.0f);
+
+    EXPECT_FLOAT_EQ(100.0f, first->GetLayout().ComputedWidth);
+    EXPECT_FLOAT_EQ(30.0f, first->GetLayout().ComputedHeight);
+    EXPECT_FLOAT_EQ(32.0f, second->GetLayout().ComputedWidth);
+    EXPECT_FLOAT_EQ(116.0f, second->GetLayout().ComputedX);
+
+    root->SetRootFontSize(10.0f);
+    root->Calculate(400.0f, 300.0f);
+    EXPECT_FLOAT_EQ(20.0f, second->GetLayout().ComputedWidth);
+    EXPECT_FLOAT_EQ(110.0f, second->GetLayout().ComputedX);
+}
+
+// A resize re-solves the nodes using the changed reference and their ancestors, not the rest;
+// a change of the other axis re-solves none of them.
+TEST(RelativeUnitTests, resize_dirties_only_dependents) {
+    auto banner = block(CSSValue(50.0f, CSSUnit::Vw), 20.0f);
+    auto root = page(banner);
+    root->Calculate(400.0f, 300.0f);
+    EXPECT_FLOAT_EQ(200.0f, banner->GetLayout().ComputedWidth);
+
+    root->Calculate(600.0f, 300.0f);
+    EXPECT_FLOAT_EQ(300.0f, banner->GetLayout().ComputedWidth);
+    EXPECT_EQ(2u, banner->GetLayout().StrategyRuns);
+    EXPECT_EQ(2u, root->GetLayout().StrategyRuns);
+    for (int i = 0; i < 20; ++i)
+        EXPECT_EQ(1u, root->Children()[i]->GetLayout().StrategyRuns);
+
+    root->Calculate(600.0f, 500.0f);
+    EXPECT_EQ(2u, banner->GetLayout().StrategyRuns);
+
+    root->SetRootFontSize(20.0f);
+    root->Calculate(600.0f, 500.0f);
+    EXPECT_EQ(2u, banner->GetLayout().StrategyRuns);
+}
+
+// The dependency is read from the style whenever it is written: switching a node to px takes
+// it out of the registry, and a hidden dependent still follows a resize once shown.
+TEST(RelativeUnitTests, registry_follows_style_writes) {
+    auto banner = block(100.0f, 20.0f);
+    auto root = page(banner);
+    root->Calculate(400.0f, 300.0f);
+
+    banner->GetStyle().Modify<Dimensions>().Height = CSSValue(10.0f, CSSUnit::Vh);
+    root->Calculate(400.0f, 300.0f);
+    EXPECT_FLOAT_EQ(30.0f, banner->GetLayout().ComputedHeight);
+
+    banner->SetDisplay(OuterDisplay::None);
+    root->Calculate(400.0f, 500.0f);
+    banner->SetDisplay(OuterDisplay::Block);
+    root->Calculate(400.0f, 500.0f);
+    EXPECT_FLOAT_EQ(50.0f, banner->GetLayout().ComputedHeight);
+
+    banner->GetStyle().Modify<Dimensions>().Height = 20.0f;
+    root->Calculate(400.0f, 500.0f);
+    const std::uint32_t runs = banner->GetLayout().StrategyRuns;
+    root->Calculate(400.0f, 700.0f);
+    EXPECT_EQ(runs, banner->GetLayout().StrategyRuns);
+}
+
+// The registry reaches dependents at any depth, below clean boxes that use no unit themselves,
+// and out-of-flow ones too.
+TEST(RelativeUnitTests, nested_dependents_follow_the_frame) {
+    auto root = block(400.0f, 300.0f);
+    auto outer = block(100.0f, 100.0f);
+    root->AddChild(outer);
+    auto inner = block(100.0f, 100.0f);
+    inner->GetStyle().Modify<Dimensions>().Position = PositionType::Relative;
+    outer->AddChild(inner);
+    auto leaf = block(CSSValue(2.0f, CSSUnit::Rem), 10.0f);
+    inner->AddChild(leaf);
+    auto badge = block(CSSValue(2.0f, CSSUnit::Vw), 10.0f);
+    badge->GetStyle().Modify<Dimensions>().Position = PositionType::Absolute;
+    inner->AddChild(badge);
+
+    root->Calculate(400.0f, 300.0f);
+    root->Calculate(400.0f, 300.0f);
+    EXPECT_FLOAT_EQ(32.0f, leaf->GetLayout().ComputedWidth);
+    EXPECT_FLOAT_EQ(8.0f, badge->GetLayout().ComputedWidth);
+
+    root->SetRootFontSize(10.0f);
+    root->Calculate(400.0f, 300.0f);
+    EXPECT_FLOAT_EQ(20.0f, leaf->GetLayout().ComputedWidth);
+
+    for (int i = 0; i < 5; ++i)
+        root->Calculate(400.0f, 300.0f);
+    root->Calculate(600.0f, 300.0f);
+    EXPECT_FLOAT_EQ(12.0f, badge->GetLayout().ComputedWidth);
+    EXPECT_FLOAT_EQ(20.0f, leaf->GetLayout().ComputedWidth);
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include "masharifcore/Masharif.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+
+using namespace masharif;
+
+namespace {
+    /// A feed of `cards` flex-row cards, each an avatar plus a column of three text rows; 400
+    /// wide unless `fill`, which makes it as wide as the space it is laid out in.
+    SharedNode feed(const int cards, const bool fill = false) {
+        auto root = std::make_shared<Node>();
+        if (!fill)
+            root->GetStyle().Modify<Dimensions>().Width = 400.0f;
+        for (int i = 0; i < cards; ++i) {
+            auto card = std::make_shared<Node>();
+            card->GetStyle().Modify<Dimensions>().Display = OuterDisplay::Flex;
+            card->GetStyle().Modify<PaddingEdge>().Top = 4.0f;
+            auto avatar = std::make_shared<Node>();
+            avatar->GetStyle().Modify<Dimensions>().Width = 40.0f;
+            avatar->GetStyle().Modify<Dimensions>().Height = 40.0f;
+            card->AddChild(avatar);
+            auto body = std::make_shared<Node>();
+            body->GetStyle().Modify<CSSFlex>().FlexGrow = 1.0f;
+            for (int r = 0; r < 3; ++r) {
+                auto line = std::make_shared<Node>();
+                line->GetStyle().Modify<Dimensions>().Height = 10.0f + static_cast<float>((i + r) % 4);
+                body->AddChild(line);
+            }
+            card->AddChild(body);
+            root->AddChild(card);
+        }
+        return root;
+    }
+
+    void forEachPair(const SharedNode &a, const SharedNode &b,
+                     const std::function<void(Node &, Node &)> &visit) {
+        visit(*a, *b);
+        for (std::size_t i = 0; i < a->Children().size(); ++i)
+            forEachPair(a->Children()[i], b->Children()[i], visit);
+    }
+
+    /// Slices with a deadline that has always passed: every slice does its minimum of work.
+    LayoutProgress sliceToEnd(const SharedNode &root, const float width, const float height) {
+        LayoutProgress progress;
+        for (int guard = 0; guard < 100000 && !progress.Done; ++guard)
+            progress = root->CalculateFor(width, height, std::chrono::steady_clock::time_point{});
+        return progress;
+    }
+}
+
+// A frame sliced into many small steps ends exactly where a single Calculate does, and only
+// then publishes its boxes.
+TEST(SlicedLayoutTests, sliced_frame_matches_a_single_calculate) {
+    auto sliced = feed(100);
+    auto reference = feed(100);
+    reference->Calculate(400.0f, 800.0f);
+
+    const LayoutProgress first = sliced->CalculateFor(400.0f, 800.0f, std::chrono::steady_clock::time_point{});
+    ASSERT_FALSE(first.Done);
+    ASSERT_GT(first.Solves, 0u);
+    ASSERT_FLOAT_EQ(0.0f, sliced->Children()[99]->GetPublishedBox().Height);
+
+    const LayoutProgress last = sliceToEnd(sliced, 400.0f, 800.0f);
+    ASSERT_TRUE(last.Done);
+    ASSERT_GT(last.Slices, 2u);
+
+    forEachPair(sliced, reference, [](Node &a, Node &b) {
+        ASSERT_FLOAT_EQ(b.GetLayout().ComputedX, a.GetPublishedBox().X);
+        ASSERT_FLOAT_EQ(b.GetLayout().ComputedY, a.GetPublishedBox().Y);
+        ASSERT_FLOAT_EQ(b.GetLayout().ComputedWidth, a.GetPublishedBox().Width);
+        ASSERT_FLOAT_EQ(b.GetLayout().ComputedHeight, a.GetPublishedBox().Height);
+        ASSERT_FLOAT_EQ(b.GetLayout().ComputedY, a.GetLayout().ComputedY);
+    });
+}
+
+// While a resize is being sliced the previous frame stays published; an edit between slices
+// restarts the frame, which then lands on the edited tree.
+TEST(SlicedLayoutTests, edit_between_slices_restarts_the_frame) {
+    auto root = feed(100);
+    root->Calculate(400.0f, 800.0f);
+
+    root->GetStyle().Modify<Dimensions>().Width = 300.0f;
+    const LayoutProgress first = root->CalculateFor(300.0f, 800.0f, std::chrono::steady_clock::time_point{});
+    ASSERT_FALSE(first.Done);
+    ASSERT_FLOAT_EQ(400.0f, root->GetPublishedBox().Width);
+    const LayoutProgress second = root->CalculateFor(300.0f, 800.0f, std::chrono::steady_clock::time_point{});
+    ASSERT_EQ(2u, second.Slices);
+
+    root->Children()[0]->Children()[0]->GetStyle().Modify<Dimensions>().Height = 80.0f;
+    const LayoutProgress restarted = root->CalculateFor(300.0f, 800.0f, std::chrono::steady_clock::time_point{});
+    ASSERT_EQ(1u, restarted.Slices);
+    ASSERT_TRUE(sliceToEnd(root, 300.0f, 800.0f).Done);
+
+    auto reference = feed(100);
+    reference->GetStyle().Modify<Dimensions>().Width = 300.0f;
+    reference->Children()[0]->Children()[0]->GetStyle().Modify<Dimensions>().Height = 80.0f;
+    reference->Calculate(300.0f, 800.0f);
+    ASSERT_FLOAT_EQ(300.0f, root->GetPublishedBox().Width);
+    forEachPair(root, reference, [](Node &a, Node &b) {
+        ASSERT_FLOAT_EQ(b.GetLayout().ComputedY, a.GetPublishedBox().Y);
+        ASSERT_FLOAT_EQ(b.GetLayout().ComputedWidth, a.GetPublishedBox().Width);
+        ASSERT_FLOAT_EQ(b.GetLayout().ComputedHeight, a.GetPublishedBox().Height);
+    });
+}
+
+// With time to spare a sliced frame finishes in one call, like Calculate.
+TEST(SlicedLayoutTests, generous_deadline_finishes_in_one_slice) {
+    auto root = feed(10);
+    const auto progress = root->CalculateFor(400.0f, 800.0f,
+                                             std::chrono::steady_clock::now() + std::chrono::hours(1));
+    ASSERT_TRUE(progress.Done);
+    ASSERT_EQ(1u, progress.Slices);
+    ASSERT_FLOAT_EQ(root->GetLayout().ComputedHeight, root->GetPublishedBox().Height);
+}
+
+// A slice starts where the last one stopped: the feed continues at the card it stopped on
+// instead of replaying every card finished before it.
+TEST(SlicedLayoutTests, slice_continues_where_the_last_one_stopped) {
+    auto root = feed(100);
+    LayoutProgress progress;
+    std::uint64_t replays = 0;
+    while (!progress.Done) {
+        progress = root->CalculateFor(400.0f, 800.0f, std::chrono::steady_clock::time_point{});
+        replays = std::max(replays, root->GetCacheStats()[CacheEvent::MeasureHit]);
+    }
+    ASSERT_GT(progress.Slices, 10u);
+    // At most the few card children finished before the solve a slice stopped in.
+    ASSERT_LT(replays, 8u);
+}
+
+// A frame abandoned between slices leaves nothing half solved behind: going back to the last
+// completed space re-solves what the slices had already moved to the new one.
+TEST(SlicedLayoutTests, abandoned_frame_leaves_no_partial_layout) {
+    auto root = feed(100, true);
+    root->Calculate(400.0f, 800.0f);
+    for (int i = 0; i < 3; ++i)
+        ASSERT_FALSE(root->CalculateFor(300.0f, 800.0f, std::chrono::steady_clock::time_point{}).Done);
+    root->Calculate(400.0f, 800.0f);
+
+    auto reference = feed(100, true);
+    reference->Calculate(400.0f, 800.0f);
+    forEachPair(root, reference, [](Node &a, Node &b) {
+        ASSERT_FLOAT_EQ(b.GetLayout().ComputedX, a.GetPublishedBox().X);
+        ASSERT_FLOAT_EQ(b.GetLayout().ComputedY, a.GetPublishedBox().Y);
+        ASSERT_FLOAT_EQ(b.GetLayout().ComputedWidth, a.GetPublishedBox().Width);
+        ASSERT_FLOAT_EQ(b.GetLayout().ComputedHeight, a.GetPublishedBox().Height);
+    });
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include "masharifcore/Masharif.h"
+
+using namespace masharif;
+
+namespace {
+    std::uint64_t totalStrategyRuns(const SharedNode &node) {
+        std::uint64_t runs = node->GetLayout().StrategyRuns;
+        for (const auto &child : node->Children())
+            runs += totalStrategyRuns(child);
+        return runs;
+    }
+
+    /// Header bar, a flex row of cards and an absolutely positioned badge.
+    SharedNode screen() {
+        auto root = std::make_shared<Node>();
+        root->GetStyle().Modify<Dimensions>().Width = 320.0f;
+        root->GetStyle().Modify<Dimensions>().Position = PositionType::Relative;
+
+        auto header = std::make_shared<Node>();
+        header->GetStyle().Modify<Dimensions>().Height = 48.0f;
+        root->AddChild(header);
+
+        auto row = std::make_shared<Node>(OuterDisplay::Flex);
+        row->GetStyle().Modify<PaddingEdge>().Left = 8.0f;
+        for (int i = 0; i < 3; ++i) {
+            auto card = std::make_shared<Node>();
+            card->GetStyle().Modify<CSSFlex>().FlexGrow = 1.0f;
+            card->GetStyle().Modify<Dimensions>().Height = 60.0f + 10.0f * static_cast<float>(i);
+            row->AddChild(card);
+        }
+        root->AddChild(row);
+
+        auto badge = std::make_shared<Node>();
+        badge->GetStyle().Modify<Dimensions>().Position = PositionType::Absolute;
+        badge->GetStyle().Modify<Dimensions>().Width = 20.0f;
+        badge->GetStyle().Modify<Dimensions>().Height = 20.0f;
+        badge->GetStyle().ModifyInsets().Left = 4.0f;
+        badge->GetStyle().ModifyInsets().Top = 4.0f;
+        root->AddChild(badge);
+        return root;
+    }
+
+    void expectSameLayout(const SharedNode &expected, const SharedNode &actual) {
+        ASSERT_EQ(expected->Children().size(), actual->Children().size());
+        EXPECT_FLOAT_EQ(expected->GetLayout().ComputedX, actual->GetLayout().ComputedX);
+        EXPECT_FLOAT_EQ(expected->GetLayout().ComputedY, actual->GetLayout().ComputedY);
+        EXPECT_FLOAT_EQ(expected->GetLayout().ComputedWidth, actual->GetLayout().ComputedWidth);
+        EXPECT_FLOAT_EQ(expected->GetLayout().ComputedHeight, actual->GetLayout().ComputedHeight);
+        for (std::size_t i = 0; i < expected->Children().size(); ++i)
+            expectSameLayout(expected->Children()[i], actual->Children()[i]);
+    }
+}
+
+// A snapshot of a solved tree reloads solved: the first frame at the same space runs no
+// strategy, and the reloaded tree keeps responding to edits.
+TEST(SnapshotTests, solved_snapshot_reloads_without_strategy_runs) {
+    auto original = screen();
+    original->Calculate(320.0f, 480.0f);
+    const std::vector<std::uint8_t> image = Snapshot::Save(*original);
+
+    auto loaded = Snapshot::Load(image.data(), image.size());
+    ASSERT_NE(nullptr, loaded);
+    const std::uint64_t before = totalStrategyRuns(loaded);
+    loaded->Calculate(320.0f, 480.0f);
+    ASSERT_EQ(before, totalStrategyRuns(loaded));
+    expectSameLayout(original, loaded);
+    ASSERT_FLOAT_EQ(4.0f, loaded->Children()[2]->GetPublishedBox().X);
+
+    // The absolute badge is repositioned from the reloaded out-of-flow list.
+    original->Children()[2]->GetStyle().ModifyInsets().Left = 10.0f;
+    loaded->Children()[2]->GetStyle().ModifyInsets().Left = 10.0f;
+    original->Children()[1]->Children()[0]->GetStyle().Modify<Dimensions>().Height = 100.0f;
+    loaded->Children()[1]->Children()[0]->GetStyle().Modify<Dimensions>().Height = 100.0f;
+    original->Calculate(320.0f, 480.0f);
+    loaded->Calculate(320.0f, 480.0f);
+    expectSameLayout(original, loaded);
+    ASSERT_FLOAT_EQ(10.0f, loaded->Children()[2]->GetLayout().ComputedX);
+}
+
+// Without the layout a snapshot reloads as a fresh tree with the same styles.
+TEST(SnapshotTests, style_only_snapshot_reloads_unsolved) {
+    auto original = screen();
+    const std::vector<std::uint8_t> image = Snapshot::Save(*original, false);
+    original->Calculate(320.0f, 480.0f);
+
+    auto loaded = Snapshot::Load(image.data(), image.size());
+    ASSERT_NE(nullptr, loaded);
+    ASSERT_EQ(0u, totalStrategyRuns(loaded));
+    loaded->Calculate(320.0f, 480.0f);
+    expectSameLayout(original, loaded);
+}
+
+// The unit registry and the root font size travel with a solved image: the reload runs no
+// strategy at the same space, and a later resize still reaches the dependents.
+TEST(SnapshotTests, relative_units_survive_a_reload) {
+    auto original = screen();
+    original->SetRootFontSize(20.0f);
+    original->Children()[0]->GetStyle().Modify<Dimensions>().Width = CSSValue(50.0f, CSSUnit::Vw);
+    original->Children()[0]->GetStyle().Modify<PaddingEdge>().Left = CSSValue(1.0f, CSSUnit::Rem);
+    original->Calculate(320.0f, 480.0f);
+    const std::vector<std::uint8_t> image = Snapshot::Save(*original);
+
+    auto loaded = Snapshot::Load(image.data(), image.size());
+    ASSERT_NE(nullptr, loaded);
+    EXPECT_FLOAT_EQ(20.0f, loaded->RootFontSize());
+    const std::uint64_t runs = totalStrategyRuns(loaded);
+    loaded->Calculate(320.0f, 480.0f);
+    EXPECT_EQ(runs, totalStrategyRuns(loaded));
+
+    loaded->Calculate(300.0f, 480.0f);
+    original->Calculate(300.0f, 480.0f);
+    expectSameLayout(original, loaded);
+    EXPECT_FLOAT_EQ(150.0f, loaded->Children()[0]->GetLayout().ComputedWidth);
+}
+
+// A loaded tree is released with its last handle, like one built node by node.
+TEST(SnapshotTests, loaded_tree_is_destroyed_with_its_root) {
+    const auto image = Snapshot::Save(*screen());
+    SharedNode root = Snapshot::Load(image.data(), image.size());
+    ASSERT_NE(nullptr, root);
+    const std::weak_ptr<Node> weakRoot = root;
+    const std::weak_ptr<Node> card = root->Children()[1]->Children()[2];
+    root.reset();
+    EXPECT_TRUE(weakRoot.expired());
+    EXPECT_TRUE(card.expired());
+}
+
+TEST(SnapshotTests, damaged_images_are_rejected) {
+    auto root = screen();
+    root->Calculate(320.0f, 480.0f);
+    std::vector<std::uint8_t> image = Snapshot::Save(*root);
+
+    ASSERT_EQ(nullptr, Snapshot::Load(image.data(), image.size() - 1));
+    ASSERT_EQ(nullptr, Snapshot::Load(image.data(), 8));
+    image[4] ^= 0xFF; // version
+    ASSERT_EQ(nullptr, Snapshot::Load(image.data(), image.size()));
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include "masharifcore/Masharif.h"
+
+#include <vector>
+
+using namespace masharif;
+
+namespace {
+    /// Fixed-height rows with a node pool; counts the nodes it ever had to create.
+    class RowSource final : public VirtualListSource {
+    public:
+        RowSource(std::size_t count, float rowHeight, float estimate)
+            : m_count(count), m_rowHeight(rowHeight), m_estimate(estimate) {
+        }
+
+        [[nodiscard]] std::size_t ItemCount() const override { return m_count; }
+
+        [[nodiscard]] float EstimatedItemSize() const override { return m_estimate; }
+
+        SharedNode Materialize(std::size_t /*index*/) override {
+            SharedNode row;
+            if (m_pool.empty()) {
+                row = std::make_shared<Node>();
+                ++Created;
+            } else {
+                row = std::move(m_pool.back());
+                m_pool.pop_back();
+            }
+            row->GetStyle().Modify<Dimensions>().Height = m_rowHeight;
+            return row;
+        }
+
+        void Recycle(std::size_t /*index*/, SharedNode node) override {
+            ++Recycled;
+            m_pool.push_back(std::move(node));
+        }
+
+        std::size_t Created = 0;
+        std::size_t Recycled = 0;
+
+    private:
+        std::size_t m_count;
+        float m_rowHeight;
+        float m_estimate;
+        std::vector<SharedNode> m_pool;
+    };
+
+    SharedNode list(const std::shared_ptr<RowSource> &source, const float height) {
+        auto node = std::make_shared<Node>();
+        node->GetStyle().Modify<Dimensions>().Width = 200.0f;
+        node->GetStyle().Modify<Dimensions>().Height = height;
+        node->SetVirtualSource(source);
+        return node;
+    }
+}
+
+// Only the visible rows plus the overscan become nodes, however long the list is; scrolling
+// rebinds recycled nodes instead of creating new ones.
+TEST(VirtualListTests, materializes_only_the_visible_window) {
+    auto source = std::make_shared<RowSource>(100000, 20.0f, 20.0f);
+    auto root = list(source, 200.0f);
+
+    root->Calculate(200.0f, 200.0f);
+    ASSERT_EQ(0u, root->VirtualFirstIndex());
+    ASSERT_EQ(12u, root->Children().size()); // 10 visible + 2 below
+    ASSERT_EQ(12u, source->Created);
+    ASSERT_FLOAT_EQ(220.0f, root->Children()[11]->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(2000000.0f, root->VirtualExtent());
+
+    root->SetScrollOffset(0.0f, 1000000.0f);
+    root->Calculate(200.0f, 200.0f);
+    ASSERT_EQ(49998u, root->VirtualFirstIndex());
+    ASSERT_EQ(14u, root->Children().size()); // 2 above + 10 visible + 2 below
+    ASSERT_FLOAT_EQ(1000000.0f, root->Children()[2]->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(1000200.0f, root->Children()[12]->GetLayout().ComputedY);
+    ASSERT_EQ(12u, source->Recycled);
+    ASSERT_EQ(14u, source->Created);
+
+    // A small scroll keeps the rows that stay in the window.
+    root->SetScrollOffset(0.0f, 1000040.0f);
+    root->Calculate(200.0f, 200.0f);
+    ASSERT_EQ(50000u, root->VirtualFirstIndex());
+    ASSERT_EQ(14u, root->Children().size());
+    ASSERT_EQ(14u, source->Created);
+    ASSERT_EQ(14u, source->Recycled);
+}
+
+// The size estimate converges on the measured rows, correcting the scroll extent and the
+// offsets of rows placed by estimate.
+TEST(VirtualListTests, measured_rows_correct_the_estimate) {
+    auto source = std::make_shared<RowSource>(1000, 25.0f, 10.0f);
+    auto root = list(source, 100.0f);
+
+    root->Calculate(200.0f, 100.0f);
+    ASSERT_EQ(6u, root->Children().size()); // rows at 0, 25, 50, 75 + 2 below
+    ASSERT_FLOAT_EQ(25000.0f, root->VirtualExtent());
+
+    root->SetScrollOffset(0.0f, 500.0f);
+    root->Calculate(200.0f, 100.0f);
+    ASSERT_EQ(18u, root->VirtualFirstIndex());
+    ASSERT_FLOAT_EQ(500.0f, root->Children()[2]->GetLayout().ComputedY);
+    ASSERT_FLOAT_EQ(25000.0f, root->VirtualExtent());
+}
+
+// An AUTO-height list is as tall as its extent, so it takes its full space in the flow.
+TEST(VirtualListTests, auto_height_list_takes_its_extent) {
+    auto source = std::make_shared<RowSource>(50, 20.0f, 20.0f);
+    auto root = std::make_shared<Node>();
+    root->GetStyle().Modify<Dimensions>().Width = 200.0f;
+
+    auto rows = std::make_shared<Node>();
+    rows->SetVirtualSource(source);
+    root->AddChild(rows);
+
+    auto footer = std::make_shared<Node>();
+    footer->GetStyle().Modify<Dimensions>().Height = 10.0f;
+    root->AddChild(footer);
+
+    root->Calculate(200.0f, 100.0f);
+    ASSERT_EQ(7u, rows->Children().size());
+    ASSERT_FLOAT_EQ(1000.0f, rows->GetLayout().ComputedHeight);
+    ASSERT_FLOAT_EQ(1000.0f, footer->GetLayout().ComputedY);
+}